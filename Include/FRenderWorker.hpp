@@ -12,27 +12,88 @@
 /// SOFTWARE.
 ///
 
+#include <optional>
+#include <utility>
 #include <vector>
 #include <XCommon.hpp>
-#include <Math/Type/Micellanous/DDynamicGrid2D.h>
+#include <Object/XFunctionResults.hpp>
+#include <KDTree/XTraversalStats.hpp>
 
 namespace ray
 {
 
 class FCamera;
+class DFrameBuffer;
+class DAuxBuffers;
 
 /// @class FRenderWorker
 /// @brief Rendering worker. 
 class FRenderWorker final
 {
 public:
+  /// @brief Constructor type of FRenderWorker.
+  struct PCtor final
+  {
+    /// @brief Collect secondary rays of each tile, bin them by direction octant and origin cell,
+    /// and trace each bin together.
+    bool mIsBinningSecondaryRays = false;
+    /// @brief Trace primary rays with SIMD ray packet of given width. 
+    /// Supported value is 4 and 8. If 0, primary rays are traced one by one.
+    TIndex mPacketWidth = 0;
+    /// @brief The first sample index of each pixel to render.
+    /// Sample index is `repeat * GetSampleOffsetCount() + offset` of camera.
+    TIndex mSampleStart = 0;
+    /// @brief The count of samples of each pixel to render from `mSampleStart`. If 0, all remained samples are rendered.
+    /// Range can exceed samples of camera (progressive rendering), then sub-pixel offsets are repeated.
+    TIndex mSampleCount = 0;
+    /// @brief Trace primary ray of each sub-pixel offset once, and reuse its first hit for all repeats.
+    /// Only used when camera does not use depth of field, because primary rays are the same on every repeat.
+    bool mIsCachingFirstHits = true;
+  };
+
   FRenderWorker() = default;
+  FRenderWorker(const PCtor& ctor);
 
+  /// @brief Render given pixel list, and accumulate radiance sum and sample count into frame buffer.
+  /// Tone mapping and quantization are processed after rendering, as separated post stage.
+  /// @param pAuxBuffers If not null, first-hit features of samples are accumulated into it. 
+  /// It must have the same size and origin of frame buffer.
   void Execute(
     const FCamera& cam,
     const std::vector<DUVec2>& list, 
     const DUVec2 imgSize, 
-    DDynamicGrid2D<DIVec3>& container);
+    DFrameBuffer& frameBuffer,
+    DAuxBuffers* pAuxBuffers = nullptr);
+
+  /// @brief Get traversal statistics of the last `Execute` call.
+  const PTraversalStats& GetTraversalStats() const noexcept;
+
+private:
+  /// @brief Render given pixel list tile by tile. 
+  /// Primary rays of each tile are traced in packets, and secondary rays are traced in coherent bins if enabled.
+  /// First hits are resolved separately from bounces, so first-hit features are also collected here.
+  void ExecuteTiled(
+    const FCamera& cam,
+    const std::vector<DUVec2>& list, 
+    const DUVec2 imgSize, 
+    DFrameBuffer& frameBuffer,
+    DAuxBuffers* pAuxBuffers);
+
+  /// @brief Check first hits can be cached for given camera and sample count of each pixel.
+  bool IsCachingFirstHits(const FCamera& cam, TIndex sampleCount) const noexcept;
+  /// @brief Shade sample from resolved first hit, and trace bounces from it.
+  /// Random stream must be seeded with path stage of sample before calling this.
+  DVec3 TraceFromFirstHit(const DRay& ray, const std::optional<PTValueResult>& optHit) const;
+
+  /// @brief Get sample index range [start, end) of each pixel to render with given camera.
+  std::pair<TIndex, TIndex> GetSampleRangeOf(const FCamera& cam) const noexcept;
+
+  bool mIsBinningSecondaryRays = false;
+  TIndex mPacketWidth = 0;
+  TIndex mSampleStart = 0;
+  TIndex mSampleCount = 0;
+  bool mIsCachingFirstHits = true;
+  PTraversalStats mTraversalStats;
 };
 
 } /// ::ray namespace
\ No newline at end of file
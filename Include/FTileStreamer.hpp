@@ -0,0 +1,60 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <XCommon.hpp>
+#include <FRenderWorker.hpp>
+#include <KDTree/XTraversalStats.hpp>
+
+namespace ray
+{
+
+class FCamera;        // Forward declaration
+class FMappedImage;   // Forward declaration
+class DToneMapper;    // Forward declaration
+
+/// @class FTileStreamer
+/// @brief Render camera tile by tile with render workers, and write each completed tile into mapped image.
+/// Only frame buffers of tiles in flight (one per thread) are held in memory, 
+/// so image that is bigger than memory can be rendered.
+class FTileStreamer final
+{
+public:
+  /// @brief Constructor type of FTileStreamer.
+  struct PCtor final
+  {
+    /// @brief Constructor of render worker of each thread.
+    FRenderWorker::PCtor mWorker;
+    /// @brief Width and height of square tile in pixels.
+    TIndex mTileSize = 256;
+    /// @brief The count of threads that render tiles.
+    TIndex mThreadCount = 1;
+  };
+
+  FTileStreamer(const PCtor& ctor);
+
+  /// @brief Render all tiles of camera. Tiles are taken in image order by threads, 
+  /// so file is written from top to bottom roughly.
+  /// @param mapper Tone mapper of mapped image. (See `FMappedImage::WriteTile`)
+  void Execute(const FCamera& cam, FMappedImage& image, const DToneMapper& mapper);
+
+  /// @brief Get traversal statistics of all workers of the last `Execute` call.
+  const PTraversalStats& GetTraversalStats() const noexcept;
+
+private:
+  PCtor mCtor;
+  PTraversalStats mTraversalStats;
+};
+
+} /// ::ray namespace
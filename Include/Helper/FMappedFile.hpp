@@ -0,0 +1,59 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @class FMappedFile
+/// @brief Read-only file that is mapped into memory, so large file is read without copying into heap buffer.
+/// Pages are faulted in by operating system when they are touched, so different threads can read different parts.
+class FMappedFile final
+{
+public:
+  FMappedFile() = default;
+  FMappedFile(const FMappedFile&) = delete;
+  FMappedFile& operator=(const FMappedFile&) = delete;
+  ~FMappedFile();
+
+  /// @brief Open file of given path and map it as read-only.
+  /// @param isSequential If true, content is expected to be scanned from begin to end and read-ahead is requested.
+  /// @return If successful, return true. Otherwise, return false.
+  [[nodiscard]] bool Open(const char* const path, bool isSequential = true);
+
+  /// @brief Unmap and close file.
+  void Close();
+
+  /// @brief Check file is opened and mapped.
+  bool IsOpened() const noexcept { return this->mIsOpened; }
+  /// @brief Get mapped content of file. If file is empty, return nullptr.
+  const char* GetData() const noexcept { return this->mpData; }
+  /// @brief Get byte size of file.
+  TIndex GetSize() const noexcept { return this->mFileSize; }
+
+private:
+  bool        mIsOpened = false;
+  TIndex      mFileSize = 0;
+  const char* mpData    = nullptr;
+#if defined(_WIN32)
+  void* mFile     = nullptr;
+  void* mMapping  = nullptr;
+#else
+  int mFile = -1;
+#endif
+};
+
+} /// ::ray namespace
@@ -0,0 +1,50 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @class PArrayView
+/// @brief Read-only view of contiguous items. This does not own items.
+/// Items may be placed in heap list or in mapped file, so resource can expose both with the same type.
+template <typename TType>
+class PArrayView final
+{
+public:
+  PArrayView() = default;
+  PArrayView(const TType* pData, TIndex count) noexcept : mpData { pData }, mCount { count } {}
+  PArrayView(const std::vector<TType>& list) noexcept : mpData { list.data() }, mCount { list.size() } {}
+
+  const TType* begin() const noexcept { return this->mpData; }
+  const TType* end() const noexcept { return this->mpData + this->mCount; }
+  const TType* data() const noexcept { return this->mpData; }
+  TIndex size() const noexcept { return this->mCount; }
+  bool empty() const noexcept { return this->mCount == 0; }
+
+  const TType& operator[](TIndex index) const noexcept
+  {
+    assert(index < this->mCount);
+    return this->mpData[index];
+  }
+
+private:
+  const TType* mpData = nullptr;
+  TIndex mCount = 0;
+};
+
+} /// ::ray namespace
@@ -0,0 +1,116 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <optional>
+#include <vector>
+#include <XCommon.hpp>
+#include <Image/DFrameBuffer.hpp>
+
+namespace ray
+{
+
+struct PToneMapParams;      // Forward declaration
+
+/// @enum EPpmFormat
+/// @brief Raster format of ppm image.
+enum class EPpmFormat
+{
+  /// @brief Binary raster (P6). Raster is written with one bulk write.
+  Binary,
+  /// @brief Ascii raster (P3). Bigger and slower, but human readable.
+  Ascii,
+};
+
+/// @brief Create ppm image with 8-bit RGB values.
+/// @param rgb Interleaved 8-bit RGB values, left to right and top to bottom.
+/// @param format Raster format of image.
+/// @return If successful, return true. Otherwise, return false.
+bool CreateImagePpm(
+  const char* const path, 
+  TIndex width, TIndex height, const std::vector<TU8>& rgb, 
+  EPpmFormat format = EPpmFormat::Binary);
+
+/// @struct PPngOptions
+/// @brief Encoding options of png image.
+struct PPngOptions final
+{
+  /// @brief Deflate compression level, from 0 (stored) to 9 (the smallest and slowest).
+  TI32 mCompressionLevel = 6;
+  /// @brief The count of threads that filter and compress strips. If 0, `GetParallelThreadCount()` is used.
+  TIndex mThreadCount = 0;
+  /// @brief The count of rows of each strip. If 0, strip has about 1 MiB of rows.
+  TIndex mStripRowCount = 0;
+  /// @brief Bit depth of each channel. 8 or 16.
+  TU32 mBitDepth = 8;
+};
+
+/// @brief Create 8-bit or 16-bit RGB png image from frame buffer.
+/// Image is split into strips of rows. Each strip is tone-mapped, filtered and compressed in parallel,
+/// and written as its own IDAT chunk in order, so whole quantized image is never held in memory.
+/// @return If successful, return true. Otherwise, return false.
+bool CreateImagePng(
+  const char* const path, 
+  const DFrameBuffer& buffer, const PToneMapParams& toneMapParams, 
+  const PPngOptions& options);
+
+/// @brief Create little-endian float pfm image with averaged radiance of frame buffer.
+/// Radiance is not tone-mapped, so the result can be processed or merged afterward.
+/// @return If successful, return true. Otherwise, return false.
+bool CreateImagePfm(const char* const path, const DFrameBuffer& buffer);
+
+/// @struct PAccumulationImage
+/// @brief Frame buffer that is loaded from accumulation file, and the size of whole image that it is placed in.
+struct PAccumulationImage final
+{
+  DFrameBuffer mBuffer;
+  DUVec2 mImageSize;
+  /// @brief Sample index range [start, end) of each pixel that is accumulated in buffer.
+  TU32 mSampleStart = 0;
+  TU32 mSampleEnd = 0;
+};
+
+/// @brief Create accumulation file (.acc) that keeps radiance sums and sample counts of frame buffer as they are.
+/// Origin of buffer, size of whole image and sample index range are recorded, 
+/// so cropped regions or passes of disjoint samples can be merged into final image later.
+/// @return If successful, return true. Otherwise, return false.
+bool CreateImageAcc(
+  const char* const path, 
+  const DFrameBuffer& buffer, const DUVec2& imageSize, TU32 sampleStart, TU32 sampleEnd);
+
+/// @brief Load accumulation file that is created by `CreateImageAcc`.
+/// @return If failed to read file, or file is not valid, return null.
+std::optional<PAccumulationImage> LoadImageAcc(const char* const path);
+
+/// @struct PRenderCheckpoint
+/// @brief Accumulated frame buffer of progressive rendering, and the sample index to resume from.
+/// Random values of each sample are seeded by the sample itself, so sample index is the whole random state.
+/// The first sample index of rendering is the start of sample range of image.
+struct PRenderCheckpoint final
+{
+  PAccumulationImage mImage;
+  TU32 mNextSample = 0;
+};
+
+/// @brief Create checkpoint file of progressive rendering, that has samples [sampleStart, nextSample). 
+/// File is written into temporary file first and renamed, so previous checkpoint is kept if killed while writing.
+/// @return If successful, return true. Otherwise, return false.
+bool CreateCheckpoint(
+  const char* const path, 
+  const DFrameBuffer& buffer, const DUVec2& imageSize, TU32 sampleStart, TU32 nextSample);
+
+/// @brief Load checkpoint file that is created by `CreateCheckpoint`.
+/// @return If failed to read file, or file is not valid, return null.
+std::optional<PRenderCheckpoint> LoadCheckpoint(const char* const path);
+
+} /// ::ray namespace
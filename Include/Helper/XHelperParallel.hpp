@@ -0,0 +1,92 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// Parallel loops of model loading can be nested, such as models loaded concurrently and each model
+/// parsed and optimized in parallel. Each loop gives its threads a share of thread budget of calling thread,
+/// so nested loops do not spawn threads as square of core count, and run serially when budget is spent.
+
+/// @brief Get the count of threads that parallel loop started from current thread can use.
+/// It is hardware concurrency, or share of thread budget when current thread is running in `ForEachThread`.
+TIndex GetParallelThreadCount() noexcept;
+
+/// @class FParallelScope
+/// @brief Set thread budget of current thread while alive, and restore previous budget when destroyed.
+class FParallelScope final
+{
+public:
+  explicit FParallelScope(TIndex threadBudget) noexcept;
+  ~FParallelScope() noexcept;
+
+  FParallelScope(const FParallelScope&) = delete;
+  FParallelScope& operator=(const FParallelScope&) = delete;
+
+private:
+  TIndex mPreviousBudget = 0;
+};
+
+/// @brief Call given function with index of [0, count) on its own thread. Index 0 is called on calling thread.
+/// Thread budget of calling thread is split into each call, so parallel loops inside calls use only their share.
+/// @param count The count of threads. It should not be bigger than `GetParallelThreadCount()`.
+template <typename TFunc>
+void ForEachThread(TIndex count, TFunc&& threadFunc)
+{
+  // Single call keeps budget of calling thread, so loops inside it are still parallel.
+  if (count <= 1) 
+  { 
+    if (count == 1) { threadFunc(TIndex(0)); }
+    return;
+  }
+
+  const auto budget = GetParallelThreadCount();
+  const auto Process = [&threadFunc, budget, count](TIndex index)
+  {
+    FParallelScope scope { budget / count + (index < budget % count ? 1 : 0) };
+    threadFunc(index);
+  };
+
+  std::vector<std::thread> threads;
+  for (TIndex index = 1; index < count; ++index) { threads.emplace_back(Process, index); }
+  Process(0);
+  for (auto& thread : threads) { thread.join(); }
+}
+
+/// @brief Split range of [0, count) into one contiguous chunk per thread, and process chunks with `ForEachThread`.
+/// @param count The count of items, such as rows of image or vertices.
+/// @param threadCount The count of threads. If 0, `GetParallelThreadCount()` is used.
+/// @param minChunkSize Minimum item count of chunk. Small range is not split, because it is not worth to spawn threads.
+template <typename TFunc>
+void ForEachRange(TIndex count, TIndex threadCount, TIndex minChunkSize, TFunc&& rangeFunc)
+{
+  const auto chunkCount = std::clamp<TIndex>(
+    threadCount != 0 ? threadCount : GetParallelThreadCount(), 
+    1, 
+    std::max<TIndex>(count / std::max<TIndex>(minChunkSize, 1), 1));
+  const auto chunkSize = (count + chunkCount - 1) / chunkCount;
+  ForEachThread(chunkCount, [&rangeFunc, count, chunkSize](TIndex chunk)
+  {
+    const auto start = chunk * chunkSize;
+    if (start >= count) { return; }
+    rangeFunc(start, std::min(start + chunkSize, count));
+  });
+}
+
+} /// ::ray namespace
@@ -0,0 +1,55 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <cstdint>
+#include <XCommon.hpp>
+
+namespace ray::random
+{
+
+/// Random values of rendering are drawn from per-thread stream that is seeded by each sample,
+/// not by thread or call order. So the same sample produces the same path
+/// regardless of which thread renders it, or how pixels and samples are partitioned to threads.
+
+/// @brief Stage of sample that has its own seed. 
+/// Stages are seeded separately, so camera rays and paths can be created in different order.
+enum class ESampleStage : TU32
+{
+  /// @brief Creating camera ray. (Depth of field)
+  Camera = 0,
+  /// @brief Tracing path from camera ray. (Scattering)
+  Path = 1,
+};
+
+/// @brief Seed random stream of current thread with given sample.
+/// @param pixelKey Unique key of pixel in image.
+/// @param sampleIndex Index of sample of pixel. (See `FCamera::CreateSampleRay`)
+void SeedThreadStream(TU32 pixelKey, TU32 sampleIndex, ESampleStage stage) noexcept;
+
+/// @brief Get and set state of random stream of current thread, 
+/// so path that is suspended (such as binned secondary ray) can be resumed with the same values.
+std::uint64_t GetThreadStreamState() noexcept;
+void SetThreadStreamState(std::uint64_t state) noexcept;
+
+/// @brief Get uniform random real value in [min, max).
+TReal GetUniformReal(TReal min, TReal max) noexcept;
+
+/// @brief Get random vector of uniform direction that has given length.
+DVec3 GetVector3Length(TReal length) noexcept;
+
+/// @brief Get random 2D vector of uniform direction, that length is uniform in [min, max).
+DVec2 GetVector2Range(TReal min, TReal max) noexcept;
+
+} /// ::ray::random namespace
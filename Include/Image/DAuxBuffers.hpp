@@ -0,0 +1,56 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <XCommon.hpp>
+#include <Image/DFrameBuffer.hpp>
+
+namespace ray
+{
+
+/// @class DAuxBuffers
+/// @brief First-hit auxiliary features of each pixel (albedo, world normal and depth) that guide denoiser.
+/// Each feature is accumulated into its own frame buffer in the same layout of radiance buffer, 
+/// so features are averaged over samples and can be exported or merged like radiance.
+/// Depth is stored into all three channels of depth buffer.
+class DAuxBuffers final
+{
+public:
+  DAuxBuffers() = default;
+  DAuxBuffers(TIndex width, TIndex height, const DUVec2& origin);
+
+  /// @brief Accumulate feature sums of given sample count into pixel.
+  /// Different threads can accumulate into different pixels at the same time.
+  void AddSamples(
+    TIndex x, TIndex y, 
+    const DVec3& albedoSum, const DVec3& normalSum, TReal depthSum, TU32 sampleCount) noexcept;
+
+  /// @brief Accumulate all pixels of other buffers, such as other pass or thread.
+  /// @return If sizes or origins of buffers are not matched, return false and nothing is changed.
+  [[nodiscard]] bool Merge(const DAuxBuffers& other);
+
+  /// @brief Get accumulated albedo of first hit surface. Missed samples have background color.
+  const DFrameBuffer& GetAlbedo() const noexcept { return this->mAlbedo; }
+  /// @brief Get accumulated world-space normal of first hit surface. Missed samples have zero normal.
+  const DFrameBuffer& GetNormal() const noexcept { return this->mNormal; }
+  /// @brief Get accumulated distance from camera to first hit surface. Missed samples have zero depth.
+  const DFrameBuffer& GetDepth() const noexcept { return this->mDepth; }
+
+private:
+  DFrameBuffer mAlbedo;
+  DFrameBuffer mNormal;
+  DFrameBuffer mDepth;
+};
+
+} /// ::ray namespace
@@ -0,0 +1,76 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @class DFrameBuffer
+/// @brief High-dynamic-range accumulation buffer that holds radiance sum and sample count of each pixel.
+/// Pixels are stored in output image order (left to right, top to bottom), 
+/// so tone mapping and image writers do not need to flip rows and columns.
+class DFrameBuffer final
+{
+public:
+  DFrameBuffer() = default;
+  DFrameBuffer(TIndex width, TIndex height);
+  /// @brief Create buffer that covers only one tile of image.
+  /// @param origin Position of top-left pixel of tile in output image.
+  DFrameBuffer(TIndex width, TIndex height, const DUVec2& origin);
+
+  /// @brief Accumulate radiance sum of given sample count into pixel.
+  /// Different threads can accumulate into different pixels at the same time.
+  void AddSamples(TIndex x, TIndex y, const DVec3& radianceSum, TU32 sampleCount) noexcept;
+
+  /// @brief Get averaged radiance of pixel. If pixel has no sample, return black.
+  DVec3 GetAverage(TIndex x, TIndex y) const noexcept;
+  /// @brief Get accumulated sample count of pixel.
+  TU32 GetSampleCount(TIndex x, TIndex y) const noexcept;
+
+  /// @brief Get interleaved RGB radiance sums of given row, for kernels that process whole row at once.
+  const float* GetSumRow(TIndex y) const noexcept;
+  /// @brief Get sample counts of given row.
+  const TU32* GetSampleCountRow(TIndex y) const noexcept;
+
+  /// @brief Accumulate all pixels of other buffer into this buffer, such as other pass or process.
+  /// @return If sizes or origins of buffers are not matched, return false and nothing is changed.
+  [[nodiscard]] bool Merge(const DFrameBuffer& other);
+
+  /// @brief Accumulate all pixels of other buffer that covers region inside of this buffer, 
+  /// such as cropped region or tile of the same image. Origins of both buffers are in the same image.
+  /// @return If other buffer is not inside of this buffer, return false and nothing is changed.
+  [[nodiscard]] bool MergeRegion(const DFrameBuffer& other);
+
+  /// @brief Reset all sums and sample counts to zero.
+  void Clear() noexcept;
+
+  /// @brief Get the width of buffer.
+  TIndex GetWidth() const noexcept { return this->mWidth; }
+  /// @brief Get the height of buffer.
+  TIndex GetHeight() const noexcept { return this->mHeight; }
+  /// @brief Get position of top-left pixel of buffer in output image. If buffer covers whole image, (0, 0).
+  const DUVec2& GetOrigin() const noexcept { return this->mOrigin; }
+
+private:
+  TIndex mWidth   = 0;
+  TIndex mHeight  = 0;
+  DUVec2 mOrigin  = DUVec2{0, 0};
+  /// @brief Interleaved RGB radiance sum of each pixel.
+  std::vector<float> mSums;
+  std::vector<TU32>  mSampleCounts;
+};
+
+} /// ::ray namespace
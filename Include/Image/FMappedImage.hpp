@@ -0,0 +1,82 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+class DFrameBuffer;  // Forward declaration
+class DToneMapper;   // Forward declaration
+
+/// @enum EMappedImageFormat
+/// @brief Image format that has fixed-size header and uncompressed raster, so raster can be mapped.
+enum class EMappedImageFormat
+{
+  /// @brief Binary 8-bit RGB ppm (P6). Tiles are tone-mapped before written.
+  Ppm,
+  /// @brief Little-endian float pfm. Averaged radiance is written as it is.
+  Pfm,
+};
+
+/// @class FMappedImage
+/// @brief Image file that is mapped into memory, so rendered tiles are written into file incrementally.
+/// Written rows are handed to operating system and dropped from resident set of process,
+/// so resident memory is bounded by tiles in flight, not by image area.
+/// Completed tiles are kept in file even though process is terminated before closing.
+class FMappedImage final
+{
+public:
+  FMappedImage() = default;
+  FMappedImage(const FMappedImage&) = delete;
+  FMappedImage& operator=(const FMappedImage&) = delete;
+  ~FMappedImage();
+
+  /// @brief Create (or truncate) file with header and black raster, and map it.
+  /// @return If successful, return true. Otherwise, return false.
+  [[nodiscard]] bool Open(const char* const path, EMappedImageFormat format, TIndex width, TIndex height);
+
+  /// @brief Write tile frame buffer into its origin of image, and flush written rows.
+  /// Different threads can write different tiles at the same time.
+  /// @param mapper Tone mapper of ppm format. It is not used for pfm format.
+  void WriteTile(const DFrameBuffer& tile, const DToneMapper& mapper);
+
+  /// @brief Flush all rows and unmap file.
+  /// @return If file is flushed successfully, return true.
+  [[nodiscard]] bool Close();
+
+  /// @brief Check file is opened and mapped.
+  bool IsOpened() const noexcept { return this->mpData != nullptr; }
+
+private:
+  /// @brief Hand given rows of file to operating system, and drop them from resident set.
+  void FlushRows(TIndex fileRowStart, TIndex rowCount);
+
+  EMappedImageFormat mFormat = EMappedImageFormat::Ppm;
+  TIndex mWidth       = 0;
+  TIndex mHeight      = 0;
+  TIndex mRowSize     = 0;
+  TIndex mHeaderSize  = 0;
+  TIndex mFileSize    = 0;
+  TU8*   mpData       = nullptr;
+#if defined(_WIN32)
+  void* mFile     = nullptr;
+  void* mMapping  = nullptr;
+#else
+  int mFile = -1;
+#endif
+};
+
+} /// ::ray namespace
@@ -0,0 +1,44 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray::deflate
+{
+
+/// @brief Compress given data into non-final deflate blocks that end on byte boundary. (Sync flush)
+/// Data is compressed without referring to previous data, so each call can be processed in parallel,
+/// and outputs of consecutive calls can be concatenated into one deflate stream.
+/// @param level Compression level. 0 is stored (not compressed), and 9 is the slowest and smallest.
+/// @param oCompressed Compressed blocks are appended to it.
+void CompressBlocks(const TU8* pData, TIndex size, TI32 level, std::vector<TU8>& oCompressed);
+
+/// @brief Append the final empty block that terminates deflate stream.
+void AppendFinalBlock(std::vector<TU8>& oCompressed);
+
+/// @brief Get zlib stream header. (Deflate with 32K window)
+std::vector<TU8> GetZlibHeader();
+
+/// @brief Update Adler-32 checksum of zlib stream with given data.
+TU32 GetAdler32(const TU8* pData, TIndex size, TU32 adler = 1) noexcept;
+
+/// @brief Get Adler-32 checksum of concatenated data, from checksums of two parts.
+/// @param size2 The byte size of second part.
+TU32 CombineAdler32(TU32 adler1, TU32 adler2, TIndex size2) noexcept;
+
+/// @brief Update CRC-32 checksum of png chunk with given data.
+TU32 GetCrc32(const TU8* pData, TIndex size, TU32 crc = 0) noexcept;
+
+} /// ::ray::deflate namespace
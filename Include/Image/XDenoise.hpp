@@ -0,0 +1,49 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <XCommon.hpp>
+#include <Image/DFrameBuffer.hpp>
+
+namespace ray
+{
+
+class DAuxBuffers; // Forward declaration
+
+/// @struct PDenoiseParams
+/// @brief Parameters of edge-avoiding à-trous denoiser.
+struct PDenoiseParams final
+{
+  /// @brief The count of filter passes. Pass `i` samples 5x5 taps that are `2^i` pixels apart.
+  TIndex mIterationCount = 5;
+  /// @brief Edge-stopping sigma of illumination difference. It is halved on each pass, as noise is reduced.
+  float mColorSigma = 1.0f;
+  /// @brief Edge-stopping sigma of normal difference.
+  float mNormalSigma = 0.3f;
+  /// @brief Edge-stopping sigma of depth difference, relative to depth of center pixel.
+  float mDepthSigma = 0.05f;
+  /// @brief Edge-stopping sigma of albedo difference.
+  float mAlbedoSigma = 0.1f;
+  /// @brief The count of threads that filter row bands. If 0, `GetParallelThreadCount()` is used.
+  TIndex mThreadCount = 0;
+};
+
+/// @brief Denoise averaged radiance of frame buffer with edge-avoiding à-trous wavelet filter.
+/// Radiance is divided by albedo before filtering and multiplied back after it, so texture is not blurred,
+/// and taps that differ in normal, depth or albedo from center pixel are weighted down.
+/// @param auxBuffers First-hit features of the same size and origin of buffer.
+/// @return Frame buffer of filtered radiance. Sample counts of buffer are kept.
+DFrameBuffer Denoise(const DFrameBuffer& buffer, const DAuxBuffers& auxBuffers, const PDenoiseParams& params);
+
+} /// ::ray namespace
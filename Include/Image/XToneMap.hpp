@@ -0,0 +1,99 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+class DFrameBuffer; // Forward declaration
+
+/// @enum EToneMapOperator
+/// @brief Curve that compresses exposed radiance into [0, 1] before transfer function.
+enum class EToneMapOperator
+{
+  /// @brief Radiance is clamped into [0, 1].
+  Clamp,
+  /// @brief Reinhard operator, `x / (1 + x)`.
+  Reinhard,
+  /// @brief Hable's filmic curve (Uncharted 2) with white point 11.2.
+  Filmic,
+  /// @brief Narkowicz's fitted curve of ACES reference rendering transform.
+  ACES,
+};
+
+/// @enum ETransferFunction
+/// @brief Function that encodes linear display values.
+enum class ETransferFunction
+{
+  /// @brief Encode with `1 / gamma` power.
+  Gamma,
+  /// @brief Encode with sRGB piecewise curve. Gamma value is not used.
+  SRGB,
+};
+
+/// @struct PToneMapParams
+/// @brief Parameters of post stage that converts averaged radiance into display values.
+struct PToneMapParams final
+{
+  /// @brief Gamma correction value. Radiance is encoded with `1 / gamma`.
+  TReal mGamma = 2.2f;
+  /// @brief Exposure in stops. Radiance is scaled by `2^exposure` before operator.
+  TReal mExposure = 0.0f;
+  EToneMapOperator  mOperator = EToneMapOperator::Clamp;
+  ETransferFunction mTransfer = ETransferFunction::Gamma;
+  /// @brief If true, add per-pixel noise before quantization so gradients do not band.
+  /// Noise is hashed from pixel position, so the same image is produced regardless of thread count.
+  bool mIsDithering = false;
+};
+
+/// @class DToneMapper
+/// @brief Post stage that converts averaged radiance of frame buffer into 8-bit or 16-bit values.
+/// Exposure and operator are evaluated with SIMD kernel of selected level (See `XKernelTable.hpp`),
+/// and transfer function is evaluated with small table that is built once on construction.
+/// Mapper is immutable after construction, so one instance can map different rows from many threads.
+class DToneMapper final
+{
+public:
+  explicit DToneMapper(const PToneMapParams& params);
+
+  /// @brief Tone-map given rows of frame buffer, so image encoders can produce rows on demand.
+  /// @param rowStart The first row to convert.
+  /// @param rowCount The count of rows to convert.
+  /// @param oRgb Interleaved RGB values of rows. Must have `width * rowCount * 3` values.
+  void MapRows(const DFrameBuffer& buffer, TIndex rowStart, TIndex rowCount, TU8* oRgb) const;
+  void MapRows(const DFrameBuffer& buffer, TIndex rowStart, TIndex rowCount, TU16* oRgb) const;
+
+private:
+  template <typename TValue>
+  void MapRowsOf(const DFrameBuffer& buffer, TIndex rowStart, TIndex rowCount, TValue* oRgb) const;
+
+  /// @brief Get encoded display value of given fourth root of linear value.
+  float GetEncoded(float root) const noexcept;
+
+  PToneMapParams mParams;
+  /// @brief Transfer function sampled on fourth root of linear value.
+  /// Curve becomes smooth near black on this domain, so linear interpolation of few entries is enough for 16-bit.
+  std::vector<float> mTransferTable;
+};
+
+/// @brief Tone-map averaged radiance of frame buffer, and quantize it into 8-bit RGB.
+/// Rows are split into bands and mapped in parallel.
+/// Frame buffer is not changed, so it can be re-tonemapped with other parameters.
+/// @param threadCount The count of threads. If 0, `GetParallelThreadCount()` is used.
+/// @return Interleaved 8-bit RGB values in the same pixel order of frame buffer.
+std::vector<TU8> ToneMapToRgb8(const DFrameBuffer& buffer, const PToneMapParams& params, TIndex threadCount = 0);
+
+} /// ::ray namespace
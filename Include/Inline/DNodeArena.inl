@@ -0,0 +1,83 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <algorithm>
+
+namespace ray
+{
+
+template <typename TNode, typename TItem>
+template <typename TType>
+TType* DNodeArena<TNode, TItem>::DChunks<TType>::Allocate(TIndex count, TIndex chunkSize)
+{
+  if (count == 0) { return nullptr; }
+
+  // Elements are appended within reserved capacity, so chunk is never reallocated.
+  if (this->mChunks.empty() == true
+  ||  this->mChunks.back().capacity() - this->mChunks.back().size() < count)
+  {
+    this->mChunks.emplace_back();
+    this->mChunks.back().reserve(std::max(count, chunkSize));
+  }
+
+  auto& chunk = this->mChunks.back();
+  const auto offset = chunk.size();
+  chunk.resize(offset + count);
+  this->mCount += count;
+  return chunk.data() + offset;
+}
+
+template <typename TNode, typename TItem>
+void DNodeArena<TNode, TItem>::Reserve(TIndex nodeCount, TIndex itemCount)
+{
+  if (this->mNodes.mChunks.empty() == true && nodeCount > 0)
+  {
+    this->mNodes.mChunks.emplace_back();
+    this->mNodes.mChunks.back().reserve(nodeCount);
+  }
+  if (this->mItems.mChunks.empty() == true && itemCount > 0)
+  {
+    this->mItems.mChunks.emplace_back();
+    this->mItems.mChunks.back().reserve(itemCount);
+  }
+}
+
+template <typename TNode, typename TItem>
+TNode& DNodeArena<TNode, TItem>::CreateNode()
+{
+  return *this->mNodes.Allocate(1, kDefaultChunkSize);
+}
+
+template <typename TNode, typename TItem>
+TItem* DNodeArena<TNode, TItem>::CreateItems(TIndex count)
+{
+  return this->mItems.Allocate(count, kDefaultChunkSize);
+}
+
+template <typename TNode, typename TItem>
+void DNodeArena<TNode, TItem>::Clear() noexcept
+{
+  this->mNodes = {};
+  this->mItems = {};
+}
+
+template <typename TNode, typename TItem>
+const TNode& DNodeArena<TNode, TItem>::GetRoot() const noexcept
+{
+  assert(this->GetNodeCount() > 0);
+  return this->mNodes.mChunks.front().front();
+}
+
+} /// ::ray namespace
@@ -0,0 +1,307 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <KDTree/XTraversalStats.hpp>
+#include <Simd/XPacketKernel.hpp>
+
+namespace ray
+{
+
+template <typename TNode>
+void DWideTree<TNode>::BuildFrom(const TNode& root, TIndex width, TIndex quantizeBits)
+{
+  assert(width == 4 || width == 8);
+  assert(quantizeBits == 0 || quantizeBits == 8 || quantizeBits == 16);
+  this->mWidth = width;
+  this->mQuantizeBits = quantizeBits;
+  this->mNodes.clear();
+  this->mNodes8.clear();
+  this->mNodes16.clear();
+  this->mpLeaves.clear();
+  this->mStackCapacity = 1;
+
+  // Stack capacity is updated with depth of each created node.
+  if (root.IsLeaf() == false)
+  {
+    this->CollapseNode(root, 1);
+  }
+  else
+  {
+    this->CreateRootOfLeaf(root);
+  }
+  this->mNodeCount = this->mNodes.size();
+
+  switch (this->mQuantizeBits)
+  {
+  case 8:   this->Quantize(this->mNodes8); break;
+  case 16:  this->Quantize(this->mNodes16); break;
+  default: break;
+  }
+}
+
+template <typename TNode>
+void DWideTree<TNode>::CreateRootOfLeaf(const TNode& root)
+{
+  // If root is leaf, make one node that has only one leaf child.
+  DNode node;
+  node.mChildren[0] = this->CreateLeaf(root);
+  node.mChildCount = 1;
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    node.mMin[axis].fill(root.GetBoundingBox().GetMin()[axis]);
+    node.mMax[axis].fill(root.GetBoundingBox().GetMax()[axis]);
+  }
+  this->mNodes.emplace_back(node);
+  this->mStackCapacity = std::max<TIndex>(this->mStackCapacity, this->mWidth);
+}
+
+template <typename TNode>
+template <typename TValue>
+void DWideTree<TNode>::Quantize(std::vector<DQuantizedNode<TValue>>& oNodes)
+{
+  constexpr TU32 kMaxValue = std::numeric_limits<TValue>::max();
+
+  // Round minimum down and maximum up, so decoded bounds always contain original bounds.
+  // `margin` covers rounding difference of decoding, such as fused multiply-add.
+  const auto QuantizeDown = [](float value, float origin, float scale, float margin) -> TValue
+  {
+    if (scale <= 0.0f) { return 0; }
+    auto q = TU32(std::clamp(std::floor((value - origin) / scale), 0.0f, float(kMaxValue)));
+    while (q > 0 && origin + float(q) * scale > value - margin) { --q; }
+    return TValue(q);
+  };
+  const auto QuantizeUp = [](float value, float origin, float scale, float margin) -> TValue
+  {
+    if (scale <= 0.0f) { return 0; }
+    auto q = TU32(std::clamp(std::ceil((value - origin) / scale), 0.0f, float(kMaxValue)));
+    while (q < kMaxValue && origin + float(q) * scale < value + margin) { ++q; }
+    return TValue(q);
+  };
+
+  oNodes.resize(this->mNodes.size());
+  for (TIndex i = 0, size = this->mNodes.size(); i < size; ++i)
+  {
+    const auto& node = this->mNodes[i];
+    auto& quantized = oNodes[i];
+    quantized.mChildren = node.mChildren;
+    quantized.mChildCount = TU32(node.mChildCount);
+
+    for (TIndex axis = 0; axis < 3; ++axis)
+    {
+      float min = std::numeric_limits<float>::max();
+      float max = std::numeric_limits<float>::lowest();
+      for (TIndex c = 0; c < node.mChildCount; ++c)
+      {
+        min = std::min(min, node.mMin[axis][c]);
+        max = std::max(max, node.mMax[axis][c]);
+      }
+
+      const float margin = (std::abs(min) + std::abs(max)) * 1e-6f;
+      const float origin = min - 2 * margin;
+      const float scale  = (max - min + 4 * margin) / float(kMaxValue);
+      quantized.mOrigin[axis] = origin;
+      quantized.mScale[axis]  = scale;
+      quantized.mMin[axis].fill(0);
+      quantized.mMax[axis].fill(0);
+      for (TIndex c = 0; c < node.mChildCount; ++c)
+      {
+        quantized.mMin[axis][c] = QuantizeDown(node.mMin[axis][c], origin, scale, margin);
+        quantized.mMax[axis][c] = QuantizeUp(node.mMax[axis][c], origin, scale, margin);
+      }
+    }
+  }
+
+  this->mNodes.clear();
+  this->mNodes.shrink_to_fit();
+}
+
+template <typename TNode>
+template <typename TValue>
+void DWideTree<TNode>::Decode(const DQuantizedNode<TValue>& node, DNode& oNode) noexcept
+{
+  oNode.mChildren = node.mChildren;
+  oNode.mChildCount = node.mChildCount;
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    oNode.mMin[axis].fill(std::numeric_limits<float>::max());
+    oNode.mMax[axis].fill(std::numeric_limits<float>::lowest());
+    for (TIndex c = 0; c < node.mChildCount; ++c)
+    {
+      oNode.mMin[axis][c] = node.mOrigin[axis] + float(node.mMin[axis][c]) * node.mScale[axis];
+      oNode.mMax[axis][c] = node.mOrigin[axis] + float(node.mMax[axis][c]) * node.mScale[axis];
+    }
+  }
+}
+
+template <typename TNode>
+PWideTreeMemory DWideTree<TNode>::GetMemory() const noexcept
+{
+  PWideTreeMemory memory;
+  memory.mNodeCount = this->mNodeCount;
+  memory.mUncompressedByteSize = this->mNodeCount * sizeof(DNode);
+  switch (this->mQuantizeBits)
+  {
+  case 8:   memory.mByteSize = this->mNodeCount * sizeof(DQuantizedNode<TU8>); break;
+  case 16:  memory.mByteSize = this->mNodeCount * sizeof(DQuantizedNode<TU16>); break;
+  default:  memory.mByteSize = memory.mUncompressedByteSize; break;
+  }
+  return memory;
+}
+
+template <typename TNode>
+typename DWideTree<TNode>::TChild DWideTree<TNode>::CollapseNode(const TNode& node, TIndex depth)
+{
+  assert(node.IsLeaf() == false);
+  this->mStackCapacity = std::max<TIndex>(this->mStackCapacity, depth * (this->mWidth - 1) + 1);
+
+  // Gather children by opening interior child that has the largest surface area, until width is full.
+  std::vector<const TNode*> pChildren = { node.GetLeftNode(), node.GetRightNode() };
+  while (pChildren.size() < this->mWidth)
+  {
+    TIndex target = pChildren.size();
+    TReal largestArea = -1;
+    for (TIndex i = 0, size = pChildren.size(); i < size; ++i)
+    {
+      if (pChildren[i]->IsLeaf() == true) { continue; }
+
+      const auto length = pChildren[i]->GetBoundingBox().GetLength();
+      const auto area = length.X * length.Y + length.Y * length.Z + length.Z * length.X;
+      if (area > largestArea) { largestArea = area; target = i; }
+    }
+    if (target == pChildren.size()) { break; }
+
+    const auto* pTarget = pChildren[target];
+    pChildren[target] = pTarget->GetLeftNode();
+    pChildren.emplace_back(pTarget->GetRightNode());
+  }
+
+  // Reserve node first, so root is always placed at 0.
+  // Node reference must be retrieved after recursion because container may be reallocated.
+  const auto index = TChild(this->mNodes.size());
+  this->mNodes.emplace_back();
+
+  std::array<TChild, kMaxWidth> children;
+  for (TIndex i = 0, size = pChildren.size(); i < size; ++i)
+  {
+    children[i] = pChildren[i]->IsLeaf() == true
+      ? this->CreateLeaf(*pChildren[i])
+      : this->CollapseNode(*pChildren[i], depth + 1);
+  }
+
+  auto& wideNode = this->mNodes[index];
+  wideNode.mChildren = children;
+  wideNode.mChildCount = pChildren.size();
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    wideNode.mMin[axis].fill(std::numeric_limits<float>::max());
+    wideNode.mMax[axis].fill(std::numeric_limits<float>::lowest());
+    for (TIndex i = 0, size = pChildren.size(); i < size; ++i)
+    {
+      wideNode.mMin[axis][i] = pChildren[i]->GetBoundingBox().GetMin()[axis];
+      wideNode.mMax[axis][i] = pChildren[i]->GetBoundingBox().GetMax()[axis];
+    }
+  }
+  return index;
+}
+
+template <typename TNode>
+typename DWideTree<TNode>::TChild DWideTree<TNode>::CreateLeaf(const TNode& node)
+{
+  assert(node.IsLeaf() == true);
+  this->mpLeaves.emplace_back(&node);
+  return ~TChild(this->mpLeaves.size() - 1);
+}
+
+template <typename TNode>
+template <typename TFunc>
+void DWideTree<TNode>::Traverse(const DRay& ray, float& ioTMax, TFunc&& leafFunc) const
+{
+  static_assert(kMaxWidth == DRayPacket::kMaxWidth, "SIMD kernels assume the same maximum width.");
+  if (this->mNodeCount == 0) { return; }
+  auto& stats = GetThreadTraversalStats();
+
+  const auto& rayOrigin = ray.GetOrigin();
+  const auto& rayDirection = ray.GetDirection();
+  const float origin[3] = { rayOrigin.X, rayOrigin.Y, rayOrigin.Z };
+  const float invDirection[3] = { 1.0f / rayDirection.X, 1.0f / rayDirection.Y, 1.0f / rayDirection.Z };
+
+  struct DEntry final
+  {
+    TChild mChild;
+    float mTNear;
+  };
+  // Stack of usual tree fits in inline storage. Deep tree (e.g. built from skewed input) uses heap storage.
+  constexpr TIndex kInlineCapacity = 1024;
+  std::array<DEntry, kInlineCapacity> inlineStack;
+  std::vector<DEntry> heapStack;
+  DEntry* stack = inlineStack.data();
+  if (this->mStackCapacity > kInlineCapacity)
+  {
+    heapStack.resize(this->mStackCapacity);
+    stack = heapStack.data();
+  }
+  TIndex top = 0;
+  stack[top++] = {0, 0.0f};
+
+  while (top > 0)
+  {
+    const auto [child, tNear] = stack[--top];
+    if (tNear > ioTMax) { continue; }
+
+    if (child < 0)
+    {
+      leafFunc(*this->mpLeaves[~child], ioTMax);
+      continue;
+    }
+
+    // Compressed node is decoded into float node, so the same SIMD slab test can be used.
+    DNode decoded;
+    const DNode* pNode = nullptr;
+    switch (this->mQuantizeBits)
+    {
+    case 8:   Decode(this->mNodes8[child], decoded); pNode = &decoded; break;
+    case 16:  Decode(this->mNodes16[child], decoded); pNode = &decoded; break;
+    default:  pNode = &this->mNodes[child]; break;
+    }
+    const auto& node = *pNode;
+    stats.mNodeVisitCount += 1;
+
+    alignas(32) float childTNear[kMaxWidth];
+    const auto validMask = (1u << node.mChildCount) - 1;
+    const auto hitMask = simd::IntersectRayBoxes(
+      origin, invDirection, node.mMin, node.mMax,
+      this->mWidth, ioTMax, childTNear) & validMask;
+    if (hitMask == 0) { continue; }
+
+    // Sort hit children far to near, so nearest child is popped first.
+    std::array<DEntry, kMaxWidth> hits;
+    TIndex hitCount = 0;
+    for (TIndex lane = 0; lane < node.mChildCount; ++lane)
+    {
+      if ((hitMask & (1u << lane)) == 0) { continue; }
+
+      TIndex i = hitCount++;
+      for (; i > 0 && hits[i - 1].mTNear < childTNear[lane]; --i) { hits[i] = hits[i - 1]; }
+      hits[i] = {node.mChildren[lane], childTNear[lane]};
+    }
+
+    assert(top + hitCount <= this->mStackCapacity);
+    for (TIndex i = 0; i < hitCount; ++i) { stack[top++] = hits[i]; }
+  }
+}
+
+} /// ::ray namespace
\ No newline at end of file
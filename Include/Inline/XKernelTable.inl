@@ -0,0 +1,305 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+/// Kernel implementations that are compiled once per instruction set level.
+/// This file must be included only by ISA-specific translation units (`Source/Simd/XKernel*.cc`),
+/// and should not call inline functions of types that are not in `SH_RAY_SIMD_ISA_NAMESPACE`.
+
+#include <Simd/XKernelTable.hpp>
+#include <Simd/DSimdFloat.hpp>
+
+namespace
+{
+
+using namespace ray;
+using namespace ray::simd;
+
+/// @brief Epsilon value for checking ray is parallel to triangle.
+constexpr float kParallelEpsilon = 1e-5f;
+
+template <TIndex TWidth>
+TU32 IntersectAABB(const PPacketLanes& packet, const float* min, const float* max, TU32 activeMask, const float* tMax)
+{
+  using TFloat = DSimdFloat<TWidth>;
+
+  TFloat tNear = TFloat{0.0f};
+  TFloat tFar  = TFloat::Load(tMax);
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    const auto origin = TFloat::Load(packet.mOrigin[axis]);
+    const auto invDir = TFloat::Load(packet.mInvDirection[axis]);
+    const auto t0 = (TFloat{min[axis]} - origin) * invDir;
+    const auto t1 = (TFloat{max[axis]} - origin) * invDir;
+
+    // Put t value into second operand, so NaN (0 * inf) lane keeps previous near and far.
+    tNear = TFloat::Max(TFloat::Min(t0, t1), tNear);
+    tFar  = TFloat::Min(TFloat::Max(t0, t1), tFar);
+  }
+
+  return (tNear <= tFar).GetMask() & activeMask;
+}
+
+template <TIndex TWidth>
+TU32 IntersectBoxes(
+  const float* origin, const float* invDirection,
+  const float* const* min, const float* const* max,
+  float tMax, float* oTNear)
+{
+  using TFloat = DSimdFloat<TWidth>;
+
+  TFloat tNear = TFloat{0.0f};
+  TFloat tFar  = TFloat{tMax};
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    const auto o = TFloat{origin[axis]};
+    const auto invDir = TFloat{invDirection[axis]};
+    const auto t0 = (TFloat::Load(min[axis]) - o) * invDir;
+    const auto t1 = (TFloat::Load(max[axis]) - o) * invDir;
+
+    tNear = TFloat::Max(TFloat::Min(t0, t1), tNear);
+    tFar  = TFloat::Min(TFloat::Max(t0, t1), tFar);
+  }
+
+  tNear.Store(oTNear);
+  return (tNear <= tFar).GetMask();
+}
+
+/// @brief Möller–Trumbore intersection of lanes. `e1`, `e2` are edges of triangle, and `s` is `origin - v0`.
+/// @return Lane mask of valid hit, and T of each lane.
+template <typename TFloat>
+TFloat IntersectLanes(const TFloat (&d)[3], const TFloat (&e1)[3], const TFloat (&e2)[3], const TFloat (&s)[3], TFloat& oValid)
+{
+  // h = Cross(d, edge2), a = Dot(edge1, h)
+  const TFloat h[3] =
+  {
+    d[1] * e2[2] - d[2] * e2[1],
+    d[2] * e2[0] - d[0] * e2[2],
+    d[0] * e2[1] - d[1] * e2[0]
+  };
+  const TFloat a = e1[0] * h[0] + e1[1] * h[1] + e1[2] * h[2];
+
+  // If ray is parallel (or triangle is degenerated), lane will be discarded.
+  auto valid = (a > TFloat{kParallelEpsilon}) | (a < TFloat{-kParallelEpsilon});
+
+  const TFloat f = TFloat{1.0f} / a;
+  const TFloat u = f * (s[0] * h[0] + s[1] * h[1] + s[2] * h[2]);
+  valid = valid & (u >= TFloat{0.0f}) & (u <= TFloat{1.0f});
+
+  // q = Cross(s, edge1)
+  const TFloat q[3] =
+  {
+    s[1] * e1[2] - s[2] * e1[1],
+    s[2] * e1[0] - s[0] * e1[2],
+    s[0] * e1[1] - s[1] * e1[0]
+  };
+  const TFloat v = f * (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]);
+  oValid = valid & (v >= TFloat{0.0f}) & (u + v <= TFloat{1.0f});
+
+  // We can find `t` to find out where the intersection point is on the line.
+  return f * (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]);
+}
+
+template <TIndex TWidth>
+TU32 IntersectTriangle(
+  const PPacketLanes& packet,
+  const float* v0, const float* edge1, const float* edge2,
+  TU32 activeMask, float* ioT)
+{
+  using TFloat = DSimdFloat<TWidth>;
+
+  const TFloat e1[3] = { TFloat{edge1[0]}, TFloat{edge1[1]}, TFloat{edge1[2]} };
+  const TFloat e2[3] = { TFloat{edge2[0]}, TFloat{edge2[1]}, TFloat{edge2[2]} };
+  TFloat d[3], s[3];
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    d[axis] = TFloat::Load(packet.mDirection[axis]);
+    s[axis] = TFloat::Load(packet.mOrigin[axis]) - TFloat{v0[axis]};
+  }
+
+  TFloat valid;
+  const TFloat t = IntersectLanes(d, e1, e2, s, valid);
+  const TFloat prevT = TFloat::Load(ioT);
+  valid = valid & (t > TFloat{0.0f}) & (t < prevT);
+
+  const TU32 hitMask = valid.GetMask() & activeMask;
+  if (hitMask != 0) { TFloat::Select(TFloat::FromMask(hitMask), t, prevT).Store(ioT); }
+  return hitMask;
+}
+
+template <TIndex TWidth>
+TU32 IntersectTriangles(
+  const float* origin, const float* direction,
+  const PTriangleLanes& triangles, TIndex offset, float tMax, float* oT)
+{
+  using TFloat = DSimdFloat<TWidth>;
+
+  TFloat e1[3], e2[3], s[3];
+  const TFloat d[3] = { TFloat{direction[0]}, TFloat{direction[1]}, TFloat{direction[2]} };
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    e1[axis] = TFloat::Load(triangles.mEdge1[axis] + offset);
+    e2[axis] = TFloat::Load(triangles.mEdge2[axis] + offset);
+    s[axis]  = TFloat{origin[axis]} - TFloat::Load(triangles.mV0[axis] + offset);
+  }
+
+  // Unused lanes have zero edges, so they are discarded as parallel.
+  TFloat valid;
+  const TFloat t = IntersectLanes(d, e1, e2, s, valid);
+  valid = valid & (t > TFloat{0.0f}) & (t < TFloat{tMax});
+
+  t.Store(oT + offset);
+  return valid.GetMask() << offset;
+}
+
+TU32 IntersectPacketAABBOf(const PPacketLanes& packet, const float* min, const float* max, TU32 activeMask, const float* tMax)
+{
+  switch (packet.mWidth)
+  {
+  case 4: return IntersectAABB<4>(packet, min, max, activeMask, tMax);
+  case 8: return IntersectAABB<8>(packet, min, max, activeMask, tMax);
+  default: assert(false); return 0;
+  }
+}
+
+TU32 IntersectPacketTriangleOf(
+  const PPacketLanes& packet,
+  const float* v0, const float* edge1, const float* edge2,
+  TU32 activeMask, float* ioT)
+{
+  switch (packet.mWidth)
+  {
+  case 4: return IntersectTriangle<4>(packet, v0, edge1, edge2, activeMask, ioT);
+  case 8: return IntersectTriangle<8>(packet, v0, edge1, edge2, activeMask, ioT);
+  default: assert(false); return 0;
+  }
+}
+
+TU32 IntersectRayBoxesOf(
+  const float* origin, const float* invDirection,
+  const float* const* min, const float* const* max,
+  TIndex width, float tMax, float* oTNear)
+{
+  switch (width)
+  {
+  case 4: return IntersectBoxes<4>(origin, invDirection, min, max, tMax, oTNear);
+  case 8: return IntersectBoxes<8>(origin, invDirection, min, max, tMax, oTNear);
+  default: assert(false); return 0;
+  }
+}
+
+TU32 IntersectRayTrianglesOf(
+  const float* origin, const float* direction,
+  const PTriangleLanes& triangles, float tMax, float* oT)
+{
+  const TU32 validMask = (1u << triangles.mCount) - 1;
+  if constexpr (IsAccelerated<8>() == true)
+  {
+    return IntersectTriangles<8>(origin, direction, triangles, 0, tMax, oT) & validMask;
+  }
+  else
+  {
+    // Second half is skipped when block is not full, such as the last block of leaf.
+    TU32 hitMask = IntersectTriangles<4>(origin, direction, triangles, 0, tMax, oT);
+    if (triangles.mCount > 4) { hitMask |= IntersectTriangles<4>(origin, direction, triangles, 4, tMax, oT); }
+    return hitMask & validMask;
+  }
+}
+
+/// @brief Hable's filmic curve that is not normalized by white point.
+template <typename TFloat>
+TFloat GetHableCurve(const TFloat& x)
+{
+  const TFloat a{0.15f}, b{0.50f}, c{0.10f}, d{0.20f}, e{0.02f}, f{0.30f};
+  return (x * (a * x + c * b) + d * e) / (x * (a * x + b) + d * f) - e / f;
+}
+
+template <typename TFloat>
+TFloat ToneMapLanes(const TFloat& sum, const TFloat& scale, EToneMapOperator toneOperator, float whiteScale)
+{
+  const TFloat zero{0.0f}, one{1.0f};
+
+  // Put zero into second operand, so NaN lane becomes black.
+  auto x = TFloat::Max(sum * scale, zero);
+  switch (toneOperator)
+  {
+  case EToneMapOperator::Reinhard: x = x / (one + x); break;
+  case EToneMapOperator::Filmic:   x = GetHableCurve(x) * TFloat{whiteScale}; break;
+  case EToneMapOperator::ACES:
+    x = (x * (TFloat{2.51f} * x + TFloat{0.03f})) / (x * (TFloat{2.43f} * x + TFloat{0.59f}) + TFloat{0.14f});
+    break;
+  default: break;
+  }
+
+  // Lane that overflowed in operator (inf / inf) becomes white.
+  x = TFloat::Max(TFloat::Min(x, one), zero);
+  return TFloat::Sqrt(TFloat::Sqrt(x));
+}
+
+template <TIndex TWidth>
+void ToneMapValues(
+  const float* pSums, const float* pScales, TIndex count, 
+  EToneMapOperator toneOperator, float whiteScale, float* oRoots)
+{
+  using TFloat = DSimdFloat<TWidth>;
+
+  TIndex i = 0;
+  for (; i + TWidth <= count; i += TWidth)
+  {
+    const auto sum = TFloat::LoadUnaligned(pSums + i);
+    const auto scale = TFloat::LoadUnaligned(pScales + i);
+    ToneMapLanes(sum, scale, toneOperator, whiteScale).StoreUnaligned(oRoots + i);
+  }
+  if (i == count) { return; }
+
+  // Remained values are processed with zero-padded lanes.
+  alignas(32) float sums[TWidth] = {};
+  alignas(32) float scales[TWidth] = {};
+  alignas(32) float roots[TWidth];
+  std::memcpy(sums, pSums + i, sizeof(float) * (count - i));
+  std::memcpy(scales, pScales + i, sizeof(float) * (count - i));
+  ToneMapLanes(TFloat::Load(sums), TFloat::Load(scales), toneOperator, whiteScale).Store(roots);
+  std::memcpy(oRoots + i, roots, sizeof(float) * (count - i));
+}
+
+void ToneMapValuesOf(
+  const float* pSums, const float* pScales, TIndex count, 
+  EToneMapOperator toneOperator, float* oRoots)
+{
+  const float whiteScale = 1.0f / GetHableCurve(11.2f);
+  if constexpr (IsAccelerated<8>() == true)
+  {
+    ToneMapValues<8>(pSums, pScales, count, toneOperator, whiteScale, oRoots);
+  }
+  else
+  {
+    ToneMapValues<4>(pSums, pScales, count, toneOperator, whiteScale, oRoots);
+  }
+}
+
+/// @brief Create kernel table with kernels of this translation unit.
+PKernelTable CreateKernelTable(ESimdLevel level)
+{
+  PKernelTable table{};
+  table.mLevel = level;
+  table.mIsAccelerated4 = IsAccelerated<4>();
+  table.mIsAccelerated8 = IsAccelerated<8>();
+  table.mIntersectPacketAABB = &IntersectPacketAABBOf;
+  table.mIntersectPacketTriangle = &IntersectPacketTriangleOf;
+  table.mIntersectRayBoxes = &IntersectRayBoxesOf;
+  table.mIntersectRayTriangles = &IntersectRayTrianglesOf;
+  table.mToneMapValues = &ToneMapValuesOf;
+  return table;
+}
+
+} /// anonymous namespace
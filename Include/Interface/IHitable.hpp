@@ -21,6 +21,9 @@
 namespace ray
 {
 
+class DRayPacket;   // Forward declaration
+class DPacketHits;  // Forward declaration
+
 /// @class IHitable
 /// @brief Hitable object interface.
 class IHitable : public IObject
@@ -45,6 +48,13 @@ public:
   using TValueResults = std::vector<PTValueResult>;
   virtual std::optional<TValueResults> GetRayIntersectedTValues(const DRay& ray) const = 0;
 
+  /// @brief Update the closest results of active lanes of ray packet.
+  /// Default implementation tests each active lane with `GetRayIntersectedTValues`.
+  /// @param packet Ray packet of world-space.
+  /// @param activeMask Bit mask of lanes to test.
+  /// @param ioHits The closest results of packet.
+  virtual void GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const;
+
   /// @brief Diffuse scattering function.
   /// @param ray World space ray to intersect.
   /// @param t Forwarding value t for moving ray origin into surface approximately.
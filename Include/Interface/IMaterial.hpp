@@ -38,6 +38,9 @@ public:
   /// @return If intersected and could get diffuse scattered reflection (with dialectric), return result.
   virtual std::optional<PScatterResult> Scatter(const DRay& intersectedRay, const DVec3& normal) const = 0;
 
+  /// @brief Get base color of surface, that is used as albedo guide of denoiser.
+  virtual DVec3 GetAlbedo() const noexcept = 0;
+
   /// @brief Get ID instance.
   const DMatId& GetId() const noexcept;
 
@@ -0,0 +1,87 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @class PItemRange
+/// @brief Contiguous range of items that is allocated from `DNodeArena`. This does not own items.
+template <typename TItem>
+class PItemRange final
+{
+public:
+  const TItem* begin() const noexcept { return this->mpBegin; }
+  const TItem* end() const noexcept { return this->mpBegin + this->mCount; }
+  TIndex size() const noexcept { return this->mCount; }
+  bool empty() const noexcept { return this->mCount == 0; }
+
+  const TItem* mpBegin = nullptr;
+  TIndex mCount = 0;
+};
+
+/// @class DNodeArena
+/// @brief Arena that allocates nodes of tree and item ranges of leaves in large contiguous chunks.
+/// Allocated nodes and items are never moved until arena is cleared or destroyed, 
+/// so nodes can refer to children and items with raw pointers, and whole tree is released at once.
+/// The first created node is regarded as root of tree.
+/// @tparam TNode Tree node type. Must be default constructible.
+/// @tparam TItem Leaf item type. Must be default constructible.
+template <typename TNode, typename TItem>
+class DNodeArena final
+{
+public:
+  /// @brief Reserve the first chunk of nodes and items, so tree of given size is placed in one chunk.
+  void Reserve(TIndex nodeCount, TIndex itemCount);
+
+  /// @brief Create new node.
+  TNode& CreateNode();
+  /// @brief Create contiguous items of given count. Items are default constructed.
+  /// @return The pointer of the first item. If count is 0, return nullptr.
+  TItem* CreateItems(TIndex count);
+
+  /// @brief Release all nodes and items.
+  void Clear() noexcept;
+
+  /// @brief Check arena has root node.
+  bool HasRoot() const noexcept { return this->mNodes.mCount > 0; }
+  /// @brief Get root node. Arena must have at least one node.
+  const TNode& GetRoot() const noexcept;
+  /// @brief Get the count of created nodes.
+  TIndex GetNodeCount() const noexcept { return this->mNodes.mCount; }
+  /// @brief Get the count of created items.
+  TIndex GetItemCount() const noexcept { return this->mItems.mCount; }
+
+private:
+  static constexpr TIndex kDefaultChunkSize = 4096;
+
+  template <typename TType>
+  struct DChunks final
+  {
+    /// @brief Allocate contiguous elements. New chunk is created when the last chunk does not have enough room.
+    TType* Allocate(TIndex count, TIndex chunkSize);
+
+    std::vector<std::vector<TType>> mChunks;
+    TIndex mCount = 0;
+  };
+
+  DChunks<TNode> mNodes;
+  DChunks<TItem> mItems;
+};
+
+} /// ::ray namespace
+#include <Inline/DNodeArena.inl>
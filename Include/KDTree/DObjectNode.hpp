@@ -12,33 +12,63 @@
 /// SOFTWARE.
 ///
 
-#include <memory>
 #include <XCommon.hpp>
 #include <Object/XFunctionResults.hpp>
 #include <Interface/IHitable.hpp>
+#include <KDTree/DNodeArena.hpp>
 
 namespace ray
 {
 
+class DRayPacket;   // Forward declaration
+class DPacketHits;  // Forward declaration
+
 /// @class DObjectNode
 /// @brief Object KDTree node for optimization
 class DObjectNode final
 {
 public:
+  /// @brief Arena that has all nodes and leaf object pointers of one tree.
+  using TArena = DNodeArena<DObjectNode, const IHitable*>;
+
   /// @brief Build KDTree with given pointer list of triangle from this node.
+  /// @param arena Arena that this node is created from. Children and leaf items are also created from it.
   /// @param pObjects All valid hitable object pointer list.
-  void BuildTree(const std::vector<const IHitable*>& pObjects);
+  void BuildTree(TArena& arena, const std::vector<const IHitable*>& pObjects);
 
   /// @brief Get T and normal if given ray that is in world-space can be intersected arbitary objects.
   /// @param ray The ray in world space.
   /// @return If intersected, return T, normal and object pointer.
   IHitable::TValueResults GetIntersectedTriangleTValue(const DRay& ray) const;
 
+  /// @brief Update the closest results of active lanes of given packet that is in world-space.
+  /// When packet is diverged, remained lanes are traversed with `GetIntersectedTriangleTValue`.
+  /// @param packet The ray packet in world space.
+  /// @param activeMask Bit mask of lanes to test.
+  /// @param ioHits The closest results of each lane.
+  void GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const;
+
+  /// @brief Check this node is leaf node.
+  bool IsLeaf() const noexcept { return this->mLeftNode == nullptr && this->mRightNode == nullptr; }
+  /// @brief Get left child node. If leaf node, return nullptr.
+  const DObjectNode* GetLeftNode() const noexcept { return this->mLeftNode; }
+  /// @brief Get right child node. If leaf node, return nullptr.
+  const DObjectNode* GetRightNode() const noexcept { return this->mRightNode; }
+  /// @brief Get overall bounding box of this node.
+  const DAABB& GetBoundingBox() const noexcept { return this->mOverallBoundingBox; }
+  /// @brief Get object pointer list of this node. Only leaf node has them.
+  const PItemRange<const IHitable*>& GetItems() const noexcept { return this->mpObjects; }
+
 private:
+  /// @brief Build node with given range of object pointer list, recursively.
+  /// The range is partitioned in place, so children use sub-ranges of it.
+  void BuildTree(TArena& arena, const IHitable** pObjects, TIndex count);
+
   DAABB mOverallBoundingBox;
-  std::unique_ptr<DObjectNode> mLeftNode;
-  std::unique_ptr<DObjectNode> mRightNode;
-  std::vector<const IHitable*> mpObjects;
+  const DObjectNode* mLeftNode  = nullptr;
+  const DObjectNode* mRightNode = nullptr;
+  /// @brief Object pointers that are allocated from arena. Only leaf node has them.
+  PItemRange<const IHitable*> mpObjects;
 
   DVec3 mAABBCenter = DVec3{};
   ::dy::math::EAxis mAxis; 
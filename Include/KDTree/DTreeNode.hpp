@@ -12,37 +12,105 @@
 /// SOFTWARE.
 ///
 
-#include <memory>
+#include <optional>
 #include <XCommon.hpp>
 #include <Object/XFunctionResults.hpp>
+#include <Helper/PArrayView.hpp>
+#include <KDTree/DNodeArena.hpp>
+#include <KDTree/DTriangleBlock.hpp>
 
 namespace ray
 {
 
-class DModelFace; // Forward declaration
+class DModelTriangle;       // Forward declaration
+class DRayPacket;           // Forward declaration
+class DTrianglePacketHits;  // Forward declaration
 
 /// @class DTreeNode
 /// @brief Model Triangle KDTree node for optimization
 class DTreeNode final
 {
 public:
-  /// @brief Build KDTree with given pointer list of triangle from this node.
-  /// @param pTriangles All valid triangle pointer list.
-  void BuildTree(const std::vector<const DModelFace*>& pTriangles);
+  /// @brief Arena that has all nodes and leaf triangle blocks of one tree.
+  using TArena = DNodeArena<DTreeNode, DTriangleBlock>;
+
+  /// @struct PFlatNode
+  /// @brief Node that is flattened in pre-order, so tree can be stored into file.
+  /// Children and triangle blocks are referred by index. Children are always placed after parent.
+  struct PFlatNode final
+  {
+    static constexpr TU32 kNone = 0xFFFFFFFF;
+    float mMin[3];
+    float mMax[3];
+    TU32 mLeft  = kNone;
+    TU32 mRight = kNone;
+    TU32 mBlockBegin = 0;
+    TU32 mBlockCount = 0;
+  };
+
+  /// @brief Build KDTree with all triangles of mesh from this node.
+  /// Bounds and centroids of triangles are computed only while building, and discarded after that.
+  /// @param arena Arena that this node is created from. Children and blocks are also created from it.
+  /// @param triangles All triangles of mesh.
+  /// @param vertices Vertex stream that triangles refer to.
+  void BuildTree(TArena& arena, PArrayView<DModelTriangle> triangles, PArrayView<DVec3> vertices);
+
+  /// @brief Flatten tree of this node in pre-order. Triangle blocks of leaves are gathered in the same order.
+  void Flatten(std::vector<PFlatNode>& oNodes, std::vector<DTriangleBlock>& oBlocks) const;
+  /// @brief Restore tree from flattened nodes into this node, without building it again.
+  /// Leaves refer to given blocks without copying them. Nodes are restored iteratively, not to overflow call stack.
+  /// @param arena Arena that this node is created from. Children are also created from it.
+  /// @param nodes Validated flattened nodes. The first node is root.
+  /// @param pBlocks Blocks that flattened nodes refer to. They must be alive while tree is used.
+  void Restore(TArena& arena, PArrayView<PFlatNode> nodes, const DTriangleBlock* pBlocks);
 
   /// @brief Get T with index if given ray that is in mesh's local space can be intersected arbitary triangle node.
   /// @param localRay The ray in local mesh space.
-  /// @return If intersected, return T and three index of mesh.
+  /// @return If intersected, return T and triangle index of mesh.
   std::vector<PTriangleResult> GetIntersectedTriangleTValue(const DRay& localRay) const;
 
+  /// @brief Get the closest triangle of this leaf node that given ray in mesh's local space hits.
+  /// Triangles are tested with precomputed triangle blocks, so this node must be leaf.
+  /// @param localRay The ray in local mesh space.
+  /// @param ioTMax The closest T of ray. If closer triangle is found, it is updated.
+  /// @return If found closer triangle, return its index. Otherwise, return nullopt.
+  std::optional<TU32> GetClosestLeafTriangle(const DRay& localRay, float& ioTMax) const;
+
+  /// @brief Update the closest triangle of active lanes of given packet that is in mesh's local space.
+  /// When packet is diverged, remained lanes are traversed with `GetIntersectedTriangleTValue`.
+  /// @param localPacket The ray packet in local mesh space.
+  /// @param activeMask Bit mask of lanes to test.
+  /// @param ioHits The closest T and triangle index of mesh of each lane.
+  void GetPacketClosestTriangles(const DRayPacket& localPacket, TU32 activeMask, DTrianglePacketHits& ioHits) const;
+
+  /// @brief Check this node is leaf node.
+  bool IsLeaf() const noexcept { return this->mLeftNode == nullptr && this->mRightNode == nullptr; }
+  /// @brief Get left child node. If leaf node, return nullptr.
+  const DTreeNode* GetLeftNode() const noexcept { return this->mLeftNode; }
+  /// @brief Get right child node. If leaf node, return nullptr.
+  const DTreeNode* GetRightNode() const noexcept { return this->mRightNode; }
+  /// @brief Get depth of tree from this node. Leaf node is 1. Nodes are visited iteratively.
+  TIndex GetDepth() const;
+  /// @brief Get overall bounding box of this node.
+  const DAABB& GetBoundingBox() const noexcept { return this->mOverallBoundingBox; }
+  /// @brief Get precomputed triangle blocks of this node. Only leaf node has them.
+  const PItemRange<DTriangleBlock>& GetItems() const noexcept { return this->mTriangleBlocks; }
+
 private:
+  struct PBuildContext;
+
+  /// @brief Build node with given range of triangle index list, recursively.
+  /// The range is partitioned in place, so children use sub-ranges of it.
+  void BuildTree(PBuildContext& context, TU32* pTriangleIds, TIndex count);
+
   DAABB mOverallBoundingBox;
-  std::unique_ptr<DTreeNode>      mLeftNode;
-  std::unique_ptr<DTreeNode>      mRightNode;
-  std::vector<const DModelFace*>  mTriangles;
+  const DTreeNode* mLeftNode  = nullptr;
+  const DTreeNode* mRightNode = nullptr;
+  /// @brief Precomputed triangle records that are allocated from arena. Only leaf node has them.
+  PItemRange<DTriangleBlock> mTriangleBlocks;
 
   DVec3 mBarycentric = DVec3{};
-  ::dy::math::EAxis mAxis; 
+  ::dy::math::EAxis mAxis = ::dy::math::EAxis::X; 
 };
 
 } /// ::ray namespace
@@ -0,0 +1,64 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <array>
+#include <vector>
+#include <XCommon.hpp>
+#include <Helper/PArrayView.hpp>
+
+namespace ray
+{
+
+class DModelTriangle; // Forward declaration
+
+/// @class DTriangleBlock
+/// @brief Leaf triangle records that have precomputed v0, edge1 and edge2 of up to 8 triangles in SoA layout.
+/// Triangles of block are intersected with one SIMD kernel, without gathering vertices from vertex stream.
+class DTriangleBlock final
+{
+public:
+  static constexpr TIndex kWidth = 8;
+
+  /// @brief Get the count of blocks that given count of triangles needs.
+  static TIndex GetBlockCount(TIndex triangleCount) noexcept { return (triangleCount + kWidth - 1) / kWidth; }
+
+  /// @brief Create blocks from given triangle index list into given storage.
+  /// Unused lanes of the last block have zero edges, so they are never intersected.
+  /// @param pTriangleIds Index list of triangles to put into blocks.
+  /// @param count The count of triangle index.
+  /// @param triangles All triangles of mesh.
+  /// @param vertices Vertex stream that triangles refer to.
+  /// @param oBlocks Storage that has `GetBlockCount(count)` blocks.
+  static void CreateBlocks(
+    const TU32* pTriangleIds, TIndex count,
+    PArrayView<DModelTriangle> triangles,
+    PArrayView<DVec3> vertices,
+    DTriangleBlock* oBlocks);
+
+  /// @brief Scalar reference kernel of `simd::IntersectRayTriangles`, with Möller–Trumbore algorithm per lane.
+  /// @param localRay The ray in local mesh space.
+  /// @param tMax Lanes that hit farther than or equal to it are discarded.
+  /// @param oT T value of each lane. Only hit lanes are valid.
+  /// @return Bit mask of lanes that hit triangle in range of (0, tMax).
+  TU32 IntersectReference(const DRay& localRay, float tMax, float* oT) const noexcept;
+
+  alignas(32) std::array<float, kWidth> mV0[3];
+  alignas(32) std::array<float, kWidth> mEdge1[3];
+  alignas(32) std::array<float, kWidth> mEdge2[3];
+  /// @brief Triangle index of mesh of each lane.
+  std::array<TU32, kWidth> mTriangle;
+  TIndex mCount = 0;
+};
+
+} /// ::ray namespace
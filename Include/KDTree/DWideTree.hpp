@@ -0,0 +1,130 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <array>
+#include <vector>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @struct PWideTreeMemory
+/// @brief Memory footprint of wide tree nodes, for comparing node formats.
+struct PWideTreeMemory final
+{
+  TIndex mNodeCount = 0;
+  /// @brief Byte size of nodes in current format.
+  TIndex mByteSize = 0;
+  /// @brief Byte size of nodes if they were stored in uncompressed float format.
+  TIndex mUncompressedByteSize = 0;
+
+  PWideTreeMemory& operator+=(const PWideTreeMemory& rhs) noexcept
+  {
+    this->mNodeCount += rhs.mNodeCount;
+    this->mByteSize += rhs.mByteSize;
+    this->mUncompressedByteSize += rhs.mUncompressedByteSize;
+    return *this;
+  }
+};
+
+/// @class DWideTree
+/// @brief Multi-wide (4-ary or 8-ary) tree that is collapsed from built binary tree.
+/// Child bounds of each node are stored in SoA layout, so all children of node are tested with one SIMD slab test.
+/// Leaves reference leaf nodes of binary tree, so binary tree must be alive while wide tree is used.
+/// Optionally, child bounds can be quantized into 8 or 16 bits relative to bounds of node.
+/// Quantized bounds are rounded outward, so decoded child bounds always contain original bounds and no hit is missed.
+/// @tparam TNode Binary tree node type. (DTreeNode or DObjectNode)
+template <typename TNode>
+class DWideTree final
+{
+public:
+  static constexpr TIndex kMaxWidth = 8;
+
+  /// @brief Build wide tree by collapsing given binary tree.
+  /// @param root Root node of built binary tree.
+  /// @param width Branch width of wide tree. Must be 4 or 8.
+  /// @param quantizeBits Bit count of quantized child bounds. 0 (uncompressed float), 8 or 16.
+  void BuildFrom(const TNode& root, TIndex width, TIndex quantizeBits = 0);
+
+  /// @brief Traverse tree with given ray, visiting hit children in near-to-far order.
+  /// @param ray The ray in the same space of tree.
+  /// @param ioTMax The closest T of ray. Children that are farther than it are culled.
+  /// @param leafFunc Callable with `(const TNode& leaf, float& ioTMax)` signature.
+  /// It should shrink `ioTMax` when closer item is found.
+  template <typename TFunc>
+  void Traverse(const DRay& ray, float& ioTMax, TFunc&& leafFunc) const;
+
+  /// @brief Get branch width of tree.
+  TIndex GetWidth() const noexcept { return this->mWidth; }
+  /// @brief Get the count of interior nodes.
+  TIndex GetNodeCount() const noexcept { return this->mNodeCount; }
+  /// @brief Get bit count of quantized child bounds. If 0, nodes are not compressed.
+  TIndex GetQuantizeBits() const noexcept { return this->mQuantizeBits; }
+  /// @brief Get memory footprint of nodes.
+  PWideTreeMemory GetMemory() const noexcept;
+
+private:
+  /// @brief Child value of node. If positive, it is index of node. If negative, it is bitwise-not of leaf index.
+  using TChild = TI32;
+
+  struct DNode final
+  {
+    alignas(32) std::array<float, kMaxWidth> mMin[3];
+    alignas(32) std::array<float, kMaxWidth> mMax[3];
+    std::array<TChild, kMaxWidth> mChildren;
+    TIndex mChildCount = 0;
+  };
+
+  /// @brief Compressed node. Child bounds are stored as `mOrigin + q * mScale` per axis.
+  template <typename TValue>
+  struct alignas(16) DQuantizedNode final
+  {
+    float mOrigin[3];
+    float mScale[3];
+    std::array<TValue, kMaxWidth> mMin[3];
+    std::array<TValue, kMaxWidth> mMax[3];
+    std::array<TChild, kMaxWidth> mChildren;
+    TU32 mChildCount = 0;
+  };
+
+  /// @brief Compress all float nodes into quantized nodes and release float nodes.
+  template <typename TValue>
+  void Quantize(std::vector<DQuantizedNode<TValue>>& oNodes);
+  /// @brief Decode child bounds of quantized node into float bounds of given node.
+  template <typename TValue>
+  static void Decode(const DQuantizedNode<TValue>& node, DNode& oNode) noexcept;
+
+  /// @brief Collapse given binary node and its descendants into one wide node, recursively.
+  /// @param depth Depth of created node. Root is 1.
+  /// @return The child value of created node.
+  TChild CollapseNode(const TNode& node, TIndex depth);
+  /// @brief Create root node that has only one leaf child, when root of binary tree is leaf.
+  void CreateRootOfLeaf(const TNode& root);
+  /// @brief Create leaf that references given binary leaf node.
+  /// @return The child value of created leaf.
+  TChild CreateLeaf(const TNode& node);
+
+  TIndex mWidth = 4;
+  TIndex mQuantizeBits = 0;
+  TIndex mNodeCount = 0;
+  /// @brief Entry count that traversal stack needs at most. Each level pushes up to `width - 1` more entries.
+  TIndex mStackCapacity = 1;
+  std::vector<DNode> mNodes;
+  std::vector<DQuantizedNode<TU8>>  mNodes8;
+  std::vector<DQuantizedNode<TU16>> mNodes16;
+  std::vector<const TNode*> mpLeaves;
+};
+
+} /// ::ray namespace
+#include <Inline/DWideTree.inl>
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <cstdint>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @struct PTraversalStats
+/// @brief Counters of tree traversal for comparing tree layouts.
+struct PTraversalStats final
+{
+  /// @brief The count of rays that are tested against scene.
+  std::uint64_t mRayCount = 0;
+  /// @brief The count of node visits of object and mesh trees that test bounding boxes.
+  /// Binary node tests its own box, and wide node tests all child boxes at once.
+  std::uint64_t mNodeVisitCount = 0;
+  /// @brief The count of primary rays whose first hit is reused from first-hit cache, instead of being tested.
+  std::uint64_t mReusedHitCount = 0;
+
+  PTraversalStats& operator+=(const PTraversalStats& rhs) noexcept
+  {
+    this->mRayCount       += rhs.mRayCount;
+    this->mNodeVisitCount += rhs.mNodeVisitCount;
+    this->mReusedHitCount += rhs.mReusedHitCount;
+    return *this;
+  }
+};
+
+/// @brief Get traversal statistics of current thread. 
+/// Each render thread accumulates into its own instance, so counting does not need any synchronization.
+PTraversalStats& GetThreadTraversalStats() noexcept;
+
+} /// ::ray namespace
@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <memory>
 #include <optional>
+#include <shared_mutex>
 #include <iostream>
 
 #include <tinyobj/tiny_obj_loader.h>
@@ -62,6 +63,7 @@ public:
   std::optional<DMatId> AddMaterial(const typename TType::PCtor& ctor);
 
   /// @brief Add external candidate material with outer library material information.
+  /// This function can be called from multiple threads while models are loaded concurrently.
   /// @param materialInfo Material information of `.obj` file.
   /// @return If successful, return created material ID. 
   std::optional<DMatId> AddCandidateMaterial(const tinyobj::material_t& materialInfo);
@@ -99,6 +101,8 @@ private:
   TContainer mContainer;
   /// @brief External Material containers that is not ready but have meta informations of meterial.
   TCandMaterials mCandidates;
+  /// @brief Lock of candidate materials, which are added while models are loaded.
+  mutable std::shared_mutex mCandidateMutex;
 };
 
 } /// ::ray namespace
@@ -16,6 +16,7 @@
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <shared_mutex>
 
 #include <nlohmann/json_fwd.hpp>
 #include <Expr/ISingleton.h>
@@ -28,12 +29,17 @@
 #include <Resource/DModelMesh.hpp>
 #include <Resource/DModel.hpp>
 #include <Resource/DModelPrefab.hpp>
+#include <Resource/XMeshCache.hpp>
 
 namespace ray
 {
 
+class FMappedFile;
+
 /// @class MModel
 /// @brief Material management singleton type.
+/// Containers are guarded with lock, so models can be added from multiple threads. (See `AddModels`)
+/// Returned pointers are valid until manager is released, because items are never removed before that.
 class MModel final : public ::dy::expr::ISingleton<MModel>
 {
 public:
@@ -56,10 +62,20 @@ public:
   const DModelPrefab* GetModelPrefab(const DModelId& id) const noexcept;
 
   /// @brief Create Model with prefab (resource prefab) model.
+  /// If model file that has the same content was already loaded, buffer, meshes and trees of it are shared,
+  /// and only new model that has scale of prefab is created.
+  /// If valid mesh cache of model file is exist, geometry and trees are mapped from cache without parsing. 
+  /// Otherwise, mesh cache is written after model is built.
   /// @param prefab The information of model not populated yet.
   /// @param preparedId The pointer of prepared Model id. If exist, the function does not create new model id. 
   /// @return If successful, return Model ID. If `preparedId` is exist, `preparedId` will be returned.
   std::optional<DModelId> AddModel(const DModelPrefab& prefab, const DModelId* preparedId = nullptr);
+  /// @brief Create models of given prefab ids concurrently. Each prefab id is also used as model id.
+  /// Model files are mapped and hashed concurrently first. Then files of different content are loaded and built 
+  /// concurrently from the largest file, and prefabs of the same content share geometry of it after that.
+  /// @param ids Prefab ids of models to create. Models must not be created yet.
+  /// @return If all models are created, return true. Otherwise, return false.
+  bool AddModels(const std::vector<DModelId>& ids);
   /// @brief Check given id has valid, so DModel is exist in container.
   /// @param id Model id.
   /// @return If found, return true. Otherwise, return false.
@@ -99,7 +115,32 @@ public:
   /// @return The pointer of DModelMesh when found, If not find just return nullptr.
   const DModelMesh* GetMesh(const DMeshId& id) const noexcept;
 
+  /// @brief Set branch width of mesh trees that will be created. Supported value is 2, 4 and 8.
+  void SetTreeWidth(TIndex width) noexcept;
+  /// @brief Get branch width of mesh trees.
+  TIndex GetTreeWidth() const noexcept;
+  /// @brief Set bit count of quantized child bounds of mesh wide trees. Supported value is 0 (disabled), 8 and 16.
+  void SetTreeQuantizeBits(TIndex bits) noexcept;
+  /// @brief Get bit count of quantized child bounds of wide trees.
+  TIndex GetTreeQuantizeBits() const noexcept;
+  /// @brief Set crease angle (degree) of smooth normals that are created for model without normals.
+  void SetCreaseAngle(TReal degree) noexcept;
+  /// @brief Set model normals are not stored, but geometric normals are derived on hit.
+  /// If true, normals of model file are also discarded.
+  void SetUsingGeometricNormals(bool isUsing) noexcept;
+  /// @brief Set buffers and meshes of loaded model are optimized. (See `DModelBuffer::OptimizeWith`)
+  /// @param weldTolerance Cell size of vertex welding. If 0, only vertices of exactly the same position are welded.
+  void SetMeshOptimization(bool isEnabled, TReal weldTolerance) noexcept;
+  /// @brief Set binary mesh caches of model files are read and written. (See `XMeshCache.hpp`)
+  /// @param directory Directory of cache files. If empty, cache file is placed beside model file.
+  void SetMeshCache(bool isEnabled, const std::string& directory);
+  /// @brief Get overall memory footprint of wide trees of all meshes.
+  PWideTreeMemory GetWideTreeMemory() const noexcept;
+
 private:
+  /// @brief Lock of containers below. Loading settings are not guarded, and must be set before loading.
+  mutable std::shared_mutex mMutex;
+
   using TModelKey = DModelId; 
   using TModelContainer = std::unordered_map<TModelKey, DModel>;
   TModelContainer mModelContainer;
@@ -114,6 +155,59 @@ private:
 
   using TModelPrefabs = std::unordered_map<TModelKey, DModelPrefab>;
   TModelPrefabs mModelPrefabs;
+
+  /// @brief Loaded geometry of model file that is shared by models of the same file content and material libraries.
+  struct PLoadedGeometry final
+  {
+    TIndex                mByteSize = 0;
+    DModelBufferId        mBufferId;
+    std::vector<DMeshId>  mMeshIds;
+    std::vector<DMatId>   mMaterialIds;
+  };
+  /// @brief Key is hash of content and material libraries of model file.
+  using TLoadedGeometries = std::unordered_map<TU64, PLoadedGeometry>;
+  TLoadedGeometries mLoadedGeometries;
+
+  /// @brief Find loaded geometry of given geometry hash and byte size.
+  std::optional<PLoadedGeometry> FindLoadedGeometry(TU64 geometryHash, TIndex byteSize) const;
+  /// @brief Register loaded geometry with geometry hash. If already registered, given geometry is not shared.
+  void AddLoadedGeometry(TU64 geometryHash, const PLoadedGeometry& geometry);
+  /// @brief Create buffer, meshes and trees from mapped mesh cache.
+  std::optional<PLoadedGeometry> CreateGeometryFrom(PMeshCache& cache, const std::string& path);
+  /// @brief Get hash of load settings that change built geometry.
+  TU64 GetMeshSettingHash() const noexcept;
+  /// @brief Get mesh cache path of given model file.
+  std::filesystem::path GetMeshCachePathOf(const std::string& path, TU64 geometryHash) const;
+
+  /// @brief Create model of prefab from mapped model file and geometry hash of it. (See `AddModel`)
+  std::optional<DModelId> AddModelFrom(
+    const DModelPrefab& prefab, 
+    const DModelId* preparedId, 
+    const FMappedFile& file, 
+    TU64 geometryHash);
+  /// @brief Create model that refers to given loaded geometry, with scale of prefab.
+  std::optional<DModelId> CreateModel(
+    const DModelId& id, 
+    const PLoadedGeometry& geometry, 
+    TReal scale, 
+    const std::string& path);
+
+  /// @brief Branch width of mesh trees. If 2, only binary KDTree is used.
+  TIndex mTreeWidth = 2;
+  /// @brief Bit count of quantized child bounds of mesh wide trees. If 0, nodes are not compressed.
+  TIndex mTreeQuantizeBits = 0;
+  /// @brief Crease angle (degree) of created smooth normals.
+  TReal mCreaseAngle = 60.0f;
+  /// @brief If true, normals are not stored and geometric normals are used.
+  bool mIsUsingGeometricNormals = false;
+  /// @brief If true, vertices are welded and reordered when model is loaded.
+  bool mIsOptimizingMeshes = true;
+  /// @brief Cell size of vertex welding.
+  TReal mWeldTolerance = 0.0f;
+  /// @brief If true, mesh caches are read and written.
+  bool mIsUsingMeshCache = true;
+  /// @brief Directory of mesh caches. If empty, cache is placed beside model file.
+  std::string mMeshCacheDirectory;
 };
 
 } /// ::ray namespace
\ No newline at end of file
@@ -13,6 +13,7 @@
 ///
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <type_traits>
 #include <unordered_map>
@@ -23,7 +24,9 @@
 #include <Interface/IHitable.hpp>
 #include <Object/FCamera.hpp>
 #include <KDTree/DObjectNode.hpp>
+#include <KDTree/DWideTree.hpp>
 #include <Interface/IObject.hpp>
+#include <Simd/DRayPacket.hpp>
 
 namespace ray
 {
@@ -41,6 +44,14 @@ public:
     TU32    mNumSamples;  /// @brief The count of samples per pixel.
     TU32    mRepeat;      /// @brief The repeat
     TReal   mGamma;       /// @brief The gamma.
+    TIndex  mTreeWidth = 2; /// @brief Branch width of object and mesh trees. (2, 4 or 8)
+    TIndex  mTreeQuantizeBits = 0; /// @brief Bit count of quantized child bounds of wide trees. (0, 8 or 16)
+    TReal   mCreaseAngle = 60.0f; /// @brief Crease angle (degree) of smooth normals created for models.
+    bool    mIsUsingGeometricNormals = false; /// @brief Do not store model normals, but use geometric normals.
+    bool    mIsOptimizingMeshes = true; /// @brief Weld and reorder vertices and triangles of loaded models.
+    TReal   mWeldTolerance = 0.0f; /// @brief Cell size of vertex welding. If 0, only exact duplicates are welded.
+    bool    mIsUsingMeshCache = true; /// @brief Read and write binary mesh caches of loaded models.
+    std::string mMeshCacheDirectory;  /// @brief Directory of mesh caches. If empty, cache is placed beside model.
   };
 
   EXPR_SINGLETON_DERIVED(MScene);
@@ -69,12 +80,30 @@ public:
   /// @return RGB Color that has range of [0, 1].
   DVec3 ProceedRay(const DRay& ray, TIndex cnt = 0, TIndex limit = 8);
 
+  /// @brief Get the closest intersection of given ray among scene objects.
+  /// @param ray The ray to be tested, in world-space.
+  /// @return If intersected, return the result that has the smallest positive T.
+  std::optional<PTValueResult> GetClosestIntersection(const DRay& ray) const;
+
+  /// @brief Get the closest intersections of every lane of given ray packet among scene objects.
+  /// @param packet The ray packet to be tested, in world-space.
+  /// @param ioHits The closest results of each lane.
+  void GetClosestIntersections(const DRayPacket& packet, DPacketHits& ioHits) const;
+
+  /// @brief Get background (sky) color of given ray that does not hit any object.
+  /// @param ray The ray in world-space.
+  /// @return RGB Color that has range of [0, 1].
+  DVec3 GetBackgroundColor(const DRay& ray) const noexcept;
+
   /// @brief Get immutable pointer of camera.
   std::vector<const FCamera*> GetCameras() const noexcept;
 
   /// @brief Get Overall Scene IOR (Index of Refraction).
   TReal GetSceneIOR() const noexcept;
 
+  /// @brief Get memory footprint of wide object tree. If wide tree is not created, all values are 0.
+  PWideTreeMemory GetWideTreeMemory() const noexcept;
+
 private:
   /// @brief Load scene with v190710 structure.
   /// @param json Json atlas.
@@ -96,11 +125,22 @@ private:
   /// @param json Json atlas of `objects`.
   /// @return Success flag when returned true.
   bool AddObjectsFromJson190710(const nlohmann::json& json, const PSceneDefaults& defaults);
+  /// @brief Gather model resources that objects of v190710 scene structure refer to, and load them concurrently.
+  /// Invalid items are skipped here, and reported while creating objects.
+  /// @param json Json atlas of `objects`.
+  /// @return Success flag when returned true.
+  bool AddModelsOfObjectsFromJson190710(const nlohmann::json& json);
+  /// @brief Build object tree with all scene objects. If width is 4 or 8, wide tree is also collapsed.
+  /// @param width Branch width of tree.
+  /// @param quantizeBits Bit count of quantized child bounds of wide tree. 0 (uncompressed), 8 or 16.
+  void BuildObjectTree(TIndex width, TIndex quantizeBits);
 
   std::unordered_map<std::string, std::unique_ptr<IObject>> mPrefabs;
   std::vector<std::unique_ptr<IHitable>>  mObjects;
   std::vector<std::unique_ptr<FCamera>>   msmtCameras;
-  std::unique_ptr<DObjectNode>  mObjectTree;
+  /// @brief All nodes and leaf items of object KDTree. The first node is root.
+  DObjectNode::TArena           mObjectTree;
+  std::unique_ptr<DWideTree<DObjectNode>> mWideObjectTree;
 
   /// @brief Overall scene ior (index of refraction).
   TReal mSceneIor;
@@ -57,6 +57,13 @@ public:
 
   /// @brief Get ray calculated by [x, y] of Image size and eye / forward.
   std::vector<DRay> CreateRay(TIndex x, TIndex y) const noexcept;
+  /// @brief Create one ray of given sub-pixel offset at [x, y].
+  /// Lens point of depth of field is drawn from random stream of current thread,
+  /// so caller should seed it with `ESampleStage::Camera` before calling this, to be deterministic.
+  /// @param offsetIndex Index of sub-pixel offset. Must be less than `GetSampleOffsetCount()`.
+  DRay CreateSampleRay(TIndex x, TIndex y, TIndex offsetIndex) const noexcept;
+  /// @brief Get the count of sub-pixel offsets (rays) of each pixel per repeat.
+  TIndex GetSampleOffsetCount() const noexcept;
 
   /// @brief Set sample value of pixel. (1, 2, 4)
   void SetSamples(TU32 sample);
@@ -94,6 +101,7 @@ private:
   DVec3 mCellRight, mCellUp;
   DUVec2 mScreenSize;
 
+  std::vector<DVec3> mSampleOffsets;
   TU32  mSamples = 4;
   TU32  mRepeat = 1;
   TReal mAperture = 1.0f;
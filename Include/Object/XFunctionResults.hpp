@@ -64,9 +64,9 @@ class PTriangleResult final
 {
 public:
   using TReal   = ray::TReal;
-  using TIndex  = ray::TIndex;
   TReal mT;
-  std::array<TIndex, 3> mIndex;
+  /// @brief Index of triangle in mesh.
+  TU32  mTriangle;
 };
 
 } /// ::ray namespace
\ No newline at end of file
@@ -45,6 +45,9 @@ public:
   /// @return If intersected and could get diffuse scattered reflection (with dialectric), return result.
   std::optional<PScatterResult> Scatter(const DRay& intersectedRay, const DVec3& normal) const override final;
 
+  /// @brief Get base color of surface.
+  DVec3 GetAlbedo() const noexcept override final { return this->mColor; }
+
 private:
   DVec3 mColor;
   ::dy::math::DClamp<TReal, 0, 1> mRoughness;
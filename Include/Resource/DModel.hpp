@@ -34,6 +34,8 @@ public:
     DModelBufferId mBufferId;
     std::vector<DMeshId>  mMeshIds;
     std::vector<DMatId>   mMaterialIds;
+    /// @brief Uniform scale of prefab. Buffer is not scaled, so scale is applied to instance transform.
+    TReal mScale = 1.0f;
   };
   DModel(const PCtor& ctor); 
 
@@ -45,11 +47,15 @@ public:
   /// @return Valid material id list.
   const std::vector<DMatId>& GetInternalMaterials() const noexcept;
 
+  /// @brief Get uniform scale of model prefab that must be multiplied to scale of instance.
+  TReal GetScale() const noexcept;
+
 private:
   DModelId              mId;
   DModelBufferId        mBufferId;
   std::vector<DMeshId>  mMeshes;
   std::vector<DMatId>   mMaterials;
+  TReal                 mScale;
 };
 
 } /// ::ray namespace
\ No newline at end of file
@@ -12,15 +12,18 @@
 /// SOFTWARE.
 ///
 
+#include <memory>
 #include <vector>
-#include <tinyobj/tiny_obj_loader.h>
 #include <XCommon.hpp>
+#include <Helper/PArrayView.hpp>
 #include <Id/DModelBufferId.hpp>
 #include <Id/DMeshId.hpp>
 
 namespace ray
 {
 
+class FMappedFile; // Forward declaration
+
 /// @class DModelBuffer
 /// @brief Buffer class of each model. Buffer has serial vertices, normal and texture uv(w)s.
 /// Also, searching time can be optimized by using KD-Tree.
@@ -31,7 +34,14 @@ public:
   using TNormals = std::vector<DVec3>;
   using TUVs = std::vector<DVec2>;
 
-  DModelBuffer(const DModelBufferId& id, const tinyobj::attrib_t& attrib);
+  /// @brief Create buffer by moving given lists that are parsed from model file.
+  DModelBuffer(const DModelBufferId& id, TPointVertices&& vertices, TNormals&& normals, TUVs&& uv0s);
+  /// @brief Create buffer that refers to lists in mapped mesh cache file, without copying them.
+  /// Mapped file is kept alive while buffer is alive. Buffer that is created by this can not be modified.
+  DModelBuffer(
+    const DModelBufferId& id, 
+    std::shared_ptr<const FMappedFile> pCacheFile,
+    PArrayView<DVec3> vertices, PArrayView<DVec3> normals, PArrayView<DVec2> uv0s);
 
   /// @brief Get count of vertices.
   TIndex GetCountOfVertices() const noexcept;
@@ -48,24 +58,48 @@ public:
   bool HasUv0s() const noexcept;
 
   /// @brief Get vertex list of model.
-  const TPointVertices& GetVertices() const noexcept;
+  PArrayView<DVec3> GetVertices() const noexcept;
   /// @brief Get normal vector list of model.
-  const TNormals& GetNormals() const noexcept;
+  PArrayView<DVec3> GetNormals() const noexcept;
   /// @brief Get UV0 list of model.
-  const TUVs& GetUV0s() const noexcept;
+  PArrayView<DVec2> GetUV0s() const noexcept;
+  /// @brief Check buffer refers to mapped mesh cache file.
+  bool IsMapped() const noexcept { return this->mpCacheFile != nullptr; }
   /// @brief Get model buffer id.
   DModelBufferId GetId() const noexcept;
 
-  /// @brief Create normals from given geometry `mVertices`, with triangle.
+  /// @brief Optimize buffer and index list of given meshes for locality of triangle fetch.
+  /// Vertices within tolerance are welded, and unreferenced vertices, normals and uvs are dropped.
+  /// Vertices and triangles of each mesh are reordered along Morton curve, and degenerated triangles are removed.
+  /// This function must be called before triangles and tree of meshes are created.
+  /// @param meshIds Valid mesh id list that refers to this buffer.
+  /// @param weldTolerance Distance of welding. If 0, only vertices that have exactly the same position are welded.
+  /// @return If successful, return true.
+  bool OptimizeWith(const std::vector<DMeshId>& meshIds, TReal weldTolerance);
+
+  /// @brief Create angle-weighted smooth normals from given geometry `mVertices`, with triangle.
+  /// Faces around vertex are averaged only when angle between faces is not bigger than crease angle,
+  /// and corners of vertex that have the same result share one normal.
+  /// So one normal is created per vertex when vertex is not on crease.
+  /// Vertex that has too many distinct faces around it uses face normals, not to compare all pairs of faces.
   /// @param meshIds Valid mesh id list.
+  /// @param creaseAngle Crease angle threshold as degree. If 180, all faces around vertex are averaged.
   /// @return If successful, return true.
-  bool CreateNormalsWith(const std::vector<DMeshId>& meshIds);
+  bool CreateNormalsWith(const std::vector<DMeshId>& meshIds, TReal creaseAngle);
+  /// @brief Release all normals. Mesh that uses buffer without normals derives geometric normal on hit.
+  void ReleaseNormals() noexcept;
 
 private:
   DModelBufferId  mId;
   TPointVertices  mVertices;
   TNormals        mNormals;
   TUVs            mUV0s;
+
+  /// @brief Mapped mesh cache file. If not null, lists below are used instead of owned lists.
+  std::shared_ptr<const FMappedFile> mpCacheFile = nullptr;
+  PArrayView<DVec3> mMappedVertices;
+  PArrayView<DVec3> mMappedNormals;
+  PArrayView<DVec2> mMappedUV0s;
 };
 
 } /// ::ray namespace
\ No newline at end of file
@@ -14,15 +14,16 @@
 
 #include <string>
 #include <vector>
-#include <tinyobj/tiny_obj_loader.h>
 #include <Id/DMeshId.hpp>
 #include <Id/DModelBufferId.hpp>
 #include <Id/DMatId.hpp>
 
 #include <XCommon.hpp>
+#include <Helper/PArrayView.hpp>
 #include <Resource/DModelIndex.hpp>
-#include <Resource/DModelFace.hpp>
+#include <Resource/DModelTriangle.hpp>
 #include <KDTree/DTreeNode.hpp>
+#include <KDTree/DWideTree.hpp>
 
 namespace ray
 {
@@ -38,7 +39,12 @@ public:
     DMeshId         mId;
     DMatId*         mpMatId = nullptr;
     DModelBufferId  mBufferId;
-    const tinyobj::shape_t* mpShape = nullptr;
+    const std::string* mpName = nullptr;
+    /// @brief Index list of mesh. It is moved into mesh, so it is empty after mesh is created.
+    /// If null, mesh refers to mapped indices and triangles below instead. (e.g. from mesh cache file)
+    std::vector<DModelIndex>* mpIndices = nullptr;
+    PArrayView<DModelIndex>     mMappedIndices;
+    PArrayView<DModelTriangle>  mMappedTriangles;
   };
 
   DModelMesh(const PCtor& ctor);
@@ -55,19 +61,33 @@ public:
   /// @brief Get name of mesh. Name may be empty by loaded model file.
   const std::string& GetName() const noexcept;
   /// @brief Get index list of mesh.
-  std::vector<DModelIndex>& GetIndices() noexcept;
-  /// @brief Get index list of mesh.
-  const std::vector<DModelIndex>& GetIndices() const noexcept;
-  /// @brief Get face list of mesh.
-  const std::vector<DModelFace>& GetFaces() const noexcept;
+  PArrayView<DModelIndex> GetIndices() const noexcept;
+  /// @brief Get modifiable index list of mesh. Mesh must not be mapped.
+  std::vector<DModelIndex>& GetMutableIndices() noexcept;
+  /// @brief Get triangle list of mesh. Triangle `i` uses `3i`, `3i+1` and `3i+2` of index list.
+  PArrayView<DModelTriangle> GetTriangles() const noexcept;
+  /// @brief Check mesh refers to mapped indices and triangles, which can not be modified.
+  bool IsMapped() const noexcept;
   /// @brief Get KdTree Header node pointer.
   const DTreeNode& GetTreeHeader() const noexcept;
+  /// @brief Get wide tree that is collapsed from KdTree. If not created, return nullptr.
+  const DWideTree<DTreeNode>* GetWideTree() const noexcept;
 
-  /// @brief Internal function. Create faces. This function must be called before `CreateKdTree()`.
-  void CreateFaces();
+  /// @brief Internal function. Create triangles. This function must be called before `CreateKdTree()`.
+  void CreateTriangles();
   /// @brief Internal function. Create KDTree data structure for traversal optimization.
-  /// This function should be called after `CreateFaces()`.
-  void CreateKdTree();
+  /// This function should be called after `CreateTriangles()`.
+  /// @param width Branch width of tree. If 4 or 8, wide tree is also collapsed from binary KDTree.
+  /// @param quantizeBits Bit count of quantized child bounds of wide tree. 0 (uncompressed), 8 or 16.
+  void CreateKdTree(TIndex width = 2, TIndex quantizeBits = 0);
+  /// @brief Internal function. Restore KDTree from flattened nodes instead of building it.
+  /// @param nodes Validated flattened nodes of tree.
+  /// @param pBlocks Triangle blocks that nodes refer to. They must be alive while mesh is alive.
+  /// @param width Branch width of tree. If 4 or 8, wide tree is also collapsed from restored tree.
+  /// @param quantizeBits Bit count of quantized child bounds of wide tree. 0 (uncompressed), 8 or 16.
+  void RestoreKdTree(
+    PArrayView<DTreeNode::PFlatNode> nodes, const DTriangleBlock* pBlocks, 
+    TIndex width = 2, TIndex quantizeBits = 0);
 
 private:
   DMeshId         mId;
@@ -76,8 +96,13 @@ private:
 
   std::string mName;
   std::vector<DModelIndex>    mIndices;
-  std::vector<DModelFace>     mFaces;
-  std::unique_ptr<DTreeNode>  mLocalSpaceTree;
+  std::vector<DModelTriangle> mTriangles;
+  bool                        mIsMapped = false;
+  PArrayView<DModelIndex>     mMappedIndices;
+  PArrayView<DModelTriangle>  mMappedTriangles;
+  /// @brief All nodes and leaf blocks of local-space KDTree. The first node is root.
+  DTreeNode::TArena           mLocalSpaceTree;
+  std::unique_ptr<DWideTree<DTreeNode>> mLocalSpaceWideTree;
 };
 
 } /// ::ray namespace
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <array>
+#include <XCommon.hpp>
+
+namespace ray
+{
+
+/// @class DModelTriangle
+/// @brief Compact triangle of mesh that has 32-bit indices of three vertices in shared vertex stream of model buffer.
+/// Normals and uvs are referred with mesh indices (`DModelIndex`) of the same triangle index,
+/// and bounds are not stored but computed only while building tree.
+class DModelTriangle final
+{
+public:
+  std::array<TU32, 3> mVertex;
+};
+static_assert(sizeof(DModelTriangle) == 12);
+
+} /// ::ray namespace
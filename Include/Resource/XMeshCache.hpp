@@ -0,0 +1,116 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <tinyobj/tiny_obj_loader.h>
+#include <XCommon.hpp>
+#include <Helper/FMappedFile.hpp>
+#include <Helper/PArrayView.hpp>
+#include <KDTree/DTreeNode.hpp>
+#include <Resource/DModelBuffer.hpp>
+#include <Resource/DModelIndex.hpp>
+#include <Resource/DModelTriangle.hpp>
+
+namespace ray
+{
+
+class DModelMesh; // Forward declaration
+
+/// @brief Version of geometry processing of loaded model, such as parsing, welding, normals and tree building.
+/// Increase it when any of them is changed, so mesh cache that is built by previous code is regarded as stale.
+constexpr TU64 kMeshBuilderVersion = 1;
+
+/// @brief Maximum depth of mesh tree that is written into and read from mesh cache.
+/// Trees are flattened and traversed recursively, so mesh that has deeper tree is not cached.
+constexpr TIndex kMaxMeshCacheTreeDepth = 1024;
+
+/// @struct PMeshCacheKey
+/// @brief Key that mesh cache file is validated with. 
+/// If any value is different from values of cache file, cache file is regarded as stale.
+struct PMeshCacheKey final
+{
+  /// @brief Content hash of source model file, combined with paths and content of its material libraries.
+  TU64 mSourceHash = 0;
+  /// @brief Byte size of source model file.
+  TU64 mSourceSize = 0;
+  /// @brief Hash of load settings that change stored geometry. (e.g. welding, normals)
+  TU64 mSettingHash = 0;
+  /// @brief Version of geometry processing that built stored geometry.
+  TU64 mBuilderVersion = kMeshBuilderVersion;
+};
+
+/// @struct PMeshCacheMesh
+/// @brief Mesh of mesh cache file. Lists refer to mapped content of cache file.
+struct PMeshCacheMesh final
+{
+  std::string mName;
+  /// @brief Index of material in `PMeshCache::mMaterials`. If -1, mesh does not have material.
+  TI32 mMaterialIndex = -1;
+  PArrayView<DModelIndex>           mIndices;
+  PArrayView<DModelTriangle>        mTriangles;
+  PArrayView<DTreeNode::PFlatNode>  mNodes;
+  PArrayView<DTriangleBlock>        mBlocks;
+};
+
+/// @struct PMeshCache
+/// @brief Mesh cache file that is mapped as read-only.
+/// Lists refer to mapped content directly, so `mpFile` must be alive while lists are used.
+struct PMeshCache final
+{
+  std::shared_ptr<const FMappedFile> mpFile = nullptr;
+  PArrayView<DVec3> mVertices;
+  PArrayView<DVec3> mNormals;
+  PArrayView<DVec2> mUV0s;
+  std::vector<PMeshCacheMesh>       mMeshes;
+  std::vector<tinyobj::material_t>  mMaterials;
+};
+
+/// @brief Get 64-bit hash value of given content.
+/// Content is split into fixed-size blocks that are hashed word by word in parallel, 
+/// and hashes of blocks are combined in order. So the result does not depend on thread count.
+TU64 GetContentHashOf(const char* pData, TIndex size);
+
+/// @brief Write built buffer, meshes and trees of model into mesh cache file.
+/// File is written into temporary file and renamed, so other process never reads half-written file.
+/// Material library files that materials are loaded from are recorded with their content hash,
+/// so cache file is regarded as stale when one of them is changed.
+/// @param path Path of cache file.
+/// @param key Key of source model file and load settings.
+/// @param buffer Built model buffer. Buffer must not be mapped.
+/// @param pMeshes Built meshes of model. Meshes must have triangles and tree. 
+/// If tree of any mesh is deeper than `kMaxMeshCacheTreeDepth`, cache file is not written.
+/// @param meshMaterials Index of material in `materials` of each mesh. If -1, mesh does not have material.
+/// @param materials Materials of model.
+/// @param materialLibraries Paths of material library files.
+/// @return If successful, return true. Otherwise, return false.
+bool WriteMeshCache(
+  const std::filesystem::path& path,
+  const PMeshCacheKey& key,
+  const DModelBuffer& buffer,
+  const std::vector<const DModelMesh*>& pMeshes,
+  const std::vector<TI32>& meshMaterials,
+  const std::vector<tinyobj::material_t>& materials,
+  const std::vector<std::filesystem::path>& materialLibraries);
+
+/// @brief Map mesh cache file and validate it with given key. Geometry lists are not copied.
+/// @param path Path of cache file.
+/// @param key Key of source model file and load settings.
+/// @return If cache file is exist and valid, return mapped cache. Otherwise, return null value.
+std::optional<PMeshCache> ReadMeshCache(const std::filesystem::path& path, const PMeshCacheKey& key);
+
+} /// ::ray namespace
@@ -0,0 +1,71 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include <tinyobj/tiny_obj_loader.h>
+#include <XCommon.hpp>
+#include <Resource/DModelIndex.hpp>
+#include <Resource/DModelBuffer.hpp>
+
+namespace ray
+{
+
+/// @struct PObjShape
+/// @brief Shape of parsed obj file. Faces are triangulated as fan.
+/// New shape is started by `g` or `o` line, and also by `usemtl` line that changes material,
+/// so each shape has only one material.
+struct PObjShape final
+{
+  std::string mName;
+  /// @brief Index of material in `PObjModel::mMaterials`. If -1, shape does not have material.
+  TI32 mMaterialIndex = -1;
+  std::vector<DModelIndex> mIndices;
+};
+
+/// @struct PObjModel
+/// @brief Parsed obj file. Lists are laid out as final buffers of model, so they can be moved into resources.
+struct PObjModel final
+{
+  DModelBuffer::TPointVertices  mVertices;
+  DModelBuffer::TNormals        mNormals;
+  DModelBuffer::TUVs            mUV0s;
+  std::vector<PObjShape>        mShapes;
+  std::vector<tinyobj::material_t> mMaterials;
+  /// @brief Paths of material library files that materials are loaded from.
+  std::vector<std::filesystem::path> mMaterialLibraries;
+};
+
+/// @brief Find material library files that obj file content refers to, without parsing content.
+/// Libraries are resolved in file order as the same as `ParseObjModel`, and missing library is skipped.
+/// @param pData Content of obj file. It does not need to be null-terminated.
+/// @param size Byte size of content.
+/// @param directory Directory of obj file.
+std::vector<std::filesystem::path> FindMaterialLibraries(
+  const char* pData, TIndex size, 
+  const std::filesystem::path& directory);
+
+/// @brief Parse obj file content in parallel. 
+/// Content is split into line-aligned chunks, and each chunk is counted first and then parsed into final lists.
+/// Material libraries are searched from given directory first, and then from working directory.
+/// @param pData Content of obj file. It does not need to be null-terminated.
+/// @param size Byte size of content.
+/// @param directory Directory of obj file.
+/// @return If successful, return parsed model. Otherwise, return null value.
+std::optional<PObjModel> ParseObjModel(const char* pData, TIndex size, const std::filesystem::path& directory);
+
+} /// ::ray namespace
@@ -22,6 +22,8 @@
 #include <Helper/XJsonCallback.hpp>
 #include <Helper/EJsonExistance.hpp>
 #include <Id/DModelId.hpp>
+#include <KDTree/DObjectNode.hpp>
+#include <KDTree/DWideTree.hpp>
 #include <Shape/FModelMesh.hpp>
 #include <Shape/PModelCtor.hpp>
 
@@ -49,6 +51,12 @@ public:
   /// @return When ray intersected to ray, returns TReal list.
   std::optional<TValueResults> GetRayIntersectedTValues(const DRay& ray) const override final;
 
+  /// @brief Update the closest results of active lanes of ray packet.
+  /// @param packet Ray packet of world-space.
+  /// @param activeMask Bit mask of lanes to test.
+  /// @param ioHits The closest results of packet.
+  void GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const override final;
+
   /// @brief Diffuse scattering function.
   /// @param ray World space ray to intersect.
   /// @param t Forwarding value t for moving ray origin into surface approximately.
@@ -67,6 +75,11 @@ private:
 
   DModelId mModelId;
   std::vector<std::unique_ptr<FModelMesh>> mpMeshes;
+
+  /// @brief Tree over world-space bounds of meshes, so ray cost grows logarithmically with the count of meshes.
+  DObjectNode::TArena mMeshTree;
+  /// @brief Wide tree collapsed from mesh tree. Created only when mesh tree width of MModel is 4 or 8.
+  std::unique_ptr<DWideTree<DObjectNode>> mWideMeshTree;
 };
 
 } /// ::ray namespace
@@ -54,6 +54,12 @@ public:
   /// @param ray Ray of worls-space.
   /// @return When ray intersected to ray, returns TReal list.
   std::optional<TValueResults> GetRayIntersectedTValues(const DRay& ray) const override final;
+
+  /// @brief Update the closest results of active lanes of ray packet.
+  /// @param packet Ray packet of world-space.
+  /// @param activeMask Bit mask of lanes to test.
+  /// @param ioHits The closest results of packet.
+  void GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const override final;
   
   /// @brief Diffuse scattering function.
   /// @param ray World space ray to intersect.
@@ -67,6 +73,10 @@ public:
   FModelMesh::PCtor GetPCtor() const noexcept;
 
 private:
+  /// @brief Get averaged local-space normal of triangle that has given triangle index of mesh.
+  /// If model buffer does not have normals, geometric normal of triangle is returned.
+  DVec3 GetLocalNormalOf(TU32 triangle) const noexcept;
+
   DVec3 mOrigin;
   TReal mScale;
   DQuat mRotQuat;
@@ -0,0 +1,104 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <array>
+#include <optional>
+#include <XCommon.hpp>
+#include <Object/XFunctionResults.hpp>
+
+namespace ray
+{
+
+/// @class DRayPacket
+/// @brief Coherent ray packet that has SoA (Structure of Arrays) layout for SIMD traversal.
+/// Packet width must be 4 or 8. Lanes that are not used should be masked off by caller.
+class DRayPacket final
+{
+public:
+  static_assert(std::is_same_v<TReal, float>, "Ray packet only supports single precision floating point.");
+  static constexpr TIndex kMaxWidth = 8;
+
+  DRayPacket() = default;
+  DRayPacket(TIndex width);
+
+  /// @brief Set lane's ray with given world or local space ray.
+  void SetRay(TIndex lane, const DRay& ray);
+  /// @brief Get bit mask that every lane of packet width is set.
+  TU32 GetFullMask() const noexcept;
+  /// @brief Get packet width.
+  TIndex GetWidth() const noexcept { return this->mWidth; }
+
+  /// @brief Create new packet that is transformed into local space of mesh.
+  /// @param matWorldToLocal Transposed rotation matrix of mesh.
+  /// @param origin World-space position of mesh.
+  /// @param scale Uniform scale of mesh.
+  template <typename TMatrix>
+  DRayPacket GetTransformedOf(const TMatrix& matWorldToLocal, const DVec3& origin, TReal scale) const;
+
+  alignas(32) std::array<float, kMaxWidth> mOrigin[3];
+  alignas(32) std::array<float, kMaxWidth> mDirection[3];
+  alignas(32) std::array<float, kMaxWidth> mInvDirection[3];
+  /// @brief Original rays that are used when traversal falls back to single ray.
+  std::array<DRay, kMaxWidth> mRays;
+
+private:
+  TIndex mWidth = 0;
+};
+
+/// @class DPacketHits
+/// @brief Closest intersection results of ray packet in world-space.
+class DPacketHits final
+{
+public:
+  DPacketHits();
+
+  /// @brief Update lane's closest result when given result is closer than previous one.
+  /// @return If updated, return true.
+  bool TryUpdate(TIndex lane, const PTValueResult& result);
+
+  /// @brief The closest T of each lane. If not hit, the value is max value of float.
+  alignas(32) std::array<float, DRayPacket::kMaxWidth> mT;
+  std::array<std::optional<PTValueResult>, DRayPacket::kMaxWidth> mResults;
+};
+
+/// @class DTrianglePacketHits
+/// @brief Closest triangle intersection results of ray packet in mesh's local space.
+class DTrianglePacketHits final
+{
+public:
+  /// @brief The closest T of each lane. Lanes that are not hit keep initial value.
+  alignas(32) std::array<float, DRayPacket::kMaxWidth> mT;
+  /// @brief Index of the closest triangle in mesh of each lane.
+  std::array<TU32, DRayPacket::kMaxWidth> mTriangle;
+  /// @brief Bit mask of lanes that is hit.
+  TU32 mHitMask = 0;
+};
+
+template <typename TMatrix>
+DRayPacket DRayPacket::GetTransformedOf(const TMatrix& matWorldToLocal, const DVec3& origin, TReal scale) const
+{
+  DRayPacket result{this->mWidth};
+  for (TIndex lane = 0; lane < this->mWidth; ++lane)
+  {
+    const auto& ray = this->mRays[lane];
+    result.SetRay(lane, DRay
+    {
+      (matWorldToLocal * (ray.GetOrigin() - origin)) / scale,
+      matWorldToLocal * ray.GetDirection()
+    });
+  }
+  return result;
+}
+
+} /// ::ray namespace
@@ -0,0 +1,294 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <XCommon.hpp>
+
+/// MSVC does not define `__SSE4_1__`, but `/arch:AVX` and upper implies SSE4.1.
+#if defined(__SSE4_1__) || defined(__AVX__)
+  #include <immintrin.h>
+#endif
+
+/// @def SH_RAY_SIMD_ISA_NAMESPACE
+/// @brief Inline namespace name of lane types, following instruction set of translation unit.
+/// Kernels are compiled once per instruction set, so each build of lane types must have distinct symbols.
+#if defined(__AVX512F__)
+  #define SH_RAY_SIMD_ISA_NAMESPACE isa_avx512
+#elif defined(__AVX2__)
+  #define SH_RAY_SIMD_ISA_NAMESPACE isa_avx2
+#elif defined(__SSE4_1__) || defined(__AVX__)
+  #define SH_RAY_SIMD_ISA_NAMESPACE isa_sse41
+#else
+  #define SH_RAY_SIMD_ISA_NAMESPACE isa_generic
+#endif
+
+namespace ray::simd
+{
+inline namespace SH_RAY_SIMD_ISA_NAMESPACE
+{
+
+/// @class DSimdFloat
+/// @brief Fixed-width float lane type.
+/// Comparison results are lane masks (all bits set or cleared), and can be combined with `&`, `|`.
+/// This generic type is used when instruction set for given width is not enabled on compile time.
+template <TIndex TWidth>
+class DSimdFloat final
+{
+public:
+  static constexpr TIndex kWidth = TWidth;
+
+  DSimdFloat() = default;
+  explicit DSimdFloat(float value) { this->mValue.fill(value); }
+
+  /// @brief Load `TWidth` floats from given aligned pointer.
+  static DSimdFloat Load(const float* pValue)
+  {
+    DSimdFloat result;
+    std::memcpy(result.mValue.data(), pValue, sizeof(float) * TWidth);
+    return result;
+  }
+  /// @brief Store `TWidth` floats into given aligned pointer.
+  void Store(float* pValue) const
+  {
+    std::memcpy(pValue, this->mValue.data(), sizeof(float) * TWidth);
+  }
+  /// @brief Load and store `TWidth` floats with pointer that may not be aligned.
+  static DSimdFloat LoadUnaligned(const float* pValue) { return Load(pValue); }
+  void StoreUnaligned(float* pValue) const { this->Store(pValue); }
+
+  /// @brief Get bit mask that i-th bit is set when i-th lane's mask is set.
+  TU32 GetMask() const noexcept
+  {
+    TU32 mask = 0;
+    for (TIndex i = 0; i < TWidth; ++i) { mask |= (GetBits(this->mValue[i]) >> 31) << i; }
+    return mask;
+  }
+
+  /// @brief Get lane mask from given bit mask.
+  static DSimdFloat FromMask(TU32 mask)
+  {
+    DSimdFloat result;
+    for (TIndex i = 0; i < TWidth; ++i) { result.mValue[i] = FromBits(((mask >> i) & 1) ? ~0u : 0u); }
+    return result;
+  }
+
+  /// @brief Select `lhs` lane when `mask` lane is set. Otherwise, select `rhs` lane.
+  static DSimdFloat Select(const DSimdFloat& mask, const DSimdFloat& lhs, const DSimdFloat& rhs)
+  {
+    DSimdFloat result;
+    for (TIndex i = 0; i < TWidth; ++i)
+    {
+      result.mValue[i] = (GetBits(mask.mValue[i]) >> 31) ? lhs.mValue[i] : rhs.mValue[i];
+    }
+    return result;
+  }
+
+  /// @brief Same to SSE semantics, return `rhs` lane when any of lanes is NaN.
+  static DSimdFloat Min(const DSimdFloat& lhs, const DSimdFloat& rhs)
+  {
+    return Apply(lhs, rhs, [](float l, float r) { return l < r ? l : r; });
+  }
+  static DSimdFloat Max(const DSimdFloat& lhs, const DSimdFloat& rhs)
+  {
+    return Apply(lhs, rhs, [](float l, float r) { return l > r ? l : r; });
+  }
+  static DSimdFloat Sqrt(const DSimdFloat& value)
+  {
+    DSimdFloat result;
+    for (TIndex i = 0; i < TWidth; ++i) { result.mValue[i] = std::sqrt(value.mValue[i]); }
+    return result;
+  }
+
+  friend DSimdFloat operator+(const DSimdFloat& l, const DSimdFloat& r) { return Apply(l, r, std::plus<float>{}); }
+  friend DSimdFloat operator-(const DSimdFloat& l, const DSimdFloat& r) { return Apply(l, r, std::minus<float>{}); }
+  friend DSimdFloat operator*(const DSimdFloat& l, const DSimdFloat& r) { return Apply(l, r, std::multiplies<float>{}); }
+  friend DSimdFloat operator/(const DSimdFloat& l, const DSimdFloat& r) { return Apply(l, r, std::divides<float>{}); }
+
+  friend DSimdFloat operator<(const DSimdFloat& l, const DSimdFloat& r) { return Compare(l, r, std::less<float>{}); }
+  friend DSimdFloat operator<=(const DSimdFloat& l, const DSimdFloat& r) { return Compare(l, r, std::less_equal<float>{}); }
+  friend DSimdFloat operator>(const DSimdFloat& l, const DSimdFloat& r) { return Compare(l, r, std::greater<float>{}); }
+  friend DSimdFloat operator>=(const DSimdFloat& l, const DSimdFloat& r) { return Compare(l, r, std::greater_equal<float>{}); }
+
+  friend DSimdFloat operator&(const DSimdFloat& l, const DSimdFloat& r) { return Bitwise(l, r, std::bit_and<TU32>{}); }
+  friend DSimdFloat operator|(const DSimdFloat& l, const DSimdFloat& r) { return Bitwise(l, r, std::bit_or<TU32>{}); }
+
+  float operator[](TIndex i) const noexcept { return this->mValue[i]; }
+
+private:
+  static TU32 GetBits(float value) noexcept { TU32 bits; std::memcpy(&bits, &value, sizeof(TU32)); return bits; }
+  static float FromBits(TU32 bits) noexcept { float value; std::memcpy(&value, &bits, sizeof(TU32)); return value; }
+
+  template <typename TFunc>
+  static DSimdFloat Apply(const DSimdFloat& l, const DSimdFloat& r, TFunc&& func)
+  {
+    DSimdFloat result;
+    for (TIndex i = 0; i < TWidth; ++i) { result.mValue[i] = func(l.mValue[i], r.mValue[i]); }
+    return result;
+  }
+  template <typename TFunc>
+  static DSimdFloat Compare(const DSimdFloat& l, const DSimdFloat& r, TFunc&& func)
+  {
+    DSimdFloat result;
+    for (TIndex i = 0; i < TWidth; ++i) { result.mValue[i] = FromBits(func(l.mValue[i], r.mValue[i]) ? ~0u : 0u); }
+    return result;
+  }
+  template <typename TFunc>
+  static DSimdFloat Bitwise(const DSimdFloat& l, const DSimdFloat& r, TFunc&& func)
+  {
+    DSimdFloat result;
+    for (TIndex i = 0; i < TWidth; ++i) { result.mValue[i] = FromBits(func(GetBits(l.mValue[i]), GetBits(r.mValue[i]))); }
+    return result;
+  }
+
+  std::array<float, TWidth> mValue;
+};
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+/// @class DSimdFloat<4>
+/// @brief 4-wide float lane type with SSE4.1 instructions.
+template <>
+class DSimdFloat<4> final
+{
+public:
+  static constexpr TIndex kWidth = 4;
+
+  DSimdFloat() = default;
+  explicit DSimdFloat(float value) : mValue { _mm_set1_ps(value) } { }
+  DSimdFloat(__m128 value) : mValue { value } { }
+
+  static DSimdFloat Load(const float* pValue) { return _mm_load_ps(pValue); }
+  void Store(float* pValue) const { _mm_store_ps(pValue, this->mValue); }
+  static DSimdFloat LoadUnaligned(const float* pValue) { return _mm_loadu_ps(pValue); }
+  void StoreUnaligned(float* pValue) const { _mm_storeu_ps(pValue, this->mValue); }
+
+  TU32 GetMask() const noexcept { return TU32(_mm_movemask_ps(this->mValue)); }
+  static DSimdFloat FromMask(TU32 mask)
+  {
+    const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128i test = _mm_and_si128(_mm_set1_epi32(int(mask)), bits);
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(test, bits));
+  }
+  static DSimdFloat Select(const DSimdFloat& mask, const DSimdFloat& lhs, const DSimdFloat& rhs)
+  {
+    return _mm_blendv_ps(rhs.mValue, lhs.mValue, mask.mValue);
+  }
+
+  static DSimdFloat Min(const DSimdFloat& l, const DSimdFloat& r) { return _mm_min_ps(l.mValue, r.mValue); }
+  static DSimdFloat Max(const DSimdFloat& l, const DSimdFloat& r) { return _mm_max_ps(l.mValue, r.mValue); }
+  static DSimdFloat Sqrt(const DSimdFloat& value) { return _mm_sqrt_ps(value.mValue); }
+
+  friend DSimdFloat operator+(const DSimdFloat& l, const DSimdFloat& r) { return _mm_add_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator-(const DSimdFloat& l, const DSimdFloat& r) { return _mm_sub_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator*(const DSimdFloat& l, const DSimdFloat& r) { return _mm_mul_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator/(const DSimdFloat& l, const DSimdFloat& r) { return _mm_div_ps(l.mValue, r.mValue); }
+
+  friend DSimdFloat operator<(const DSimdFloat& l, const DSimdFloat& r) { return _mm_cmplt_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator<=(const DSimdFloat& l, const DSimdFloat& r) { return _mm_cmple_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator>(const DSimdFloat& l, const DSimdFloat& r) { return _mm_cmpgt_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator>=(const DSimdFloat& l, const DSimdFloat& r) { return _mm_cmpge_ps(l.mValue, r.mValue); }
+
+  friend DSimdFloat operator&(const DSimdFloat& l, const DSimdFloat& r) { return _mm_and_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator|(const DSimdFloat& l, const DSimdFloat& r) { return _mm_or_ps(l.mValue, r.mValue); }
+
+  float operator[](TIndex i) const noexcept
+  {
+    alignas(16) float values[4];
+    _mm_store_ps(values, this->mValue);
+    return values[i];
+  }
+
+private:
+  __m128 mValue;
+};
+#endif /// #if defined(__SSE4_1__) || defined(__AVX__)
+
+#if defined(__AVX2__)
+/// @class DSimdFloat<8>
+/// @brief 8-wide float lane type with AVX2 instructions.
+template <>
+class DSimdFloat<8> final
+{
+public:
+  static constexpr TIndex kWidth = 8;
+
+  DSimdFloat() = default;
+  explicit DSimdFloat(float value) : mValue { _mm256_set1_ps(value) } { }
+  DSimdFloat(__m256 value) : mValue { value } { }
+
+  static DSimdFloat Load(const float* pValue) { return _mm256_load_ps(pValue); }
+  void Store(float* pValue) const { _mm256_store_ps(pValue, this->mValue); }
+  static DSimdFloat LoadUnaligned(const float* pValue) { return _mm256_loadu_ps(pValue); }
+  void StoreUnaligned(float* pValue) const { _mm256_storeu_ps(pValue, this->mValue); }
+
+  TU32 GetMask() const noexcept { return TU32(_mm256_movemask_ps(this->mValue)); }
+  static DSimdFloat FromMask(TU32 mask)
+  {
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i test = _mm256_and_si256(_mm256_set1_epi32(int(mask)), bits);
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(test, bits));
+  }
+  static DSimdFloat Select(const DSimdFloat& mask, const DSimdFloat& lhs, const DSimdFloat& rhs)
+  {
+    return _mm256_blendv_ps(rhs.mValue, lhs.mValue, mask.mValue);
+  }
+
+  static DSimdFloat Min(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_min_ps(l.mValue, r.mValue); }
+  static DSimdFloat Max(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_max_ps(l.mValue, r.mValue); }
+  static DSimdFloat Sqrt(const DSimdFloat& value) { return _mm256_sqrt_ps(value.mValue); }
+
+  friend DSimdFloat operator+(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_add_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator-(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_sub_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator*(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_mul_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator/(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_div_ps(l.mValue, r.mValue); }
+
+  friend DSimdFloat operator<(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_cmp_ps(l.mValue, r.mValue, _CMP_LT_OQ); }
+  friend DSimdFloat operator<=(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_cmp_ps(l.mValue, r.mValue, _CMP_LE_OQ); }
+  friend DSimdFloat operator>(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_cmp_ps(l.mValue, r.mValue, _CMP_GT_OQ); }
+  friend DSimdFloat operator>=(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_cmp_ps(l.mValue, r.mValue, _CMP_GE_OQ); }
+
+  friend DSimdFloat operator&(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_and_ps(l.mValue, r.mValue); }
+  friend DSimdFloat operator|(const DSimdFloat& l, const DSimdFloat& r) { return _mm256_or_ps(l.mValue, r.mValue); }
+
+  float operator[](TIndex i) const noexcept
+  {
+    alignas(32) float values[8];
+    _mm256_store_ps(values, this->mValue);
+    return values[i];
+  }
+
+private:
+  __m256 mValue;
+};
+#endif /// #if defined(__AVX2__)
+
+/// @brief Check given width is accelerated by SIMD instructions on this build.
+template <TIndex TWidth>
+constexpr bool IsAccelerated() noexcept
+{
+#if defined(__SSE4_1__) || defined(__AVX__)
+  if constexpr (TWidth == 4) { return true; }
+#endif
+#if defined(__AVX2__)
+  if constexpr (TWidth == 8) { return true; }
+#endif
+  return false;
+}
+
+} /// ::ray::simd::SH_RAY_SIMD_ISA_NAMESPACE namespace
+} /// ::ray::simd namespace
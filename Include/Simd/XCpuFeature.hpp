@@ -0,0 +1,51 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <XCommon.hpp>
+
+namespace ray::simd
+{
+
+/// @enum ESimdLevel
+/// @brief Instruction set level that SIMD kernels are compiled for.
+enum class ESimdLevel
+{
+  Scalar,
+  SSE41,
+  AVX2,
+  AVX512,
+};
+
+/// @struct PCpuFeatures
+/// @brief CPU features that are detected with CPUID, and supported by OS.
+struct PCpuFeatures final
+{
+  bool mSSE41     = false;
+  bool mAVX       = false;
+  bool mAVX2      = false;
+  bool mFMA       = false;
+  bool mAVX512F   = false;
+  bool mAVX512VL  = false;
+};
+
+/// @brief Get CPU features of running machine. Features are detected once on first call.
+const PCpuFeatures& GetCpuFeatures() noexcept;
+
+/// @brief Get the highest kernel level that running machine supports.
+ESimdLevel GetSupportedSimdLevel() noexcept;
+
+/// @brief Get display name of given level.
+const char* GetSimdLevelName(ESimdLevel level) noexcept;
+
+} /// ::ray::simd namespace
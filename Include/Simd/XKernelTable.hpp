@@ -0,0 +1,88 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <XCommon.hpp>
+#include <Simd/XCpuFeature.hpp>
+#include <Image/XToneMap.hpp>
+
+namespace ray::simd
+{
+
+/// @struct PPacketLanes
+/// @brief Raw SoA view of ray packet that is passed into kernels.
+struct PPacketLanes final
+{
+  const float* mOrigin[3];
+  const float* mDirection[3];
+  const float* mInvDirection[3];
+  TIndex mWidth;
+};
+
+/// @struct PTriangleLanes
+/// @brief Raw SoA view of triangle block that is passed into kernels.
+struct PTriangleLanes final
+{
+  const float* mV0[3];
+  const float* mEdge1[3];
+  const float* mEdge2[3];
+  TIndex mCount;
+};
+
+/// @struct PKernelTable
+/// @brief Hot SIMD kernels that are compiled for one instruction set level.
+/// Kernels only take raw floats and pointers, so ISA-specific translation units do not instantiate
+/// inline functions of other types that could be shared with baseline code by linker.
+/// For the same reason, this type has no default member initializer. (Trivial constructor)
+/// See `XPacketKernel.hpp` for meaning of each kernel.
+struct PKernelTable final
+{
+  ESimdLevel mLevel;
+  /// @brief Whether 4-wide and 8-wide lanes are mapped into SIMD registers in this level.
+  bool mIsAccelerated4;
+  bool mIsAccelerated8;
+
+  TU32 (*mIntersectPacketAABB)(
+    const PPacketLanes& packet, const float* min, const float* max, 
+    TU32 activeMask, const float* tMax);
+  TU32 (*mIntersectPacketTriangle)(
+    const PPacketLanes& packet, const float* v0, const float* edge1, const float* edge2, 
+    TU32 activeMask, float* ioT);
+  TU32 (*mIntersectRayBoxes)(
+    const float* origin, const float* invDirection, 
+    const float* const* min, const float* const* max,
+    TIndex width, float tMax, float* oTNear);
+  TU32 (*mIntersectRayTriangles)(
+    const float* origin, const float* direction, 
+    const PTriangleLanes& triangles, float tMax, float* oT);
+
+  /// @brief Scale interleaved radiance sums, apply tone map operator and clamp values into [0, 1].
+  /// Fourth root of each value is returned, as domain of transfer table. (See `DToneMapper`)
+  /// NaN and negative radiance become 0. Buffers do not need to be aligned.
+  void (*mToneMapValues)(
+    const float* pSums, const float* pScales, TIndex count, 
+    EToneMapOperator toneOperator, float* oRoots);
+};
+
+/// @brief Get kernel table of each instruction set level.
+/// Calling kernels of level that running machine does not support will crash.
+const PKernelTable& GetScalarKernelTable() noexcept;
+const PKernelTable& GetSse41KernelTable() noexcept;
+const PKernelTable& GetAvx2KernelTable() noexcept;
+const PKernelTable& GetAvx512KernelTable() noexcept;
+
+/// @brief Get kernel table of the highest level that running machine supports.
+/// Table is selected once on first call with CPUID.
+const PKernelTable& GetKernelTable() noexcept;
+
+} /// ::ray::simd namespace
@@ -0,0 +1,86 @@
+#pragma once
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <XCommon.hpp>
+#include <Simd/DRayPacket.hpp>
+#include <KDTree/DTriangleBlock.hpp>
+
+namespace ray::simd
+{
+
+/// Kernels below are dispatched into kernel table of the highest instruction set level
+/// that running machine supports. (See `XKernelTable.hpp`)
+
+/// @brief Test active lanes of packet against AABB with slab method.
+/// @param packet Ray packet that is in the same space of AABB.
+/// @param aabb AABB to test.
+/// @param activeMask Bit mask of lanes to test.
+/// @param tMax The closest T of each lane. Lanes that enter AABB farther than it are culled.
+/// @return Bit mask of lanes that intersect AABB.
+TU32 IntersectPacketAABB(const DRayPacket& packet, const DAABB& aabb, TU32 activeMask, const float* tMax);
+
+/// @brief Test active lanes of packet against triangle with Möller–Trumbore intersection algorithm.
+/// Lanes that hit triangle closer than `ioT` (and farther than 0) are updated.
+/// @param packet Ray packet that is in the same space of triangle.
+/// @param activeMask Bit mask of lanes to test.
+/// @param ioT The closest T of each lane.
+/// @return Bit mask of lanes that are updated.
+TU32 IntersectPacketTriangle(
+  const DRayPacket& packet,
+  const DVec3& v0, const DVec3& v1, const DVec3& v2,
+  TU32 activeMask, float* ioT);
+
+/// @brief Test active lanes of packet against one triangle lane of triangle block.
+/// Same as above, but precomputed v0 and edges of block are used.
+/// @param block Triangle block that is in the same space of packet.
+/// @param triangleLane Lane of triangle in block to test.
+TU32 IntersectPacketTriangle(
+  const DRayPacket& packet,
+  const DTriangleBlock& block, TIndex triangleLane,
+  TU32 activeMask, float* ioT);
+
+/// @brief Test single ray against SoA child bounds of wide tree node with slab method.
+/// @param origin Origin of ray.
+/// @param invDirection Inverted direction of ray.
+/// @param min Minimum point of each child bounds, per axis.
+/// @param max Maximum point of each child bounds, per axis.
+/// @param width The count of lanes to test. Must be 4 or 8.
+/// @param tMax The closest T of ray. Children that ray enters farther than it are culled.
+/// @param oTNear Entering T of each child.
+/// @return Bit mask of children that intersect ray.
+TU32 IntersectRayBoxes(
+  const float* origin, const float* invDirection,
+  const std::array<float, DRayPacket::kMaxWidth>* min, const std::array<float, DRayPacket::kMaxWidth>* max,
+  TIndex width, float tMax, float* oTNear);
+
+/// @brief Test single ray against all triangles of SoA triangle block with Möller–Trumbore intersection algorithm.
+/// One 8-wide pass is used when selected kernel level has 8-wide registers. Otherwise two 4-wide passes are used.
+/// @param origin Origin of ray in local mesh space.
+/// @param direction Direction of ray in local mesh space.
+/// @param block Triangle block to test.
+/// @param tMax Lanes that hit farther than or equal to it are discarded.
+/// @param oT T value of each lane. Only hit lanes are valid.
+/// @return Bit mask of lanes that hit triangle in range of (0, tMax).
+TU32 IntersectRayTriangles(
+  const float* origin, const float* direction,
+  const DTriangleBlock& block, float tMax, float* oT);
+
+/// @brief Check active lanes of packet are too few to be traversed as packet.
+/// If returned true, caller should fall back into single ray traversal for each active lane.
+bool IsPacketDiverged(const DRayPacket& packet, TU32 activeMask) noexcept;
+
+/// @brief Get the count of set bits of given mask.
+TU32 GetLaneCount(TU32 mask) noexcept;
+
+} /// ::ray::simd namespace
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include <Math/Type/Micellanous/DDynamicGrid2D.h>
 #include <Math/Type/Micellanous/DClamp.h>
 #include <Math/Type/Micellanous/DBounds3D.h>
+#include <Math/Type/Micellanous/DUuid.h>
 #include <Expr/FCmdArguments.h>
 #include <Expr/ESuccess.h>
 
@@ -36,6 +37,9 @@ using TReal = ::dy::math::TReal;
 using TI32 = ::dy::math::TI32;
 using TI64 = ::dy::math::TI64;
 using TU32 = ::dy::math::TU32;
+using TU64 = ::dy::math::TU64;
+using TU8 = ::dy::math::TU8;
+using TU16 = ::dy::math::TU16;
 using TIndex = ::dy::math::TIndex;
 
 using DVec3 = ::dy::math::DVector3<TReal>;
@@ -72,13 +76,12 @@ void PrintHelp(const ::dy::expr::FCmdArguments& manager);
 /// @param manager Command Argument Manager Reference.
 void PrintOverallInformation(const ::dy::expr::FCmdArguments& manager);
 
-/// @brief Create image ppm with grid2d container.
-/// @return If successful, return true. Otherwise, return false.
-bool CreateImagePpm(const char* const path, DDynamicGrid2D<DIVec3>& container);
+/// @brief Print detected CPU features and selected SIMD kernel level. (`--cpu-report`)
+void PrintCpuReport();
 
-/// @brief Create image png with grid2d container.
-/// @return If successful, return true. Otherwise, return false.
-bool CreateImagePng(const char* const path, const DDynamicGrid2D<DIVec3>& container);
+/// @brief Create new random uuid.
+/// Thread-safety of `DUuid{true}` is not guaranteed, so creation is serialized and can be called from parallel loops.
+::dy::math::DUuid CreateUuid();
 
 } /// ::ray namespace
 
@@ -15,42 +15,396 @@
 #include <Manager/MScene.hpp>
 #include <XCommon.hpp>
 #include <Object/FCamera.hpp>
+#include <Simd/DRayPacket.hpp>
+#include <Image/DFrameBuffer.hpp>
+#include <Image/DAuxBuffers.hpp>
+#include <Helper/XHelperRandom.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief Depth limit of ray proceeding.
+constexpr TIndex kRayDepthLimit = 32;
+/// @brief The maximum count of primary rays to be processed in one binning tile.
+constexpr TIndex kTileRayCount = 1 << 16;
+/// @brief The count of origin cell levels per axis. Must be power of 2 and less than or equal to 8.
+constexpr TU32 kOriginCellLevel = 8;
+
+/// @struct PPrimaryRay
+/// @brief Primary ray item that is created from camera, waiting for being traced.
+struct PPrimaryRay final
+{
+  DRay  mRay;
+  TU32  mPixel;
+  TU32  mPixelKey;
+  /// @brief The first sample of ray. If first hit is shared by repeats, 
+  /// next samples are `mSample + k * offset count` for k < mRepeatCount.
+  TU32  mSample;
+  TU32  mRepeatCount;
+};
+
+/// @struct PSecondaryRay
+/// @brief Secondary ray item that is bounced from first hit surface, waiting for being traced.
+struct PSecondaryRay final
+{
+  DRay  mRay;
+  DVec3 mThroughput;
+  std::uint64_t mRandomState;
+  TU32  mPixel;
+  TU32  mBinKey;
+};
+
+/// @brief Accumulate radiance sum of given pixel index into frame buffer.
+/// Pixel index of camera is flipped into output image order, and moved into tile space of frame buffer.
+void AccumulateSamples(
+  DFrameBuffer& frameBuffer, const DUVec2& imgSize, const DUVec2& index, 
+  const DVec3& radianceSum, TU32 sampleCount)
+{
+  assert(index.Y > 0);
+  const auto& origin = frameBuffer.GetOrigin();
+  frameBuffer.AddSamples(imgSize.X - index.X - 1 - origin.X, index.Y - 1 - origin.Y, radianceSum, sampleCount);
+}
+
+/// @brief Get unique random key of given camera pixel index.
+TU32 GetPixelKeyOf(const DUVec2& imgSize, const DUVec2& index)
+{
+  return index.Y * imgSize.X + index.X;
+}
+
+/// @brief Accumulate first-hit feature sums of given pixel index into auxiliary buffers.
+/// Pixel index is moved just like `AccumulateSamples`.
+void AccumulateFeatures(
+  DAuxBuffers& auxBuffers, const DUVec2& imgSize, const DUVec2& index, 
+  const DVec3& albedoSum, const DVec3& normalSum, TReal depthSum, TU32 sampleCount)
+{
+  assert(index.Y > 0);
+  const auto& origin = auxBuffers.GetAlbedo().GetOrigin();
+  auxBuffers.AddSamples(
+    imgSize.X - index.X - 1 - origin.X, index.Y - 1 - origin.Y, 
+    albedoSum, normalSum, depthSum, sampleCount);
+}
+
+/// @brief Spread lower 3 bits of given value to every 3rd bit. (Morton code)
+TU32 SpreadBits3(TU32 value)
+{
+  TU32 result = 0;
+  for (TU32 i = 0; i < 3; ++i) { result |= ((value >> i) & 1) << (i * 3); }
+  return result;
+}
+
+/// @brief Get bin key of secondary ray from direction octant and coarse origin cell.
+/// @param ray Secondary ray in world-space.
+/// @param min Minimum point of origin bounds of tile.
+/// @param invExtent Inverted extent of origin bounds of tile.
+TU32 GetBinKeyOf(const DRay& ray, const DVec3& min, const DVec3& invExtent)
+{
+  const auto& dir = ray.GetDirection();
+  const TU32 octant = TU32(dir.X < 0) | (TU32(dir.Y < 0) << 1) | (TU32(dir.Z < 0) << 2);
+
+  TU32 morton = 0;
+  for (TU32 axis = 0; axis < 3; ++axis)
+  {
+    const auto normalized = (ray.GetOrigin()[axis] - min[axis]) * invExtent[axis];
+    const auto cell = std::min(TU32(normalized * kOriginCellLevel), kOriginCellLevel - 1);
+    morton |= SpreadBits3(cell) << axis;
+  }
+
+  return (octant << 9) | morton;
+}
+
+} /// anonymous namespace
 
 namespace ray
 {
 
+FRenderWorker::FRenderWorker(const PCtor& ctor)
+  : mIsBinningSecondaryRays { ctor.mIsBinningSecondaryRays },
+    mPacketWidth { ctor.mPacketWidth },
+    mSampleStart { ctor.mSampleStart },
+    mSampleCount { ctor.mSampleCount },
+    mIsCachingFirstHits { ctor.mIsCachingFirstHits }
+{ 
+  assert(this->mPacketWidth == 0 || this->mPacketWidth == 4 || this->mPacketWidth == 8);
+}
+
 void FRenderWorker::Execute(
   const FCamera& cam,
   const std::vector<DUVec2>& list, 
   const DUVec2 imgSize, 
-  DDynamicGrid2D<DIVec3>& container)
+  DFrameBuffer& frameBuffer,
+  DAuxBuffers* pAuxBuffers)
 {
+  // Worker is executed on its own thread, so thread statistics only has values of this call.
+  GetThreadTraversalStats() = PTraversalStats{};
+
+  // Features need first hits that are resolved apart from bounces, as tiled path does.
+  if (this->mIsBinningSecondaryRays == true || this->mPacketWidth != 0 || pAuxBuffers != nullptr)
+  {
+    this->ExecuteTiled(cam, list, imgSize, frameBuffer, pAuxBuffers);
+    this->mTraversalStats = GetThreadTraversalStats();
+    return;
+  }
+
+  auto& scene = EXPR_SGT(MScene);
+  const auto offsetCount = cam.GetSampleOffsetCount();
+  const auto [sampleStart, sampleEnd] = this->GetSampleRangeOf(cam);
+  const bool isCaching = this->IsCachingFirstHits(cam, sampleEnd - sampleStart);
+
+  std::vector<std::optional<PTValueResult>> firstHits;
+  std::vector<DRay> firstRays;
   for (const auto& index : list)
   {
-    const auto rayList  = cam.CreateRay(index.X, index.Y - 1);
-    const auto repeat   = cam.GetRepeat();
+    const auto pixelKey = GetPixelKeyOf(imgSize, index);
 
     DVec3 colorSum = {0};
-    for (TU32 r = 0; r < repeat; ++r)
+    if (isCaching == true)
     {
-      for (const auto& ray : rayList) 
-      { 
-        colorSum += EXPR_SGT(MScene).ProceedRay(ray, 0, 32);
+      // Primary ray of each offset is traced once, and only bounces are traced on each repeat.
+      firstHits.clear();
+      firstRays.clear();
+      for (TIndex s = sampleStart; s < sampleEnd; ++s)
+      {
+        const auto offset = s % offsetCount;
+        if (s - sampleStart < offsetCount)
+        {
+          firstRays.emplace_back(cam.CreateSampleRay(index.X, index.Y - 1, offset));
+          firstHits.emplace_back(scene.GetClosestIntersection(firstRays.back()));
+        }
+        else
+        {
+          GetThreadTraversalStats().mReusedHitCount += 1;
+        }
+
+        const auto cached = (s - sampleStart) % offsetCount;
+        random::SeedThreadStream(pixelKey, TU32(s), random::ESampleStage::Path);
+        colorSum += this->TraceFromFirstHit(firstRays[cached], firstHits[cached]);
+      }
+      AccumulateSamples(frameBuffer, imgSize, index, colorSum, TU32(sampleEnd - sampleStart));
+      continue;
+    }
+
+    for (TIndex s = sampleStart; s < sampleEnd; ++s)
+    {
+      // Each stage of sample is seeded by itself, so result does not depend on which worker renders it.
+      random::SeedThreadStream(pixelKey, TU32(s), random::ESampleStage::Camera);
+      const auto ray = cam.CreateSampleRay(index.X, index.Y - 1, s % offsetCount);
+      random::SeedThreadStream(pixelKey, TU32(s), random::ESampleStage::Path);
+      colorSum += EXPR_SGT(MScene).ProceedRay(ray, 0, kRayDepthLimit);
+    }
+    AccumulateSamples(frameBuffer, imgSize, index, colorSum, TU32(sampleEnd - sampleStart));
+  }
+
+  this->mTraversalStats = GetThreadTraversalStats();
+}
+
+const PTraversalStats& FRenderWorker::GetTraversalStats() const noexcept
+{
+  return this->mTraversalStats;
+}
+
+bool FRenderWorker::IsCachingFirstHits(const FCamera& cam, TIndex sampleCount) const noexcept
+{
+  // Without depth of field, primary ray only depends on sub-pixel offset, not on sample.
+  return this->mIsCachingFirstHits == true 
+      && cam.IsUsingDepthOfField() == false 
+      && sampleCount > cam.GetSampleOffsetCount();
+}
+
+DVec3 FRenderWorker::TraceFromFirstHit(const DRay& ray, const std::optional<PTValueResult>& optHit) const
+{
+  // The same as `MScene::ProceedRay` from depth 0, except first hit is already resolved.
+  auto& scene = EXPR_SGT(MScene);
+  if (optHit.has_value() == false) { return scene.GetBackgroundColor(ray); }
+
+  const auto& [t, type, pObj, normal] = *optHit;
+  const auto optResult = pObj->TryScatter(ray, t, normal);
+  const auto& [refDir, attCol, isScattered] = *optResult;
+  if (isScattered == false) { return DVec3{0}; }
+
+  return attCol * scene.ProceedRay(DRay{ray.GetPointAtParam(t), refDir}, 1, kRayDepthLimit);
+}
+
+std::pair<TIndex, TIndex> FRenderWorker::GetSampleRangeOf(const FCamera& cam) const noexcept
+{
+  const auto sampleTotal = cam.GetSampleOffsetCount() * cam.GetRepeat();
+  if (this->mSampleCount == 0) { return {std::min(this->mSampleStart, sampleTotal), sampleTotal}; }
+  return {this->mSampleStart, this->mSampleStart + this->mSampleCount};
+}
+
+void FRenderWorker::ExecuteTiled(
+  const FCamera& cam,
+  const std::vector<DUVec2>& list, 
+  const DUVec2 imgSize, 
+  DFrameBuffer& frameBuffer,
+  DAuxBuffers* pAuxBuffers)
+{
+  auto& scene = EXPR_SGT(MScene);
+  const auto offsetCount = cam.GetSampleOffsetCount();
+  const auto [sampleStart, sampleEnd] = this->GetSampleRangeOf(cam);
+  const bool isCaching = this->IsCachingFirstHits(cam, sampleEnd - sampleStart);
+
+  // Get pixel count of each tile, that bounds the count of rays in flight.
+  const auto raysPerPixel = std::max<TIndex>(sampleEnd - sampleStart, 1);
+  const auto tileSize = std::max<TIndex>(kTileRayCount / raysPerPixel, 1);
+
+  std::vector<DVec3> colorSums;
+  std::vector<TIndex> sampleCounts;
+  std::vector<DVec3> albedoSums;
+  std::vector<DVec3> normalSums;
+  std::vector<TReal> depthSums;
+  std::vector<PPrimaryRay> primaryRays;
+  std::vector<PSecondaryRay> secondaryRays;
+  std::vector<PSecondaryRay> sortedRays;
+  std::vector<TU32> binOffsets;
+
+  for (TIndex tileStart = 0, size = list.size(); tileStart < size; tileStart += tileSize)
+  {
+    const auto tileEnd = std::min(tileStart + tileSize, size);
+    colorSums.assign(tileEnd - tileStart, DVec3{0});
+    sampleCounts.assign(tileEnd - tileStart, 0);
+    if (pAuxBuffers != nullptr)
+    {
+      albedoSums.assign(tileEnd - tileStart, DVec3{0});
+      normalSums.assign(tileEnd - tileStart, DVec3{0});
+      depthSums.assign(tileEnd - tileStart, TReal(0));
+    }
+    primaryRays.clear();
+    secondaryRays.clear();
+
+    // First, collect primary rays of tile. Rays of neighbor pixels are adjacent, so packets are coherent.
+    for (TIndex i = tileStart; i < tileEnd; ++i)
+    {
+      const auto pixel = TU32(i - tileStart);
+      const auto pixelKey = GetPixelKeyOf(imgSize, list[i]);
+      sampleCounts[pixel] = sampleEnd - sampleStart;
+
+      // If first hits are cached, only one primary ray of each offset is traced, and is shaded for all repeats.
+      const auto primaryEnd = isCaching == true ? sampleStart + offsetCount : sampleEnd;
+      for (TIndex s = sampleStart; s < primaryEnd; ++s)
+      {
+        const auto repeatCount = isCaching == true ? (sampleEnd - s + offsetCount - 1) / offsetCount : 1;
+        random::SeedThreadStream(pixelKey, TU32(s), random::ESampleStage::Camera);
+        const auto ray = cam.CreateSampleRay(list[i].X, list[i].Y - 1, s % offsetCount);
+        primaryRays.push_back({ray, pixel, pixelKey, TU32(s), TU32(repeatCount)});
+        GetThreadTraversalStats().mReusedHitCount += repeatCount - 1;
+      }
+    }
+
+    // Second, trace primary rays and collect bounced secondary rays.
+    const auto ShadeFirstHit = [&](const PPrimaryRay& item, const std::optional<PTValueResult>& optHit)
+    {
+      const auto& [ray, pixel, pixelKey, sample, repeatCount] = item;
+      if (optHit.has_value() == false)
+      {
+        const auto background = scene.GetBackgroundColor(ray) * TReal(repeatCount);
+        colorSums[pixel] += background;
+        if (pAuxBuffers != nullptr) { albedoSums[pixel] += background; }
+        return;
+      }
+
+      // Path stage is seeded just like single ray path, so bounced rays are the same as non-tiled rendering.
+      const auto& [t, type, pObj, normal] = *optHit;
+      if (pAuxBuffers != nullptr)
+      {
+        const auto* pMaterial = pObj->GetMaterial();
+        const auto weight = TReal(repeatCount);
+        albedoSums[pixel] += (pMaterial != nullptr ? pMaterial->GetAlbedo() : DVec3{0}) * weight;
+        normalSums[pixel] += normal * weight;
+        depthSums[pixel] += (ray.GetPointAtParam(t) - ray.GetOrigin()).GetLength() * weight;
       }
+      for (TU32 k = 0; k < repeatCount; ++k)
+      {
+        random::SeedThreadStream(pixelKey, sample + k * TU32(offsetCount), random::ESampleStage::Path);
+        const auto optResult = pObj->TryScatter(ray, t, normal);
+        const auto& [refDir, attCol, isScattered] = *optResult;
+        if (isScattered == false) { continue; }
+
+        secondaryRays.push_back(
+          {DRay{ray.GetPointAtParam(t), refDir}, attCol, random::GetThreadStreamState(), pixel, 0});
+      }
+    };
+
+    if (this->mPacketWidth == 0)
+    {
+      for (const auto& item : primaryRays) { ShadeFirstHit(item, scene.GetClosestIntersection(item.mRay)); }
     }
-    colorSum /= (TReal(rayList.size()) * repeat);
+    else
+    {
+      const auto width = this->mPacketWidth;
+      for (TIndex start = 0, count = primaryRays.size(); start < count; start += width)
+      {
+        // Remained lanes of last packet are padded with last ray, and the results are discarded.
+        const auto laneCount = std::min(width, count - start);
+        DRayPacket packet{width};
+        for (TIndex lane = 0; lane < width; ++lane)
+        {
+          packet.SetRay(lane, primaryRays[start + std::min(lane, laneCount - 1)].mRay);
+        }
 
-    // Encoding
-    auto encode = 1.0f / cam.GetGamma();
-    for (int i = 0; i < 3; ++i) { colorSum[i] = std::pow(colorSum[i], encode); }
+        DPacketHits hits;
+        scene.GetClosestIntersections(packet, hits);
+        for (TIndex lane = 0; lane < laneCount; ++lane) 
+        { 
+          ShadeFirstHit(primaryRays[start + lane], hits.mResults[lane]); 
+        }
+      }
+    }
 
-    // Clamping 
-    for (int i = 0; i < 3; ++i) { colorSum[i] = std::clamp(colorSum[i], TReal(0), TReal(1)); }
+    if (this->mIsBinningSecondaryRays == true && secondaryRays.empty() == false)
+    {
+      // Get origin bounds of secondary rays and bin rays by direction octant and origin cell.
+      DVec3 min = secondaryRays.front().mRay.GetOrigin();
+      DVec3 max = min;
+      for (const auto& item : secondaryRays)
+      {
+        const auto& origin = item.mRay.GetOrigin();
+        for (TIndex axis = 0; axis < 3; ++axis)
+        {
+          min[axis] = std::min(min[axis], origin[axis]);
+          max[axis] = std::max(max[axis], origin[axis]);
+        }
+      }
+      DVec3 invExtent = max - min;
+      for (TIndex axis = 0; axis < 3; ++axis) 
+      { 
+        invExtent[axis] = invExtent[axis] > 0 ? TReal(1) / invExtent[axis] : TReal(0);
+      }
+
+      // Counting sort with bin keys. (8 octants * 8^3 origin cells)
+      binOffsets.assign((8u << 9) + 1, 0);
+      for (auto& item : secondaryRays)
+      {
+        item.mBinKey = GetBinKeyOf(item.mRay, min, invExtent);
+        binOffsets[item.mBinKey + 1] += 1;
+      }
+      for (TIndex i = 1, count = binOffsets.size(); i < count; ++i) { binOffsets[i] += binOffsets[i - 1]; }
+
+      sortedRays.resize(secondaryRays.size());
+      for (const auto& item : secondaryRays) { sortedRays[binOffsets[item.mBinKey]++] = item; }
+      secondaryRays.swap(sortedRays);
+    }
 
-    int ir = int(255.99f * colorSum[0]);
-    int ig = int(255.99f * colorSum[1]);
-    int ib = int(255.99f * colorSum[2]);
-    container.Set(index.X, imgSize.Y - index.Y, {ir, ig, ib});
+    // Third, trace secondary rays. If binned, each bin is traced together.
+    for (const auto& [ray, throughput, randomState, pixel, _] : secondaryRays)
+    {
+      random::SetThreadStreamState(randomState);
+      colorSums[pixel] += throughput * scene.ProceedRay(ray, 1, kRayDepthLimit);
+    }
+
+    // Accumulate colors of tile.
+    for (TIndex i = tileStart; i < tileEnd; ++i)
+    {
+      const auto pixel = i - tileStart;
+      AccumulateSamples(frameBuffer, imgSize, list[i], colorSums[pixel], TU32(sampleCounts[pixel]));
+      if (pAuxBuffers != nullptr)
+      {
+        AccumulateFeatures(
+          *pAuxBuffers, imgSize, list[i], 
+          albedoSums[pixel], normalSums[pixel], depthSums[pixel], TU32(sampleCounts[pixel]));
+      }
+    }
   }
 }
 
@@ -0,0 +1,84 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <FTileStreamer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <Object/FCamera.hpp>
+#include <Image/DFrameBuffer.hpp>
+#include <Image/FMappedImage.hpp>
+
+namespace ray
+{
+
+FTileStreamer::FTileStreamer(const PCtor& ctor)
+  : mCtor { ctor }
+{
+  assert(this->mCtor.mTileSize > 0);
+  assert(this->mCtor.mThreadCount > 0);
+}
+
+void FTileStreamer::Execute(const FCamera& cam, FMappedImage& image, const DToneMapper& mapper)
+{
+  const auto& imgSize = cam.GetImageSize();
+  const auto tileSize = TU32(this->mCtor.mTileSize);
+  const auto tileCountX = (imgSize.X + tileSize - 1) / tileSize;
+  const auto tileCountY = (imgSize.Y + tileSize - 1) / tileSize;
+  const auto tileCount  = TIndex(tileCountX) * tileCountY;
+
+  std::atomic<TIndex> nextTile = 0;
+  std::vector<PTraversalStats> stats(this->mCtor.mThreadCount);
+  const auto Render = [&](TIndex tId)
+  {
+    FRenderWorker worker{this->mCtor.mWorker};
+    std::vector<DUVec2> list;
+    for (auto tile = nextTile++; tile < tileCount; tile = nextTile++)
+    {
+      const DUVec2 origin{TU32(tile % tileCountX) * tileSize, TU32(tile / tileCountX) * tileSize};
+      const auto width  = std::min(tileSize, imgSize.X - origin.X);
+      const auto height = std::min(tileSize, imgSize.Y - origin.Y);
+
+      // Pixel index of camera is flipped from output image order. (See `AccumulateSamples`)
+      list.clear();
+      for (auto y = 0u; y < height; ++y)
+      {
+        for (auto x = 0u; x < width; ++x) { list.emplace_back(imgSize.X - (origin.X + x) - 1, origin.Y + y + 1); }
+      }
+
+      DFrameBuffer buffer{width, height, origin};
+      worker.Execute(cam, list, imgSize, buffer);
+      stats[tId] += worker.GetTraversalStats();
+      image.WriteTile(buffer, mapper);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (TIndex tId = 1; tId < this->mCtor.mThreadCount; ++tId) { threads.emplace_back(Render, tId); }
+  Render(0);
+  for (auto& thread : threads) { thread.join(); }
+
+  this->mTraversalStats = PTraversalStats{};
+  for (const auto& item : stats) { this->mTraversalStats += item; }
+}
+
+const PTraversalStats& FTileStreamer::GetTraversalStats() const noexcept
+{
+  return this->mTraversalStats;
+}
+
+} /// ::ray namespace
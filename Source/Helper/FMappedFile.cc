@@ -0,0 +1,110 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <Helper/FMappedFile.hpp>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace ray
+{
+
+FMappedFile::~FMappedFile()
+{
+  if (this->IsOpened() == true) { this->Close(); }
+}
+
+bool FMappedFile::Open(const char* const path, [[maybe_unused]] bool isSequential)
+{
+  assert(this->IsOpened() == false);
+
+#if defined(_WIN32)
+  const auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) { return false; }
+
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) == 0) { CloseHandle(file); return false; }
+  this->mFileSize = TIndex(size.QuadPart);
+
+  // Empty file can not be mapped, so it is opened without mapping.
+  if (this->mFileSize > 0)
+  {
+    const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* pData = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (pData == nullptr)
+    {
+      if (mapping != nullptr) { CloseHandle(mapping); }
+      CloseHandle(file);
+      return false;
+    }
+    this->mMapping = mapping;
+    this->mpData = static_cast<const char*>(pData);
+  }
+  this->mFile = file;
+#else
+  const int file = ::open(path, O_RDONLY);
+  if (file < 0) { return false; }
+
+  struct stat status;
+  if (::fstat(file, &status) != 0 || S_ISREG(status.st_mode) == false) { ::close(file); return false; }
+  this->mFileSize = TIndex(status.st_size);
+
+  // Empty file can not be mapped, so it is opened without mapping.
+  if (this->mFileSize > 0)
+  {
+    void* pData = ::mmap(nullptr, this->mFileSize, PROT_READ, MAP_PRIVATE, file, 0);
+    if (pData == MAP_FAILED) { ::close(file); return false; }
+
+    // If file is scanned from begin to end, read-ahead is requested.
+    if (isSequential == true) { ::madvise(pData, this->mFileSize, MADV_SEQUENTIAL); }
+    this->mpData = static_cast<const char*>(pData);
+  }
+  this->mFile = file;
+#endif
+
+  this->mIsOpened = true;
+  return true;
+}
+
+void FMappedFile::Close()
+{
+  if (this->IsOpened() == false) { return; }
+
+#if defined(_WIN32)
+  if (this->mpData != nullptr) { UnmapViewOfFile(this->mpData); }
+  if (this->mMapping != nullptr) { CloseHandle(this->mMapping); }
+  CloseHandle(this->mFile);
+  this->mMapping = nullptr;
+  this->mFile = nullptr;
+#else
+  if (this->mpData != nullptr) { ::munmap(const_cast<char*>(this->mpData), this->mFileSize); }
+  ::close(this->mFile);
+  this->mFile = -1;
+#endif
+
+  this->mpData = nullptr;
+  this->mFileSize = 0;
+  this->mIsOpened = false;
+}
+
+} /// ::ray namespace
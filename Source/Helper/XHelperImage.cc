@@ -0,0 +1,478 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Helper/XHelperImage.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <Helper/XHelperParallel.hpp>
+#include <Image/DFrameBuffer.hpp>
+#include <Image/XDeflate.hpp>
+#include <Image/XToneMap.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @struct PPngStrip
+/// @brief Compressed rows of png image.
+struct PPngStrip final
+{
+  std::vector<TU8> mCompressed;
+  /// @brief Adler-32 checksum and byte size of filtered (uncompressed) rows.
+  TU32  mAdler = 1;
+  TIndex mRawSize = 0;
+};
+
+/// @brief Filter one row with the filter type that has the smallest sum of absolute values.
+/// @param pPrevRow Previous row of image. If first row, nullptr.
+/// @param pixelSize Bytes per pixel. Filters refer the same byte of left pixel.
+/// @param oFiltered Filter type and filtered row. Must have `rowSize + 1` bytes.
+void FilterPngRow(
+  const TU8* pRow, const TU8* pPrevRow, TIndex rowSize, TIndex pixelSize, 
+  bool isFiltering, TU8* oFiltered)
+{
+  const auto GetFiltered = [&](TU32 type, TIndex i) -> TU8
+  {
+    const TI32 a = i >= pixelSize ? pRow[i - pixelSize] : 0;
+    const TI32 b = pPrevRow != nullptr ? pPrevRow[i] : 0;
+    const TI32 c = (i >= pixelSize && pPrevRow != nullptr) ? pPrevRow[i - pixelSize] : 0;
+    switch (type)
+    {
+    case 1: return TU8(pRow[i] - a);
+    case 2: return TU8(pRow[i] - b);
+    case 3: return TU8(pRow[i] - ((a + b) >> 1));
+    case 4: 
+    {
+      const TI32 p = a + b - c;
+      const TI32 pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+      const TI32 predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+      return TU8(pRow[i] - predictor);
+    }
+    default: return pRow[i];
+    }
+  };
+
+  TU32 bestType = 0;
+  if (isFiltering == true)
+  {
+    std::uint64_t bestSum = std::numeric_limits<std::uint64_t>::max();
+    for (TU32 type = 0; type < 5; ++type)
+    {
+      std::uint64_t sum = 0;
+      for (TIndex i = 0; i < rowSize; ++i) { sum += std::abs(TI32(static_cast<std::int8_t>(GetFiltered(type, i)))); }
+      if (sum < bestSum) { bestSum = sum; bestType = type; }
+    }
+  }
+
+  oFiltered[0] = TU8(bestType);
+  for (TIndex i = 0; i < rowSize; ++i) { oFiltered[i + 1] = GetFiltered(bestType, i); }
+}
+
+/// @brief Tone-map, filter and compress given rows of frame buffer.
+void EncodePngStrip(
+  const DFrameBuffer& buffer, const DToneMapper& mapper, TU32 bitDepth, TI32 level,
+  TIndex rowStart, TIndex rowCount, PPngStrip& oStrip)
+{
+  // Previous row of strip is also tone-mapped, because filters refer it.
+  const auto pixelSize = bitDepth / 8 * 3;
+  const auto rowSize = buffer.GetWidth() * pixelSize;
+  const TIndex prevCount = rowStart > 0 ? 1 : 0;
+  std::vector<TU8> rgb((rowCount + prevCount) * rowSize);
+  if (bitDepth == 16)
+  {
+    // 16-bit samples are stored in big-endian.
+    std::vector<TU16> values(rgb.size() / 2);
+    mapper.MapRows(buffer, rowStart - prevCount, rowCount + prevCount, values.data());
+    for (TIndex i = 0, size = values.size(); i < size; ++i)
+    {
+      rgb[i * 2]     = TU8(values[i] >> 8);
+      rgb[i * 2 + 1] = TU8(values[i]);
+    }
+  }
+  else
+  {
+    mapper.MapRows(buffer, rowStart - prevCount, rowCount + prevCount, rgb.data());
+  }
+
+  std::vector<TU8> filtered(rowCount * (rowSize + 1));
+  for (TIndex row = 0; row < rowCount; ++row)
+  {
+    const auto index = row + prevCount;
+    const TU8* pRow = &rgb[index * rowSize];
+    FilterPngRow(
+      pRow, index > 0 ? pRow - rowSize : nullptr, rowSize, pixelSize, 
+      level > 0, &filtered[row * (rowSize + 1)]);
+  }
+
+  oStrip.mAdler = deflate::GetAdler32(filtered.data(), filtered.size());
+  oStrip.mRawSize = filtered.size();
+  deflate::CompressBlocks(filtered.data(), filtered.size(), level, oStrip.mCompressed);
+}
+
+/// @brief Write png chunk with length, type, data and CRC.
+bool WritePngChunk(FILE* fd, const char (&type)[5], const TU8* pData, TIndex size)
+{
+  const auto GetBigEndian = [](TU32 value) -> std::array<TU8, 4>
+  {
+    return {TU8(value >> 24), TU8(value >> 16), TU8(value >> 8), TU8(value)};
+  };
+
+  const auto length = GetBigEndian(TU32(size));
+  auto crc = deflate::GetCrc32(reinterpret_cast<const TU8*>(type), 4);
+  crc = deflate::GetCrc32(pData, size, crc);
+  const auto crcBytes = GetBigEndian(crc);
+
+  return std::fwrite(length.data(), 1, 4, fd) == 4
+      && std::fwrite(type, 1, 4, fd) == 4
+      && (size == 0 || std::fwrite(pData, 1, size, fd) == size)
+      && std::fwrite(crcBytes.data(), 1, 4, fd) == 4;
+}
+
+/// @brief Write header and values of accumulation file into opened file.
+bool WriteAccumulation(
+  FILE* fd, 
+  const DFrameBuffer& buffer, const DUVec2& imageSize, TU32 sampleStart, TU32 sampleEnd)
+{
+  // Text header has image size, origin and size of buffer, and sample index range [start, end).
+  // Little-endian float RGB sums and 32-bit sample counts of rows follow it.
+  const auto width  = buffer.GetWidth();
+  const auto height = buffer.GetHeight();
+  const auto& origin = buffer.GetOrigin();
+  bool isWritten = std::fprintf(fd, "SHACC\n%u %u\n%u %u %u %u\n%u %u\n", 
+    imageSize.X, imageSize.Y, origin.X, origin.Y, (TU32)width, (TU32)height, sampleStart, sampleEnd) > 0;
+
+  for (TIndex y = 0; y < height && isWritten == true; ++y)
+  {
+    isWritten = std::fwrite(buffer.GetSumRow(y), sizeof(float), width * 3, fd) == width * 3;
+  }
+  for (TIndex y = 0; y < height && isWritten == true; ++y)
+  {
+    isWritten = std::fwrite(buffer.GetSampleCountRow(y), sizeof(TU32), width, fd) == width;
+  }
+  return isWritten;
+}
+
+/// @brief Read header and values of accumulation file from opened file.
+/// @param path Path of file, for error messages.
+std::optional<PAccumulationImage> ReadAccumulation(FILE* fd, const char* const path)
+{
+  // Header must be terminated by one newline just before binary values.
+  TU32 imageWidth = 0, imageHeight = 0, originX = 0, originY = 0, width = 0, height = 0;
+  TU32 sampleStart = 0, sampleEnd = 0;
+  const bool isValidHeader = 
+      std::fscanf(fd, "SHACC %u %u %u %u %u %u %u %u", 
+        &imageWidth, &imageHeight, &originX, &originY, &width, &height, &sampleStart, &sampleEnd) == 8
+  &&  std::fgetc(fd) == '\n'
+  &&  TIndex(originX) + width <= imageWidth && TIndex(originY) + height <= imageHeight
+  &&  sampleStart <= sampleEnd;
+  if (isValidHeader == false)
+  {
+    std::printf("Failed to read file, %s. Header is not valid.\n", path);
+    return std::nullopt;
+  }
+
+  std::vector<float> sums(TIndex(width) * height * 3);
+  std::vector<TU32> counts(TIndex(width) * height);
+  const bool isRead = std::fread(sums.data(), sizeof(float), sums.size(), fd) == sums.size()
+    && std::fread(counts.data(), sizeof(TU32), counts.size(), fd) == counts.size();
+  if (isRead == false)
+  {
+    std::printf("Failed to read file, %s. File is truncated.\n", path);
+    return std::nullopt;
+  }
+
+  PAccumulationImage result;
+  result.mImageSize = DUVec2{imageWidth, imageHeight};
+  result.mSampleStart = sampleStart;
+  result.mSampleEnd = sampleEnd;
+  result.mBuffer = DFrameBuffer{width, height, DUVec2{originX, originY}};
+  for (TIndex i = 0, size = counts.size(); i < size; ++i)
+  {
+    const auto* pSum = &sums[i * 3];
+    result.mBuffer.AddSamples(i % width, i / width, DVec3{pSum[0], pSum[1], pSum[2]}, counts[i]);
+  }
+  return result;
+}
+
+} /// anonymous namespace
+
+namespace ray
+{
+
+bool CreateImagePpm(
+  const char* const path, 
+  TIndex width, TIndex height, const std::vector<TU8>& rgb, 
+  EPpmFormat format)
+{
+  assert(rgb.size() == width * height * 3);
+
+  // Open file
+  FILE* fd = std::fopen(path, "wb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open / create file, %s.\n", path);
+    return false;
+  }
+
+  bool isWritten = true;
+  if (format == EPpmFormat::Binary)
+  {
+    // 8-bit RGB values are already P6 raster, so whole image is emitted with one bulk write.
+    std::fprintf(fd, "P6\n%u %u\n255\n", (TU32)width, (TU32)height);
+    isWritten = std::fwrite(rgb.data(), sizeof(TU8), rgb.size(), fd) == rgb.size();
+  }
+  else
+  {
+    // Format each row into text buffer, and write row at once. ("255 255 255\n" is the longest pixel)
+    std::fprintf(fd, "P3\n%u %u\n255\n", (TU32)width, (TU32)height);
+    std::vector<char> row(width * 12);
+    for (TIndex y = 0; y < height && isWritten == true; ++y)
+    {
+      char* pCursor = row.data();
+      for (TIndex i = y * width * 3, end = (y + 1) * width * 3; i < end; ++i)
+      {
+        const auto value = rgb[i];
+        if (value >= 100) { *pCursor++ = char('0' + value / 100); }
+        if (value >= 10)  { *pCursor++ = char('0' + value / 10 % 10); }
+        *pCursor++ = char('0' + value % 10);
+        *pCursor++ = (i % 3 == 2) ? '\n' : ' ';
+      }
+
+      const auto size = TIndex(pCursor - row.data());
+      isWritten = std::fwrite(row.data(), sizeof(char), size, fd) == size;
+    }
+  }
+
+  std::fclose(fd);
+  if (isWritten == false) 
+  { 
+    std::printf("Failed to write file, %s.\n", path); 
+  }
+  return isWritten;
+}
+
+bool CreateImagePng(
+  const char* const path, 
+  const DFrameBuffer& buffer, const PToneMapParams& toneMapParams, 
+  const PPngOptions& options)
+{
+  FILE* fd = std::fopen(path, "wb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open / create file, %s.\n", path);
+    return false;
+  }
+
+  const auto width  = buffer.GetWidth();
+  const auto height = buffer.GetHeight();
+  const auto level  = std::clamp(options.mCompressionLevel, 0, 9);
+  const auto bitDepth = options.mBitDepth == 16 ? 16u : 8u;
+  const auto threadCount = std::max<TIndex>(
+    options.mThreadCount != 0 ? options.mThreadCount : GetParallelThreadCount(), 1);
+  const auto stripRowCount = options.mStripRowCount != 0 
+    ? options.mStripRowCount 
+    : std::max<TIndex>((1u << 20) / (width * bitDepth / 8 * 3 + 1), 1);
+  const DToneMapper mapper{toneMapParams};
+
+  // Signature and header. (8-bit or 16-bit depth, RGB, deflate, adaptive filter, no interlace)
+  const TU8 signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  const TU8 header[13] = {
+    TU8(width >> 24), TU8(width >> 16), TU8(width >> 8), TU8(width),
+    TU8(height >> 24), TU8(height >> 16), TU8(height >> 8), TU8(height),
+    TU8(bitDepth), 2, 0, 0, 0};
+  const auto zlibHeader = deflate::GetZlibHeader();
+  bool isWritten = std::fwrite(signature, 1, 8, fd) == 8
+    && WritePngChunk(fd, "IHDR", header, sizeof(header))
+    && WritePngChunk(fd, "IDAT", zlibHeader.data(), zlibHeader.size());
+
+  // Encode strips in parallel as many as threads, and write them in order.
+  // Only strips of one wave are held in memory.
+  TU32 adler = 1;
+  const auto stripCount = (height + stripRowCount - 1) / stripRowCount;
+  std::vector<PPngStrip> strips;
+  for (TIndex waveStart = 0; waveStart < stripCount && isWritten == true; waveStart += threadCount)
+  {
+    const auto waveCount = std::min(threadCount, stripCount - waveStart);
+    strips.assign(waveCount, PPngStrip{});
+    const auto Encode = [&](TIndex i)
+    {
+      const auto rowStart = (waveStart + i) * stripRowCount;
+      const auto rowCount = std::min(stripRowCount, height - rowStart);
+      EncodePngStrip(buffer, mapper, bitDepth, level, rowStart, rowCount, strips[i]);
+    };
+
+    ForEachThread(waveCount, Encode);
+
+    for (const auto& strip : strips)
+    {
+      isWritten = isWritten && WritePngChunk(fd, "IDAT", strip.mCompressed.data(), strip.mCompressed.size());
+      adler = deflate::CombineAdler32(adler, strip.mAdler, strip.mRawSize);
+    }
+  }
+
+  // Terminate deflate stream, and append Adler-32 of zlib stream.
+  std::vector<TU8> tail;
+  deflate::AppendFinalBlock(tail);
+  for (TU32 shift : {24, 16, 8, 0}) { tail.push_back(TU8(adler >> shift)); }
+  isWritten = isWritten
+    && WritePngChunk(fd, "IDAT", tail.data(), tail.size())
+    && WritePngChunk(fd, "IEND", nullptr, 0);
+
+  std::fclose(fd);
+  if (isWritten == false)
+  {
+    std::printf("Failed to write file, %s.\n", path);
+  }
+  return isWritten;
+}
+
+bool CreateImagePfm(const char* const path, const DFrameBuffer& buffer)
+{
+  FILE* fd = std::fopen(path, "wb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open / create file, %s.\n", path);
+    return false;
+  }
+
+  // Negative scale means little-endian. Rows are stored from bottom to top.
+  const auto width  = buffer.GetWidth();
+  const auto height = buffer.GetHeight();
+  std::fprintf(fd, "PF\n%u %u\n-1.0\n", (TU32)width, (TU32)height);
+
+  std::vector<float> row(width * 3);
+  for (TIndex y = height; y > 0; --y)
+  {
+    for (TIndex x = 0; x < width; ++x)
+    {
+      const auto color = buffer.GetAverage(x, y - 1);
+      for (TIndex i = 0; i < 3; ++i) { row[x * 3 + i] = float(color[i]); }
+    }
+    if (std::fwrite(row.data(), sizeof(float), row.size(), fd) != row.size())
+    {
+      std::printf("Failed to write file, %s.\n", path);
+      std::fclose(fd);
+      return false;
+    }
+  }
+
+  std::fclose(fd);
+  return true;
+}
+
+bool CreateImageAcc(
+  const char* const path, 
+  const DFrameBuffer& buffer, const DUVec2& imageSize, TU32 sampleStart, TU32 sampleEnd)
+{
+  FILE* fd = std::fopen(path, "wb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open / create file, %s.\n", path);
+    return false;
+  }
+
+  const bool isWritten = WriteAccumulation(fd, buffer, imageSize, sampleStart, sampleEnd);
+  std::fclose(fd);
+  if (isWritten == false)
+  {
+    std::printf("Failed to write file, %s.\n", path);
+  }
+  return isWritten;
+}
+
+std::optional<PAccumulationImage> LoadImageAcc(const char* const path)
+{
+  FILE* fd = std::fopen(path, "rb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open file, %s.\n", path);
+    return std::nullopt;
+  }
+
+  auto result = ReadAccumulation(fd, path);
+  std::fclose(fd);
+  return result;
+}
+
+bool CreateCheckpoint(
+  const char* const path, 
+  const DFrameBuffer& buffer, const DUVec2& imageSize, TU32 sampleStart, TU32 nextSample)
+{
+  const std::string tempPath = std::string{path} + ".tmp";
+  FILE* fd = std::fopen(tempPath.c_str(), "wb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open / create file, %s.\n", tempPath.c_str());
+    return false;
+  }
+
+  // Checkpoint is the next sample index followed by accumulation file.
+  const bool isWritten = std::fprintf(fd, "SHCKP\n%u\n", nextSample) > 0
+    && WriteAccumulation(fd, buffer, imageSize, sampleStart, nextSample);
+  const bool isClosed = std::fclose(fd) == 0;
+  if (isWritten == false || isClosed == false)
+  {
+    std::printf("Failed to write file, %s.\n", tempPath.c_str());
+    std::remove(tempPath.c_str());
+    return false;
+  }
+
+  // Rename does not replace existing file on some platforms, so remove previous checkpoint then.
+  if (std::rename(tempPath.c_str(), path) != 0
+  && (std::remove(path) != 0 || std::rename(tempPath.c_str(), path) != 0))
+  {
+    std::printf("Failed to replace checkpoint file, %s.\n", path);
+    return false;
+  }
+  return true;
+}
+
+std::optional<PRenderCheckpoint> LoadCheckpoint(const char* const path)
+{
+  FILE* fd = std::fopen(path, "rb");
+  if (fd == nullptr)
+  {
+    std::printf("Failed to open file, %s.\n", path);
+    return std::nullopt;
+  }
+
+  PRenderCheckpoint result;
+  if (std::fscanf(fd, "SHCKP %u", &result.mNextSample) != 1 || std::fgetc(fd) != '\n')
+  {
+    std::printf("Failed to read file, %s. Header is not valid.\n", path);
+    std::fclose(fd);
+    return std::nullopt;
+  }
+
+  auto optImage = ReadAccumulation(fd, path);
+  std::fclose(fd);
+  if (optImage.has_value() == false) { return std::nullopt; }
+
+  if (optImage->mSampleEnd != result.mNextSample)
+  {
+    std::printf("Failed to read file, %s. Sample range is not matched to next sample.\n", path);
+    return std::nullopt;
+  }
+  result.mImage = std::move(*optImage);
+  return result;
+}
+
+} /// ::ray namespace
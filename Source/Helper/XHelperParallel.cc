@@ -0,0 +1,47 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Helper/XHelperParallel.hpp>
+#include <algorithm>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief Thread budget of current thread. If 0, current thread is not in parallel loop.
+thread_local TIndex sThreadBudget = 0;
+
+} /// anonymous namespace
+
+namespace ray
+{
+
+TIndex GetParallelThreadCount() noexcept
+{
+  if (sThreadBudget != 0) { return sThreadBudget; }
+  return std::max<TIndex>(std::thread::hardware_concurrency(), 1);
+}
+
+FParallelScope::FParallelScope(TIndex threadBudget) noexcept
+  : mPreviousBudget { sThreadBudget }
+{
+  sThreadBudget = std::max<TIndex>(threadBudget, 1);
+}
+
+FParallelScope::~FParallelScope() noexcept
+{
+  sThreadBudget = this->mPreviousBudget;
+}
+
+} /// ::ray namespace
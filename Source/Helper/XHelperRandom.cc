@@ -0,0 +1,102 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <Helper/XHelperRandom.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+using namespace ray;
+
+constexpr std::uint64_t kPcgMultiplier = 6364136223846793005ull;
+constexpr std::uint64_t kPcgIncrement  = 1442695040888963407ull;
+constexpr TReal kTwoPi = TReal(6.28318530717958647692);
+
+/// @brief State of PCG32 stream of current thread.
+std::uint64_t& GetThreadState() noexcept
+{
+  thread_local std::uint64_t state = 0x853C49E6748FEA9Bull;
+  return state;
+}
+
+/// @brief Mix bits of given value. (SplitMix64 finalizer)
+std::uint64_t MixBits(std::uint64_t value) noexcept
+{
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+/// @brief Advance stream of current thread, and get next 32-bit value. (PCG32 XSH-RR)
+TU32 GetNextBits() noexcept
+{
+  auto& state = GetThreadState();
+  const auto oldState = state;
+  state = oldState * kPcgMultiplier + kPcgIncrement;
+
+  const auto xorShifted = TU32(((oldState >> 18) ^ oldState) >> 27);
+  const auto rotation   = TU32(oldState >> 59);
+  return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+/// @brief Get uniform random value in [0, 1) with 24-bit precision.
+TReal GetNextUnit() noexcept
+{
+  return TReal(GetNextBits() >> 8) * TReal(1.0 / 16777216.0);
+}
+
+} /// anonymous namespace
+
+namespace ray::random
+{
+
+void SeedThreadStream(TU32 pixelKey, TU32 sampleIndex, ESampleStage stage) noexcept
+{
+  const auto key = (std::uint64_t(pixelKey) << 32) | sampleIndex;
+  GetThreadState() = MixBits(MixBits(key) + std::uint64_t(stage));
+}
+
+std::uint64_t GetThreadStreamState() noexcept
+{
+  return GetThreadState();
+}
+
+void SetThreadStreamState(std::uint64_t state) noexcept
+{
+  GetThreadState() = state;
+}
+
+TReal GetUniformReal(TReal min, TReal max) noexcept
+{
+  return min + (max - min) * GetNextUnit();
+}
+
+DVec3 GetVector3Length(TReal length) noexcept
+{
+  const auto z = TReal(2) * GetNextUnit() - TReal(1);
+  const auto phi = kTwoPi * GetNextUnit();
+  const auto radius = std::sqrt(std::max(TReal(0), TReal(1) - z * z));
+  return DVec3{radius * std::cos(phi), radius * std::sin(phi), z} * length;
+}
+
+DVec2 GetVector2Range(TReal min, TReal max) noexcept
+{
+  const auto phi = kTwoPi * GetNextUnit();
+  const auto length = GetUniformReal(min, max);
+  return DVec2{std::cos(phi) * length, std::sin(phi) * length};
+}
+
+} /// ::ray::random namespace
@@ -0,0 +1,45 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <Image/DAuxBuffers.hpp>
+
+namespace ray
+{
+
+DAuxBuffers::DAuxBuffers(TIndex width, TIndex height, const DUVec2& origin)
+  : mAlbedo { width, height, origin },
+    mNormal { width, height, origin },
+    mDepth  { width, height, origin }
+{ }
+
+void DAuxBuffers::AddSamples(
+  TIndex x, TIndex y, 
+  const DVec3& albedoSum, const DVec3& normalSum, TReal depthSum, TU32 sampleCount) noexcept
+{
+  this->mAlbedo.AddSamples(x, y, albedoSum, sampleCount);
+  this->mNormal.AddSamples(x, y, normalSum, sampleCount);
+  this->mDepth.AddSamples(x, y, DVec3{depthSum}, sampleCount);
+}
+
+bool DAuxBuffers::Merge(const DAuxBuffers& other)
+{
+  // All buffers have the same size and origin, so only the first merge can fail.
+  if (this->mAlbedo.Merge(other.mAlbedo) == false) { return false; }
+
+  [[maybe_unused]] const auto isMerged = this->mNormal.Merge(other.mNormal) && this->mDepth.Merge(other.mDepth);
+  assert(isMerged == true);
+  return true;
+}
+
+} /// ::ray namespace
@@ -0,0 +1,112 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Image/DFrameBuffer.hpp>
+#include <algorithm>
+
+namespace ray
+{
+
+DFrameBuffer::DFrameBuffer(TIndex width, TIndex height)
+  : mWidth { width },
+    mHeight { height },
+    mSums (width * height * 3, 0.0f),
+    mSampleCounts (width * height, 0)
+{ }
+
+DFrameBuffer::DFrameBuffer(TIndex width, TIndex height, const DUVec2& origin)
+  : DFrameBuffer(width, height)
+{
+  this->mOrigin = origin;
+}
+
+void DFrameBuffer::AddSamples(TIndex x, TIndex y, const DVec3& radianceSum, TU32 sampleCount) noexcept
+{
+  assert(x < this->mWidth && y < this->mHeight);
+  const auto pixel = y * this->mWidth + x;
+  for (TIndex i = 0; i < 3; ++i) { this->mSums[pixel * 3 + i] += radianceSum[i]; }
+  this->mSampleCounts[pixel] += sampleCount;
+}
+
+DVec3 DFrameBuffer::GetAverage(TIndex x, TIndex y) const noexcept
+{
+  assert(x < this->mWidth && y < this->mHeight);
+  const auto pixel = y * this->mWidth + x;
+  const auto count = this->mSampleCounts[pixel];
+  if (count == 0) { return DVec3{0}; }
+
+  const auto* pSum = &this->mSums[pixel * 3];
+  return DVec3{pSum[0], pSum[1], pSum[2]} / TReal(count);
+}
+
+TU32 DFrameBuffer::GetSampleCount(TIndex x, TIndex y) const noexcept
+{
+  assert(x < this->mWidth && y < this->mHeight);
+  return this->mSampleCounts[y * this->mWidth + x];
+}
+
+const float* DFrameBuffer::GetSumRow(TIndex y) const noexcept
+{
+  assert(y < this->mHeight);
+  return &this->mSums[y * this->mWidth * 3];
+}
+
+const TU32* DFrameBuffer::GetSampleCountRow(TIndex y) const noexcept
+{
+  assert(y < this->mHeight);
+  return &this->mSampleCounts[y * this->mWidth];
+}
+
+bool DFrameBuffer::Merge(const DFrameBuffer& other)
+{
+  if (this->mWidth != other.mWidth || this->mHeight != other.mHeight) { return false; }
+  if (this->mOrigin.X != other.mOrigin.X || this->mOrigin.Y != other.mOrigin.Y) { return false; }
+
+  for (TIndex i = 0, size = this->mSums.size(); i < size; ++i) { this->mSums[i] += other.mSums[i]; }
+  for (TIndex i = 0, size = this->mSampleCounts.size(); i < size; ++i) 
+  { 
+    this->mSampleCounts[i] += other.mSampleCounts[i]; 
+  }
+  return true;
+}
+
+bool DFrameBuffer::MergeRegion(const DFrameBuffer& other)
+{
+  if (other.mOrigin.X < this->mOrigin.X || other.mOrigin.Y < this->mOrigin.Y) { return false; }
+  const auto offsetX = TIndex(other.mOrigin.X - this->mOrigin.X);
+  const auto offsetY = TIndex(other.mOrigin.Y - this->mOrigin.Y);
+  if (offsetX + other.mWidth > this->mWidth || offsetY + other.mHeight > this->mHeight) { return false; }
+
+  for (TIndex y = 0; y < other.mHeight; ++y)
+  {
+    const auto pixel = (offsetY + y) * this->mWidth + offsetX;
+    const auto otherPixel = y * other.mWidth;
+    for (TIndex i = 0, size = other.mWidth * 3; i < size; ++i) 
+    { 
+      this->mSums[pixel * 3 + i] += other.mSums[otherPixel * 3 + i]; 
+    }
+    for (TIndex x = 0; x < other.mWidth; ++x) 
+    { 
+      this->mSampleCounts[pixel + x] += other.mSampleCounts[otherPixel + x]; 
+    }
+  }
+  return true;
+}
+
+void DFrameBuffer::Clear() noexcept
+{
+  std::fill(this->mSums.begin(), this->mSums.end(), 0.0f);
+  std::fill(this->mSampleCounts.begin(), this->mSampleCounts.end(), 0);
+}
+
+} /// ::ray namespace
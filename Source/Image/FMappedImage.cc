@@ -0,0 +1,188 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <Image/FMappedImage.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+#include <Image/DFrameBuffer.hpp>
+#include <Image/XToneMap.hpp>
+
+namespace ray
+{
+
+FMappedImage::~FMappedImage()
+{
+  if (this->IsOpened() == true) { (void)this->Close(); }
+}
+
+bool FMappedImage::Open(const char* const path, EMappedImageFormat format, TIndex width, TIndex height)
+{
+  assert(this->IsOpened() == false);
+
+  // Header is the same to in-memory writers. Pfm rows are stored from bottom to top.
+  char header[64];
+  const auto headerSize = format == EMappedImageFormat::Ppm
+    ? std::snprintf(header, sizeof(header), "P6\n%u %u\n255\n", (TU32)width, (TU32)height)
+    : std::snprintf(header, sizeof(header), "PF\n%u %u\n-1.0\n", (TU32)width, (TU32)height);
+
+  this->mFormat     = format;
+  this->mWidth      = width;
+  this->mHeight     = height;
+  this->mRowSize    = width * (format == EMappedImageFormat::Ppm ? 3 : 3 * sizeof(float));
+  this->mHeaderSize = TIndex(headerSize);
+  this->mFileSize   = this->mHeaderSize + this->mRowSize * height;
+
+#if defined(_WIN32)
+  const auto file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    std::printf("Failed to open / create file, %s.\n", path);
+    return false;
+  }
+
+  // Mapping extends file into given size, and extended area is filled with zero. (Black)
+  const auto size = static_cast<unsigned long long>(this->mFileSize);
+  const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, DWORD(size >> 32), DWORD(size), nullptr);
+  void* pData = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, this->mFileSize) : nullptr;
+  if (pData == nullptr)
+  {
+    std::printf("Failed to map file, %s.\n", path);
+    if (mapping != nullptr) { CloseHandle(mapping); }
+    CloseHandle(file);
+    return false;
+  }
+  this->mFile = file;
+  this->mMapping = mapping;
+#else
+  const int file = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (file < 0)
+  {
+    std::printf("Failed to open / create file, %s.\n", path);
+    return false;
+  }
+
+  // Truncated file is sparse and filled with zero (Black), so no raster is written on creation.
+  void* pData = ::ftruncate(file, off_t(this->mFileSize)) == 0
+    ? ::mmap(nullptr, this->mFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0)
+    : MAP_FAILED;
+  if (pData == MAP_FAILED)
+  {
+    std::printf("Failed to map file, %s.\n", path);
+    ::close(file);
+    return false;
+  }
+  this->mFile = file;
+#endif
+
+  this->mpData = static_cast<TU8*>(pData);
+  std::memcpy(this->mpData, header, this->mHeaderSize);
+  return true;
+}
+
+void FMappedImage::WriteTile(const DFrameBuffer& tile, const DToneMapper& mapper)
+{
+  assert(this->IsOpened() == true);
+  const auto& origin = tile.GetOrigin();
+  const auto width  = tile.GetWidth();
+  const auto height = tile.GetHeight();
+  assert(origin.X + width <= this->mWidth && origin.Y + height <= this->mHeight);
+
+  TU8* pRaster = this->mpData + this->mHeaderSize;
+  if (this->mFormat == EMappedImageFormat::Ppm)
+  {
+    std::vector<TU8> rgb(width * height * 3);
+    mapper.MapRows(tile, 0, height, rgb.data());
+    for (TIndex row = 0; row < height; ++row)
+    {
+      TU8* pDest = pRaster + (origin.Y + row) * this->mRowSize + origin.X * 3;
+      std::memcpy(pDest, &rgb[row * width * 3], width * 3);
+    }
+    this->FlushRows(origin.Y, height);
+  }
+  else
+  {
+    // Raster is not aligned to float after text header, so each row is copied as bytes.
+    std::vector<float> values(width * 3);
+    for (TIndex row = 0; row < height; ++row)
+    {
+      for (TIndex x = 0; x < width; ++x)
+      {
+        const auto color = tile.GetAverage(x, row);
+        for (TIndex i = 0; i < 3; ++i) { values[x * 3 + i] = float(color[i]); }
+      }
+
+      const auto fileRow = this->mHeight - (origin.Y + row) - 1;
+      TU8* pDest = pRaster + fileRow * this->mRowSize + origin.X * 3 * sizeof(float);
+      std::memcpy(pDest, values.data(), values.size() * sizeof(float));
+    }
+    this->FlushRows(this->mHeight - origin.Y - height, height);
+  }
+}
+
+bool FMappedImage::Close()
+{
+  if (this->IsOpened() == false) { return false; }
+
+#if defined(_WIN32)
+  const bool isFlushed = FlushViewOfFile(this->mpData, 0) != 0;
+  UnmapViewOfFile(this->mpData);
+  CloseHandle(this->mMapping);
+  CloseHandle(this->mFile);
+  this->mMapping = nullptr;
+  this->mFile = nullptr;
+#else
+  const bool isFlushed = ::msync(this->mpData, this->mFileSize, MS_SYNC) == 0;
+  ::munmap(this->mpData, this->mFileSize);
+  ::close(this->mFile);
+  this->mFile = -1;
+#endif
+
+  this->mpData = nullptr;
+  return isFlushed;
+}
+
+void FMappedImage::FlushRows(TIndex fileRowStart, TIndex rowCount)
+{
+  const auto begin = this->mHeaderSize + fileRowStart * this->mRowSize;
+  const auto end   = begin + rowCount * this->mRowSize;
+  if (begin >= end) { return; }
+
+  // Writing back is started asynchronously, and pages are dropped from resident set of process.
+  // Pages that are shared with other tiles in flight are faulted in again when written.
+#if defined(_WIN32)
+  FlushViewOfFile(this->mpData + begin, end - begin);
+  VirtualUnlock(this->mpData + begin, end - begin);
+#else
+  static const auto pageSize = TIndex(::sysconf(_SC_PAGESIZE));
+  const auto alignedBegin = begin / pageSize * pageSize;
+  ::msync(this->mpData + alignedBegin, end - alignedBegin, MS_ASYNC);
+  ::madvise(this->mpData + alignedBegin, end - alignedBegin, MADV_DONTNEED);
+#endif
+}
+
+} /// ::ray namespace
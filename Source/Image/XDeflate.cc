@@ -0,0 +1,275 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Image/XDeflate.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace
+{
+
+using namespace ray;
+
+constexpr TIndex kWindowSize  = 32768;
+constexpr TIndex kMinMatch    = 3;
+constexpr TIndex kMaxMatch    = 258;
+constexpr TIndex kHashBits    = 15;
+constexpr TU32   kAdlerBase   = 65521;
+
+constexpr std::array<TU32, 29> kLengthBases = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr std::array<TU32, 29> kLengthExtraBits = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr std::array<TU32, 30> kDistanceBases = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr std::array<TU32, 30> kDistanceExtraBits = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/// @class DBitWriter
+/// @brief Deflate bit stream writer. Bits are packed from LSB of each byte.
+class DBitWriter final
+{
+public:
+  DBitWriter(std::vector<TU8>& oBytes) : mBytes { oBytes } { }
+
+  /// @brief Write lower `count` bits of value. (LSB first)
+  void Write(TU32 value, TU32 count)
+  {
+    this->mBits |= value << this->mCount;
+    this->mCount += count;
+    for (; this->mCount >= 8; this->mCount -= 8, this->mBits >>= 8) 
+    { 
+      this->mBytes.push_back(TU8(this->mBits & 0xFF)); 
+    }
+  }
+
+  /// @brief Write huffman code. Huffman codes are packed from MSB.
+  void WriteCode(TU32 code, TU32 length)
+  {
+    TU32 reversed = 0;
+    for (TU32 i = 0; i < length; ++i) { reversed |= ((code >> i) & 1) << (length - 1 - i); }
+    this->Write(reversed, length);
+  }
+
+  /// @brief Pad remained bits with zero, to byte boundary.
+  void Align()
+  {
+    if (this->mCount > 0) { this->mBytes.push_back(TU8(this->mBits & 0xFF)); }
+    this->mBits = 0;
+    this->mCount = 0;
+  }
+
+private:
+  std::vector<TU8>& mBytes;
+  TU32 mBits  = 0;
+  TU32 mCount = 0;
+};
+
+/// @brief Write literal or length symbol with fixed huffman code.
+void WriteFixedSymbol(DBitWriter& writer, TU32 symbol)
+{
+  if (symbol <= 143)      { writer.WriteCode(0x30 + symbol, 8); }
+  else if (symbol <= 255) { writer.WriteCode(0x190 + symbol - 144, 9); }
+  else if (symbol <= 279) { writer.WriteCode(symbol - 256, 7); }
+  else                    { writer.WriteCode(0xC0 + symbol - 280, 8); }
+}
+
+/// @brief Write match of given length and distance with fixed huffman code.
+void WriteFixedMatch(DBitWriter& writer, TU32 length, TU32 distance)
+{
+  TU32 lengthCode = kLengthBases.size() - 1;
+  while (kLengthBases[lengthCode] > length) { --lengthCode; }
+  WriteFixedSymbol(writer, 257 + lengthCode);
+  writer.Write(length - kLengthBases[lengthCode], kLengthExtraBits[lengthCode]);
+
+  TU32 distanceCode = kDistanceBases.size() - 1;
+  while (kDistanceBases[distanceCode] > distance) { --distanceCode; }
+  writer.WriteCode(distanceCode, 5);
+  writer.Write(distance - kDistanceBases[distanceCode], kDistanceExtraBits[distanceCode]);
+}
+
+/// @brief Get the maximum hash chain length to search of given level.
+TIndex GetChainLengthOf(TI32 level)
+{
+  constexpr std::array<TIndex, 10> kChainLengths = { 0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096 };
+  return kChainLengths[std::clamp(level, 0, 9)];
+}
+
+TU32 GetHashOf(const TU8* pData)
+{
+  return ((TU32(pData[0]) << 10) ^ (TU32(pData[1]) << 5) ^ TU32(pData[2])) & ((1u << kHashBits) - 1);
+}
+
+void CompressStored(const TU8* pData, TIndex size, std::vector<TU8>& oCompressed)
+{
+  // Stored block header is 3 bits, and then padded to byte boundary. (BFINAL = 0, BTYPE = 00)
+  for (TIndex offset = 0; offset < size; )
+  {
+    const auto length = TU32(std::min<TIndex>(size - offset, 65535));
+    oCompressed.push_back(0);
+    oCompressed.push_back(TU8(length & 0xFF));
+    oCompressed.push_back(TU8(length >> 8));
+    oCompressed.push_back(TU8(~length & 0xFF));
+    oCompressed.push_back(TU8((~length >> 8) & 0xFF));
+    oCompressed.insert(oCompressed.end(), pData + offset, pData + offset + length);
+    offset += length;
+  }
+}
+
+void CompressFixed(const TU8* pData, TIndex size, TI32 level, std::vector<TU8>& oCompressed)
+{
+  const auto maxChain = GetChainLengthOf(level);
+  std::vector<TI32> heads(1u << kHashBits, -1);
+  std::vector<TI32> prevs(size, -1);
+
+  DBitWriter writer{oCompressed};
+  writer.Write(0, 1); // BFINAL = 0
+  writer.Write(1, 2); // BTYPE = 01 (fixed huffman)
+
+  const auto Insert = [&](TIndex pos)
+  {
+    if (pos + kMinMatch > size) { return; }
+    const auto hash = GetHashOf(pData + pos);
+    prevs[pos] = heads[hash];
+    heads[hash] = TI32(pos);
+  };
+
+  for (TIndex pos = 0; pos < size; )
+  {
+    // Find the longest match in window with hash chain.
+    TIndex bestLength = 0, bestDistance = 0;
+    if (pos + kMinMatch <= size)
+    {
+      const auto maxLength = std::min(kMaxMatch, size - pos);
+      TI32 candidate = heads[GetHashOf(pData + pos)];
+      for (TIndex chain = 0; candidate >= 0 && pos - candidate <= kWindowSize && chain < maxChain; ++chain)
+      {
+        TIndex length = 0;
+        while (length < maxLength && pData[candidate + length] == pData[pos + length]) { ++length; }
+        if (length > bestLength) 
+        { 
+          bestLength = length; 
+          bestDistance = pos - candidate;
+          if (length == maxLength) { break; }
+        }
+        candidate = prevs[candidate];
+      }
+    }
+
+    if (bestLength >= kMinMatch)
+    {
+      WriteFixedMatch(writer, TU32(bestLength), TU32(bestDistance));
+      for (TIndex i = 0; i < bestLength; ++i) { Insert(pos + i); }
+      pos += bestLength;
+    }
+    else
+    {
+      WriteFixedSymbol(writer, pData[pos]);
+      Insert(pos);
+      pos += 1;
+    }
+  }
+  WriteFixedSymbol(writer, 256); // End of block
+
+  // Sync flush. Empty stored block aligns stream to byte boundary.
+  writer.Write(0, 3);
+  writer.Align();
+  for (const TU8 value : {0x00, 0x00, 0xFF, 0xFF}) { oCompressed.push_back(value); }
+}
+
+/// @brief CRC-32 table of polynomial 0xEDB88320.
+const std::array<TU32, 256>& GetCrcTable()
+{
+  static const std::array<TU32, 256> table = []()
+  {
+    std::array<TU32, 256> result;
+    for (TU32 i = 0; i < 256; ++i)
+    {
+      TU32 value = i;
+      for (TU32 k = 0; k < 8; ++k) { value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1); }
+      result[i] = value;
+    }
+    return result;
+  }();
+  return table;
+}
+
+} /// anonymous namespace
+
+namespace ray::deflate
+{
+
+void CompressBlocks(const TU8* pData, TIndex size, TI32 level, std::vector<TU8>& oCompressed)
+{
+  if (size == 0) { return; }
+  if (level <= 0) { CompressStored(pData, size, oCompressed); }
+  else            { CompressFixed(pData, size, level, oCompressed); }
+}
+
+void AppendFinalBlock(std::vector<TU8>& oCompressed)
+{
+  // Empty stored block. (BFINAL = 1, BTYPE = 00, LEN = 0, NLEN = 0xFFFF)
+  for (const TU8 value : {0x01, 0x00, 0x00, 0xFF, 0xFF}) { oCompressed.push_back(value); }
+}
+
+std::vector<TU8> GetZlibHeader()
+{
+  // CM = 8 (deflate), CINFO = 7 (32K window), FCHECK makes header multiple of 31.
+  return {0x78, 0x01};
+}
+
+TU32 GetAdler32(const TU8* pData, TIndex size, TU32 adler) noexcept
+{
+  TU32 a = adler & 0xFFFF;
+  TU32 b = adler >> 16;
+  while (size > 0)
+  {
+    // 5552 is the largest count that does not overflow 32 bits before modulo.
+    const auto count = std::min<TIndex>(size, 5552);
+    for (TIndex i = 0; i < count; ++i) { a += pData[i]; b += a; }
+    a %= kAdlerBase;
+    b %= kAdlerBase;
+    pData += count;
+    size -= count;
+  }
+  return (b << 16) | a;
+}
+
+TU32 CombineAdler32(TU32 adler1, TU32 adler2, TIndex size2) noexcept
+{
+  const auto remainder = TU32(size2 % kAdlerBase);
+  TU32 sum1 = adler1 & 0xFFFF;
+  TU32 sum2 = TU32((std::uint64_t(remainder) * sum1) % kAdlerBase);
+  sum1 += (adler2 & 0xFFFF) + kAdlerBase - 1;
+  sum2 += (adler1 >> 16) + (adler2 >> 16) + kAdlerBase - remainder;
+  if (sum1 >= kAdlerBase) { sum1 -= kAdlerBase; }
+  if (sum1 >= kAdlerBase) { sum1 -= kAdlerBase; }
+  if (sum2 >= (kAdlerBase << 1)) { sum2 -= (kAdlerBase << 1); }
+  if (sum2 >= kAdlerBase) { sum2 -= kAdlerBase; }
+  return (sum2 << 16) | sum1;
+}
+
+TU32 GetCrc32(const TU8* pData, TIndex size, TU32 crc) noexcept
+{
+  const auto& table = GetCrcTable();
+  crc = ~crc;
+  for (TIndex i = 0; i < size; ++i) { crc = table[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8); }
+  return ~crc;
+}
+
+} /// ::ray::deflate namespace
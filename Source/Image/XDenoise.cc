@@ -0,0 +1,171 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <Image/XDenoise.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <Image/DAuxBuffers.hpp>
+#include <Helper/XHelperParallel.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief B3-spline kernel of à-trous wavelet transform.
+constexpr std::array<float, 5> kKernel = { 1.0f / 16, 1.0f / 4, 3.0f / 8, 1.0f / 4, 1.0f / 16 };
+/// @brief Albedo is clamped to it when radiance is divided, to avoid blowing up dark surfaces.
+constexpr float kMinAlbedo = 1e-3f;
+
+/// @struct PGuidePixel
+/// @brief Averaged features of pixel that are compared for edge-stopping weights.
+struct PGuidePixel final
+{
+  std::array<float, 3> mAlbedo;
+  std::array<float, 3> mNormal;
+  float mDepth;
+  bool mIsValid;
+};
+
+/// @brief Get squared distance of two RGB values.
+float GetSquaredDistance(const float* lhs, const float* rhs) noexcept
+{
+  const float d0 = lhs[0] - rhs[0], d1 = lhs[1] - rhs[1], d2 = lhs[2] - rhs[2];
+  return d0 * d0 + d1 * d1 + d2 * d2;
+}
+
+} /// anonymous namespace
+
+namespace ray
+{
+
+DFrameBuffer Denoise(const DFrameBuffer& buffer, const DAuxBuffers& auxBuffers, const PDenoiseParams& params)
+{
+  const auto width  = buffer.GetWidth();
+  const auto height = buffer.GetHeight();
+  assert(auxBuffers.GetAlbedo().GetWidth() == width && auxBuffers.GetAlbedo().GetHeight() == height);
+
+  // Gather guides, and demodulate albedo from radiance.
+  std::vector<PGuidePixel> guides(width * height);
+  std::vector<float> source(width * height * 3);
+  std::vector<float> target(width * height * 3);
+  ForEachRange(height, params.mThreadCount, 1, [&](TIndex rowStart, TIndex rowEnd)
+  {
+    for (TIndex y = rowStart; y < rowEnd; ++y)
+    {
+      for (TIndex x = 0; x < width; ++x)
+      {
+        const auto pixel = y * width + x;
+        auto& guide = guides[pixel];
+        const auto albedo = auxBuffers.GetAlbedo().GetAverage(x, y);
+        const auto normal = auxBuffers.GetNormal().GetAverage(x, y);
+        const auto radiance = buffer.GetAverage(x, y);
+        const auto normalLength = normal.GetLength();
+        for (TIndex i = 0; i < 3; ++i)
+        {
+          guide.mAlbedo[i] = albedo[i];
+          guide.mNormal[i] = normalLength > 0 ? normal[i] / normalLength : 0.0f;
+          source[pixel * 3 + i] = radiance[i] / std::max(albedo[i], kMinAlbedo);
+        }
+        guide.mDepth = auxBuffers.GetDepth().GetAverage(x, y)[0];
+        guide.mIsValid = buffer.GetSampleCount(x, y) != 0;
+      }
+    }
+  });
+
+  // Each pass doubles step between taps, so wide footprint is covered with only 25 taps per pass.
+  const float invNormalSigma2 = 1.0f / std::max(params.mNormalSigma * params.mNormalSigma, 1e-8f);
+  const float invAlbedoSigma2 = 1.0f / std::max(params.mAlbedoSigma * params.mAlbedoSigma, 1e-8f);
+  const float invDepthSigma   = 1.0f / std::max(params.mDepthSigma, 1e-8f);
+  for (TIndex iteration = 0; iteration < params.mIterationCount; ++iteration)
+  {
+    const auto step = TI32(1) << iteration;
+    const float colorSigma = params.mColorSigma / float(1u << iteration);
+    const float invColorSigma2 = 1.0f / std::max(colorSigma * colorSigma, 1e-8f);
+
+    ForEachRange(height, params.mThreadCount, 1, [&](TIndex rowStart, TIndex rowEnd)
+    {
+      for (TIndex y = rowStart; y < rowEnd; ++y)
+      {
+        for (TIndex x = 0; x < width; ++x)
+        {
+          const auto pixel = y * width + x;
+          const auto& center = guides[pixel];
+          const float* pCenter = &source[pixel * 3];
+          float* pOut = &target[pixel * 3];
+          if (center.mIsValid == false) { std::copy(pCenter, pCenter + 3, pOut); continue; }
+
+          float sum[3] = { 0, 0, 0 };
+          float weightSum = 0;
+          const float depthScale = invDepthSigma / std::max(center.mDepth, 1e-3f);
+          for (TI32 dy = -2; dy <= 2; ++dy)
+          {
+            const auto ty = TI32(y) + dy * step;
+            if (ty < 0 || ty >= TI32(height)) { continue; }
+            for (TI32 dx = -2; dx <= 2; ++dx)
+            {
+              const auto tx = TI32(x) + dx * step;
+              if (tx < 0 || tx >= TI32(width)) { continue; }
+
+              const auto tap = TIndex(ty) * width + TIndex(tx);
+              const auto& guide = guides[tap];
+              if (guide.mIsValid == false) { continue; }
+
+              const float* pTap = &source[tap * 3];
+              const float depthDiff = (guide.mDepth - center.mDepth) * depthScale;
+              const float exponent = 
+                  GetSquaredDistance(pCenter, pTap) * invColorSigma2
+                + GetSquaredDistance(center.mNormal.data(), guide.mNormal.data()) * invNormalSigma2
+                + GetSquaredDistance(center.mAlbedo.data(), guide.mAlbedo.data()) * invAlbedoSigma2
+                + depthDiff * depthDiff;
+              const float weight = kKernel[dx + 2] * kKernel[dy + 2] * std::exp(-exponent);
+
+              for (TIndex i = 0; i < 3; ++i) { sum[i] += pTap[i] * weight; }
+              weightSum += weight;
+            }
+          }
+
+          // Center tap always has positive weight, so weight sum is not zero.
+          for (TIndex i = 0; i < 3; ++i) { pOut[i] = sum[i] / weightSum; }
+        }
+      }
+    });
+    source.swap(target);
+  }
+
+  // Modulate albedo back, and keep sample counts so filtered buffer can be exported like rendered one.
+  DFrameBuffer result{width, height, buffer.GetOrigin()};
+  for (TIndex y = 0; y < height; ++y)
+  {
+    for (TIndex x = 0; x < width; ++x)
+    {
+      const auto pixel = y * width + x;
+      const auto count = buffer.GetSampleCount(x, y);
+      if (count == 0) { continue; }
+
+      DVec3 radiance{0};
+      for (TIndex i = 0; i < 3; ++i)
+      {
+        radiance[i] = source[pixel * 3 + i] * std::max(guides[pixel].mAlbedo[i], kMinAlbedo);
+      }
+      result.AddSamples(x, y, radiance * TReal(count), count);
+    }
+  }
+  return result;
+}
+
+} /// ::ray namespace
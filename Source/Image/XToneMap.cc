@@ -0,0 +1,137 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Image/XToneMap.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <Image/DFrameBuffer.hpp>
+#include <Helper/XHelperParallel.hpp>
+#include <Simd/XKernelTable.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief The count of intervals of transfer table.
+constexpr TIndex kTransferIntervalCount = 1024;
+
+/// @brief Encode linear display value with transfer function of parameters.
+float GetTransferred(float linear, const PToneMapParams& params)
+{
+  if (params.mTransfer == ETransferFunction::SRGB)
+  {
+    return linear <= 0.0031308f ? 12.92f * linear : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+  }
+  return std::pow(linear, 1.0f / float(params.mGamma));
+}
+
+/// @brief Hash pixel position and channel into quantization offset in [0, 1).
+float GetDitherOffset(TIndex x, TIndex y, TIndex channel) noexcept
+{
+  TU32 hash = (TU32(x) * 0x8DA6B343u) ^ (TU32(y) * 0xD8163841u) ^ (TU32(channel) * 0xCB1AB31Fu);
+  hash ^= hash >> 16; hash *= 0x7FEB352Du;
+  hash ^= hash >> 15; hash *= 0x846CA68Bu;
+  hash ^= hash >> 16;
+  return float(hash >> 8) * (1.0f / 16777216.0f);
+}
+
+} /// anonymous namespace
+
+namespace ray
+{
+
+DToneMapper::DToneMapper(const PToneMapParams& params)
+  : mParams { params },
+    mTransferTable (kTransferIntervalCount + 1)
+{
+  for (TIndex i = 0; i <= kTransferIntervalCount; ++i)
+  {
+    const auto root = float(i) / float(kTransferIntervalCount);
+    const auto linear = (root * root) * (root * root);
+    this->mTransferTable[i] = std::clamp(GetTransferred(linear, params), 0.0f, 1.0f);
+  }
+}
+
+void DToneMapper::MapRows(const DFrameBuffer& buffer, TIndex rowStart, TIndex rowCount, TU8* oRgb) const
+{
+  this->MapRowsOf(buffer, rowStart, rowCount, oRgb);
+}
+
+void DToneMapper::MapRows(const DFrameBuffer& buffer, TIndex rowStart, TIndex rowCount, TU16* oRgb) const
+{
+  this->MapRowsOf(buffer, rowStart, rowCount, oRgb);
+}
+
+template <typename TValue>
+void DToneMapper::MapRowsOf(const DFrameBuffer& buffer, TIndex rowStart, TIndex rowCount, TValue* oRgb) const
+{
+  assert(rowStart + rowCount <= buffer.GetHeight());
+  constexpr auto kMaxValue = float(std::numeric_limits<TValue>::max());
+  const auto width = buffer.GetWidth();
+  const auto exposureScale = std::exp2(float(this->mParams.mExposure));
+  const auto& kernels = simd::GetKernelTable();
+
+  std::vector<float> scales(width * 3);
+  std::vector<float> roots(width * 3);
+  for (TIndex row = 0; row < rowCount; ++row)
+  {
+    // Exposure and average are folded into one scale per value, so kernel only sees flat float arrays.
+    // Pixel that has no sample is regarded as black.
+    const auto y = rowStart + row;
+    const TU32* pCounts = buffer.GetSampleCountRow(y);
+    for (TIndex x = 0; x < width; ++x)
+    {
+      const auto scale = pCounts[x] != 0 ? exposureScale / float(pCounts[x]) : 0.0f;
+      for (TIndex i = 0; i < 3; ++i) { scales[x * 3 + i] = scale; }
+    }
+    kernels.mToneMapValues(buffer.GetSumRow(y), scales.data(), width * 3, this->mParams.mOperator, roots.data());
+
+    // Round to nearest, or to neighbor values with hashed offset when dithering.
+    // Offset is hashed with image position, so tiles of image get the same pattern as whole image.
+    const auto& origin = buffer.GetOrigin();
+    TValue* pRow = &oRgb[row * width * 3];
+    for (TIndex i = 0, size = width * 3; i < size; ++i)
+    {
+      const auto offset = this->mParams.mIsDithering == true ? GetDitherOffset(origin.X + i / 3, origin.Y + y, i % 3) : 0.5f;
+      const auto value = std::floor(this->GetEncoded(roots[i]) * kMaxValue + offset);
+      pRow[i] = TValue(std::min(value, kMaxValue));
+    }
+  }
+}
+
+float DToneMapper::GetEncoded(float root) const noexcept
+{
+  const auto position = root * float(kTransferIntervalCount);
+  const auto index = std::min(TIndex(position), kTransferIntervalCount - 1);
+  const auto ratio = position - float(index);
+  return this->mTransferTable[index] + (this->mTransferTable[index + 1] - this->mTransferTable[index]) * ratio;
+}
+
+std::vector<TU8> ToneMapToRgb8(const DFrameBuffer& buffer, const PToneMapParams& params, TIndex threadCount)
+{
+  const auto width  = buffer.GetWidth();
+  const auto height = buffer.GetHeight();
+  std::vector<TU8> result(width * height * 3);
+
+  // Split rows into one band per thread.
+  const DToneMapper mapper{params};
+  ForEachRange(height, threadCount, 1, [&](TIndex rowStart, TIndex rowEnd)
+  {
+    mapper.MapRows(buffer, rowStart, rowEnd - rowStart, &result[rowStart * width * 3]);
+  });
+  return result;
+}
+
+} /// ::ray namespace
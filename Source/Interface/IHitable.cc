@@ -12,6 +12,7 @@
 ///
 
 #include <Interface/IHitable.hpp>
+#include <Simd/DRayPacket.hpp>
 
 namespace ray
 {
@@ -42,4 +43,16 @@ const DAABB* IHitable::GetAABB() const noexcept
   return this->mAABB.get(); 
 }
 
+void IHitable::GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const
+{
+  for (TIndex lane = 0; activeMask != 0; ++lane, activeMask >>= 1)
+  {
+    if ((activeMask & 1) == 0) { continue; }
+
+    const auto optTValues = this->GetRayIntersectedTValues(packet.mRays[lane]);
+    if (optTValues.has_value() == false) { continue; }
+    for (const auto& item : *optTValues) { ioHits.TryUpdate(lane, item); }
+  }
+}
+
 } /// ::ray namespace
\ No newline at end of file
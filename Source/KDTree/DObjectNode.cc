@@ -12,29 +12,33 @@
 ///
 
 #include <KDTree/DObjectNode.hpp>
+#include <algorithm>
 #include <Math/Utility/XShapeMath.h>
-#include <Resource/DModelFace.hpp>
+#include <Simd/DRayPacket.hpp>
+#include <Simd/XPacketKernel.hpp>
+#include <KDTree/XTraversalStats.hpp>
 
 namespace ray
 {
 
-void DObjectNode::BuildTree(const std::vector<const IHitable*>& pObjects)
+void DObjectNode::BuildTree(TArena& arena, const std::vector<const IHitable*>& pObjects)
 {
-  this->mpObjects = pObjects;
-  if (this->mpObjects.empty() == true) { return; }
-  if (this->mpObjects.size() == 1)
-  {
-    this->mOverallBoundingBox = *this->mpObjects.front()->GetAABB();
-  }
+  auto pRangeObjects = pObjects;
+  this->BuildTree(arena, pRangeObjects.data(), pRangeObjects.size());
+}
+
+void DObjectNode::BuildTree(TArena& arena, const IHitable** pObjects, TIndex count)
+{
+  if (count == 0) { return; }
 
   // First, make overall bounding box from given pObjects (all items are valid)
   {
     using ::dy::math::GetUnionOf;
 
-    DAABB aabb = *this->mpObjects.front()->GetAABB();
-    for (TIndex i = 1, size = this->mpObjects.size(); i < size; ++i)
+    DAABB aabb = *pObjects[0]->GetAABB();
+    for (TIndex i = 1; i < count; ++i)
     {
-      aabb = GetUnionOf(aabb, *this->mpObjects[i]->GetAABB());
+      aabb = GetUnionOf(aabb, *pObjects[i]->GetAABB());
     }
     this->mOverallBoundingBox = aabb;
   }
@@ -60,48 +64,38 @@ void DObjectNode::BuildTree(const std::vector<const IHitable*>& pObjects)
   // Get Overall AABB's center point as a criteria.
   const DVec3 center = (this->mOverallBoundingBox.GetMin() + this->mOverallBoundingBox.GetMax()) / 2;
  
-  // Group left child and right child following by aabb center point and axis.
-  std::vector<const IHitable*> leftChildObjs;
-  std::vector<const IHitable*> rightChildObjs;
-  const auto basisValue = center[static_cast<std::underlying_type_t<EAxis>>(axis)];
-  for (const auto& pObject : this->mpObjects)
-  {
-    // Get center point of given object's aabb.
-    const auto& aabb = pObject->GetAABB();
-    assert(aabb != nullptr);
-    const DVec3 targetCenter = (aabb->GetMin() + aabb->GetMax()) / 2;
-
-    // Compare with `basisValue` and insert pointer into child object list.
-    const auto targetValue = targetCenter[static_cast<std::underlying_type_t<EAxis>>(axis)];
-    if (targetValue < basisValue) { leftChildObjs.emplace_back(pObject); }
-    else                          { rightChildObjs.emplace_back(pObject); }
-  }
+  // Partition object range in place into left child and right child following by aabb center point and axis.
+  const auto axisId = static_cast<std::underlying_type_t<EAxis>>(axis);
+  const auto basisValue = center[axisId];
+  auto** pMiddle = std::partition(pObjects, pObjects + count, 
+    [axisId, basisValue](const IHitable* pObject)
+    {
+      // Get center point of given object's aabb.
+      const auto& aabb = pObject->GetAABB();
+      assert(aabb != nullptr);
+      const DVec3 targetCenter = (aabb->GetMin() + aabb->GetMax()) / 2;
+      return targetCenter[axisId] < basisValue;
+    });
+  const TIndex leftCount = pMiddle - pObjects;
 
   // Third, check recursive building condition afterward pre-process.
-  if (leftChildObjs.empty() == true && rightChildObjs.size() > 0) { leftChildObjs = rightChildObjs; }
-  if (rightChildObjs.empty() == true && leftChildObjs.size() > 0) { rightChildObjs = leftChildObjs; }
-
-  // Get match counts.
-  TIndex matches = 0;
-  for (const auto& pLeft : leftChildObjs)
+  // If all objects are placed in one side, splitting can not make progress anymore.
+  if (leftCount > 0 && leftCount < count)
   {
-    for (const auto& pRight : rightChildObjs)
-    {
-      if (pLeft == pRight) { matches++; }
-    }
+    auto& leftNode = arena.CreateNode();
+    leftNode.BuildTree(arena, pObjects, leftCount);
+    this->mLeftNode = &leftNode;
+
+    auto& rightNode = arena.CreateNode();
+    rightNode.BuildTree(arena, pMiddle, count - leftCount);
+    this->mRightNode = &rightNode;
+    return;
   }
 
-  // Check condition. If satisfied, try to call child building sequence recursively.
-  const TReal leftCond  = (TReal)matches / leftChildObjs.size();
-  const TReal rightCond = (TReal)matches / rightChildObjs.size();
-  if (leftCond < 0.5f && rightCond < 0.5f)
-  {
-    this->mLeftNode = std::make_unique<DObjectNode>();
-    this->mLeftNode->BuildTree(leftChildObjs);
-
-    this->mRightNode = std::make_unique<DObjectNode>();
-    this->mRightNode->BuildTree(rightChildObjs);
-  }
+  // If this node is leaf, copy object pointers into arena.
+  auto* pItems = arena.CreateItems(count);
+  std::copy(pObjects, pObjects + count, pItems);
+  this->mpObjects = {pItems, count};
 }
 
 IHitable::TValueResults DObjectNode::GetIntersectedTriangleTValue(const DRay& ray) const
@@ -111,6 +105,8 @@ IHitable::TValueResults DObjectNode::GetIntersectedTriangleTValue(const DRay& ra
   // If not, we just forward `localRay` into children.
   if (this->mLeftNode != nullptr || this->mRightNode != nullptr)
   {
+    GetThreadTraversalStats().mNodeVisitCount += 1;
+
     // Check AABB optionally. If not passed, regard ray as not intersecting potential overall AABB region.
     if (IsRayIntersected(ray, this->mOverallBoundingBox) == false) { return {}; }
 
@@ -140,4 +136,42 @@ IHitable::TValueResults DObjectNode::GetIntersectedTriangleTValue(const DRay& ra
   return tResult;
 }
 
+void DObjectNode::GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const
+{
+  // Check It is leaf node or not. If leaf node, forward packet into each object.
+  if (this->mLeftNode != nullptr || this->mRightNode != nullptr)
+  {
+    GetThreadTraversalStats().mNodeVisitCount += 1;
+
+    // Check AABB. Lanes that do not pass are regarded as not intersecting potential overall AABB region.
+    activeMask = simd::IntersectPacketAABB(packet, this->mOverallBoundingBox, activeMask, ioHits.mT.data());
+    if (activeMask == 0) { return; }
+
+    // If only few lanes are remained, trace them as single rays.
+    if (simd::IsPacketDiverged(packet, activeMask) == true)
+    {
+      for (TIndex lane = 0, width = packet.GetWidth(); lane < width; ++lane)
+      {
+        if ((activeMask & (1u << lane)) == 0) { continue; }
+        for (const auto& item : this->GetIntersectedTriangleTValue(packet.mRays[lane])) 
+        { 
+          ioHits.TryUpdate(lane, item); 
+        }
+      }
+      return;
+    }
+
+    assert(this->mLeftNode != nullptr);
+    assert(this->mRightNode != nullptr);
+    this->mLeftNode->GetPacketIntersections(packet, activeMask, ioHits);
+    this->mRightNode->GetPacketIntersections(packet, activeMask, ioHits);
+    return;
+  }
+
+  for (const auto& pObject : this->mpObjects)
+  {
+    pObject->GetPacketIntersections(packet, activeMask, ioHits);
+  }
+}
+
 } /// ::ray namespace
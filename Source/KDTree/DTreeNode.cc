@@ -12,43 +12,123 @@
 ///
 
 #include <KDTree/DTreeNode.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
 #include <Math/Utility/XShapeMath.h>
-#include <Resource/DModelFace.hpp>
+#include <Resource/DModelTriangle.hpp>
+#include <Simd/DRayPacket.hpp>
+#include <Simd/XPacketKernel.hpp>
+#include <KDTree/XTraversalStats.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief Test given local ray against triangle block with SIMD kernel.
+/// When `SH_RAY_VALIDATE_KERNELS` is defined, result is compared with scalar reference kernel.
+TU32 IntersectTriangleBlock(const DRay& localRay, const DTriangleBlock& block, float tMax, float* oT)
+{
+  const auto& rayOrigin = localRay.GetOrigin();
+  const auto& rayDirection = localRay.GetDirection();
+  const float origin[3] = { rayOrigin.X, rayOrigin.Y, rayOrigin.Z };
+  const float direction[3] = { rayDirection.X, rayDirection.Y, rayDirection.Z };
+  const auto hitMask = simd::IntersectRayTriangles(origin, direction, block, tMax, oT);
+
+#if defined(SH_RAY_VALIDATE_KERNELS)
+  float referenceT[DTriangleBlock::kWidth];
+  const auto referenceMask = block.IntersectReference(localRay, tMax, referenceT);
+  for (TIndex lane = 0; lane < block.mCount; ++lane)
+  {
+    const auto bit = 1u << lane;
+    const bool isMismatched = (hitMask & bit) != (referenceMask & bit)
+      || ((hitMask & bit) != 0 && std::abs(oT[lane] - referenceT[lane]) > 1e-4f * std::max(1.0f, referenceT[lane]));
+    if (isMismatched == false) { continue; }
+
+    std::cerr << "Triangle kernel mismatch on lane " << lane << " : SIMD "
+      << (((hitMask & bit) != 0) ? oT[lane] : -1.0f) << ", Reference "
+      << (((referenceMask & bit) != 0) ? referenceT[lane] : -1.0f) << '\n';
+  }
+#endif
+
+  return hitMask;
+}
+
+} /// anonymous namespace
 
 namespace ray
 {
 
-void DTreeNode::BuildTree(const std::vector<const DModelFace*>& pTriangles)
+/// @struct DTreeNode::PBuildContext
+/// @brief Temporary per-triangle data that is only used while building tree.
+struct DTreeNode::PBuildContext final
 {
-  this->mTriangles = pTriangles;
-  if (this->mTriangles.empty() == true) { return; }
-  if (this->mTriangles.size() == 1)
+  TArena& mArena;
+  PArrayView<DModelTriangle> mTriangles;
+  PArrayView<DVec3> mVertices;
+  std::vector<DAABB> mBounds;
+  std::vector<DVec3> mCentroids;
+
+  /// @brief Create triangle blocks of given triangle range from arena.
+  PItemRange<DTriangleBlock> CreateBlocks(const TU32* pTriangleIds, TIndex count)
   {
-    this->mOverallBoundingBox = pTriangles.front()->mTriangleAABB;
-    for (const auto& vertex : pTriangles.front()->mVertex)
-    {
-      assert(vertex != nullptr);
-      this->mBarycentric += *vertex;
-    }
-    this->mBarycentric /= 3;
+    PItemRange<DTriangleBlock> blocks;
+    blocks.mCount = DTriangleBlock::GetBlockCount(count);
+    auto* pBlocks = this->mArena.CreateItems(blocks.mCount);
+    DTriangleBlock::CreateBlocks(pTriangleIds, count, this->mTriangles, this->mVertices, pBlocks);
+    blocks.mpBegin = pBlocks;
+    return blocks;
+  }
+};
+
+void DTreeNode::BuildTree(TArena& arena, PArrayView<DModelTriangle> triangles, PArrayView<DVec3> vertices)
+{
+  PBuildContext context = {arena, triangles, vertices, {}, {}};
+  context.mBounds.reserve(triangles.size());
+  context.mCentroids.reserve(triangles.size());
+
+  std::vector<TU32> triangleIds(triangles.size());
+  for (TIndex i = 0, size = triangles.size(); i < size; ++i)
+  {
+    const auto& v0 = vertices[triangles[i].mVertex[0]];
+    const auto& v1 = vertices[triangles[i].mVertex[1]];
+    const auto& v2 = vertices[triangles[i].mVertex[2]];
+    context.mBounds.emplace_back(DAABB{{v0, v1, v2}});
+    context.mCentroids.emplace_back((v0 + v1 + v2) / 3);
+    triangleIds[i] = TU32(i);
+  }
+
+  this->BuildTree(context, triangleIds.data(), triangleIds.size());
+}
+
+void DTreeNode::BuildTree(PBuildContext& context, TU32* pTriangleIds, TIndex count)
+{
+  if (count == 0) { return; }
+  if (count == 1)
+  {
+    this->mOverallBoundingBox = context.mBounds[pTriangleIds[0]];
+    this->mBarycentric = context.mCentroids[pTriangleIds[0]];
+    this->mTriangleBlocks = context.CreateBlocks(pTriangleIds, count);
     return;
   }
 
-  // First, make overall bounding box from given pTriangles (all items are valid)
+  // First, make overall bounding box from given triangles (all items are valid)
   {
     using ::dy::math::GetUnionOf;
 
-    DAABB aabb = this->mTriangles.front()->mTriangleAABB;
-    for (TIndex i = 1, size = this->mTriangles.size(); i < size; ++i)
+    DAABB aabb = context.mBounds[pTriangleIds[0]];
+    for (TIndex i = 1; i < count; ++i)
     {
-      aabb = GetUnionOf(aabb, this->mTriangles[i]->mTriangleAABB);
+      aabb = GetUnionOf(aabb, context.mBounds[pTriangleIds[i]]);
     }
     this->mOverallBoundingBox = aabb;
   }
 
   // Second, Check what axis of given DAABB is longest, so set axis as basis axis of child.
-  // LeftNode's pTriangle list is list for triangle that barycentric point's given axis is less than overall barycentric.
-  // RightNode's pTriangle list is for equal or bigger than.
+  // LeftNode's triangle list is list for triangle that barycentric point's given axis is less than overall barycentric.
+  // RightNode's triangle list is for equal or bigger than.
 
   // Get axis value from overall AABB.
   using ::dy::math::EAxis;
@@ -66,68 +146,120 @@ void DTreeNode::BuildTree(const std::vector<const DModelFace*>& pTriangles)
   
   // Get Overall barycentric point.
   DVec3 barycentric = DVec3{};
-  for (const auto& pFace : this->mTriangles)
-  {
-    assert(pFace != nullptr);
-    for (const auto& vertex : pFace->mVertex)
-    {
-      assert(vertex != nullptr);
-      barycentric += *vertex;
-    }
-  }
-  barycentric /= TReal(this->mTriangles.size() * 3); 
+  for (TIndex i = 0; i < count; ++i) { barycentric += context.mCentroids[pTriangleIds[i]]; }
+  barycentric /= TReal(count); 
   this->mBarycentric = barycentric;
   
-  // Group left child and right child following by barycentric and axis.
-  std::vector<const DModelFace*> leftChildTriangles;
-  std::vector<const DModelFace*> rightChildTriangles;
-  const auto basisValue = barycentric[static_cast<std::underlying_type_t<EAxis>>(axis)];
-  for (const auto& pFace : this->mTriangles)
-  {
-    // Get barycentric of pFace vertices.
-    DVec3 targetBarycentric = DVec3{};
-    for (const auto& vertex : pFace->mVertex)
-    {
-      assert(vertex != nullptr);
-      targetBarycentric += *vertex;
-    }
-    targetBarycentric /= 3;
+  // Partition triangle range in place into left child and right child following by barycentric and axis.
+  const auto axisId = static_cast<std::underlying_type_t<EAxis>>(axis);
+  const auto basisValue = barycentric[axisId];
+  auto* pMiddle = std::partition(pTriangleIds, pTriangleIds + count, 
+    [&context, axisId, basisValue](TU32 id) { return context.mCentroids[id][axisId] < basisValue; });
+  const TIndex leftCount = pMiddle - pTriangleIds;
+
+  // Third, check recursive building condition afterward pre-process.
+  // If all triangles are placed in one side, splitting can not make progress anymore.
+  if (leftCount > 0 && leftCount < count)
+  {
+    auto& leftNode = context.mArena.CreateNode();
+    leftNode.BuildTree(context, pTriangleIds, leftCount);
+    this->mLeftNode = &leftNode;
 
-    // Compare with `basisValue` and insert pointer into child triangle list.
-    const auto targetValue = targetBarycentric[static_cast<std::underlying_type_t<EAxis>>(axis)];
-    if (targetValue < basisValue) { leftChildTriangles.emplace_back(pFace); }
-    else                          { rightChildTriangles.emplace_back(pFace); }
+    auto& rightNode = context.mArena.CreateNode();
+    rightNode.BuildTree(context, pMiddle, count - leftCount);
+    this->mRightNode = &rightNode;
+    return;
   }
 
-  // Third, check recursive building condition afterward pre-process.
-  if (leftChildTriangles.empty() == true && rightChildTriangles.size() > 0) { leftChildTriangles = rightChildTriangles; }
-  if (rightChildTriangles.empty() == true && leftChildTriangles.size() > 0) { rightChildTriangles = leftChildTriangles; }
- 
-  // Get match counts.
-  TIndex matches = 0;
-  for (const auto& pLeftFace : leftChildTriangles)
-  {
-    for (const auto& pRightFace : rightChildTriangles)
-    {
-      if (pLeftFace == pRightFace) { matches++; }
+  // If this node is leaf, precompute triangle records for vectorized intersection.
+  this->mTriangleBlocks = context.CreateBlocks(pTriangleIds, count);
+}
+
+void DTreeNode::Flatten(std::vector<PFlatNode>& oNodes, std::vector<DTriangleBlock>& oBlocks) const
+{
+  // Reserve node first, so children are placed after parent.
+  // Node reference must be retrieved after recursion because container may be reallocated.
+  const auto index = oNodes.size();
+  oNodes.emplace_back();
+
+  PFlatNode node;
+  const auto& min = this->mOverallBoundingBox.GetMin();
+  const auto& max = this->mOverallBoundingBox.GetMax();
+  for (TIndex axis = 0; axis < 3; ++axis) { node.mMin[axis] = min[axis]; node.mMax[axis] = max[axis]; }
+
+  if (this->IsLeaf() == false)
+  {
+    node.mLeft = TU32(oNodes.size());
+    this->mLeftNode->Flatten(oNodes, oBlocks);
+    node.mRight = TU32(oNodes.size());
+    this->mRightNode->Flatten(oNodes, oBlocks);
+  }
+  else
+  {
+    node.mBlockBegin = TU32(oBlocks.size());
+    node.mBlockCount = TU32(this->mTriangleBlocks.size());
+    oBlocks.insert(oBlocks.end(), this->mTriangleBlocks.begin(), this->mTriangleBlocks.end());
+  }
+  oNodes[index] = node;
+}
+
+void DTreeNode::Restore(TArena& arena, PArrayView<PFlatNode> nodes, const DTriangleBlock* pBlocks)
+{
+  assert(nodes.empty() == false);
+
+  // Nodes are created in pre-order as the same as building, but with explicit stack instead of recursion.
+  // Stack has child pointer of parent to be linked, and index of child node.
+  std::vector<std::pair<const DTreeNode**, TU32>> stack;
+  const auto RestoreNode = [&stack, &nodes, pBlocks](DTreeNode& target, TU32 index)
+  {
+    const auto& node = nodes[index];
+    target.mOverallBoundingBox = DAABB{
+      DVec3{node.mMin[0], node.mMin[1], node.mMin[2]}, 
+      DVec3{node.mMax[0], node.mMax[1], node.mMax[2]}};
+
+    // Leaf refers to blocks of given storage directly.
+    if (node.mLeft == PFlatNode::kNone) 
+    { 
+      target.mTriangleBlocks = {pBlocks + node.mBlockBegin, node.mBlockCount}; 
+      return;
     }
+    stack.emplace_back(&target.mRightNode, node.mRight);
+    stack.emplace_back(&target.mLeftNode, node.mLeft);
+  };
+
+  RestoreNode(*this, 0);
+  while (stack.empty() == false)
+  {
+    const auto [ppChild, index] = stack.back();
+    stack.pop_back();
+
+    auto& child = arena.CreateNode();
+    *ppChild = &child;
+    RestoreNode(child, index);
   }
+}
 
-  // Check condition. If satisfied, try to call child building sequence recursively.
-  const TReal leftCond  = (TReal)matches / leftChildTriangles.size();
-  const TReal rightCond = (TReal)matches / rightChildTriangles.size();
-  if (leftCond < 0.5f && rightCond < 0.5f)
+TIndex DTreeNode::GetDepth() const
+{
+  TIndex depth = 0;
+  std::vector<std::pair<const DTreeNode*, TIndex>> stack = { {this, 1} };
+  while (stack.empty() == false)
   {
-    this->mLeftNode = std::make_unique<DTreeNode>();
-    this->mLeftNode->BuildTree(leftChildTriangles);
+    const auto [pNode, nodeDepth] = stack.back();
+    stack.pop_back();
 
-    this->mRightNode = std::make_unique<DTreeNode>();
-    this->mRightNode->BuildTree(rightChildTriangles);
+    depth = std::max(depth, nodeDepth);
+    if (pNode->IsLeaf() == true) { continue; }
+    stack.emplace_back(pNode->mRightNode, nodeDepth + 1);
+    stack.emplace_back(pNode->mLeftNode, nodeDepth + 1);
   }
+  return depth;
 }
 
 std::vector<PTriangleResult> DTreeNode::GetIntersectedTriangleTValue(const DRay& localRay) const
 {
+  GetThreadTraversalStats().mNodeVisitCount += 1;
+
   // Check AABB. If not passed, regard ray as not intersecting potential overall AABB region.
   using ::dy::math::IsRayIntersected;
   if (IsRayIntersected(localRay, this->mOverallBoundingBox) == false) { return {}; }
@@ -147,48 +279,102 @@ std::vector<PTriangleResult> DTreeNode::GetIntersectedTriangleTValue(const DRay&
     return tResult;
   }
 
-  // If node is left, use moller algorithm to triangles.
-  // Use Möller–Trumbore intersection algorithm
-  // https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
+  // If node is leaf, use moller algorithm to triangle blocks.
   std::vector<PTriangleResult> tResult;
-  for (const auto& pTriangle : this->mTriangles)
+  for (const auto& block : this->mTriangleBlocks)
+  {
+    alignas(32) float t[DTriangleBlock::kWidth];
+    const auto hitMask = IntersectTriangleBlock(localRay, block, std::numeric_limits<float>::max(), t);
+    for (TIndex lane = 0; lane < block.mCount; ++lane)
+    {
+      if ((hitMask & (1u << lane)) == 0) { continue; }
+
+      PTriangleResult result;
+      result.mT = t[lane];
+      result.mTriangle = block.mTriangle[lane];
+      tResult.emplace_back(std::move(result));
+    }
+  }
+  
+  return tResult;
+}
+
+std::optional<TU32> DTreeNode::GetClosestLeafTriangle(const DRay& localRay, float& ioTMax) const
+{
+  assert(this->IsLeaf() == true);
+
+  std::optional<TU32> closest = std::nullopt;
+  for (const auto& block : this->mTriangleBlocks)
   {
-    using dy::math::Cross;
-    using dy::math::Dot;
-    using dy::math::IsNearlyZero;
-    using ray::TReal;
-    using ray::DVec3;
-    constexpr ray::TReal e = ray::TReal(1e-5);
+    alignas(32) float t[DTriangleBlock::kWidth];
+    const auto hitMask = IntersectTriangleBlock(localRay, block, ioTMax, t);
+    for (TIndex lane = 0; lane < block.mCount; ++lane)
+    {
+      if ((hitMask & (1u << lane)) == 0 || t[lane] >= ioTMax) { continue; }
 
-    const DVec3 edge1 = *pTriangle->mVertex[1] - *pTriangle->mVertex[0];
-    const DVec3 edge2 = *pTriangle->mVertex[2] - *pTriangle->mVertex[0];
+      ioTMax = t[lane];
+      closest = block.mTriangle[lane];
+    }
+  }
 
-    const DVec3 h = Cross(localRay.GetDirection(), edge2);
-    const auto a = Dot(edge1, h);
+  return closest;
+}
 
-    // If ray is parallel, just do next triangle.
-    if (IsNearlyZero(a) == true) { continue; }
+void DTreeNode::GetPacketClosestTriangles(
+  const DRayPacket& localPacket, 
+  TU32 activeMask, 
+  DTrianglePacketHits& ioHits) const
+{
+  GetThreadTraversalStats().mNodeVisitCount += 1;
 
-    const TReal f = 1 / a;
-    const DVec3 s = localRay.GetOrigin() - *pTriangle->mVertex[0];
-    const TReal u = f * Dot(s, h);
-    if (u < 0 || u > 1) { continue; }
+  // Check AABB. Lanes that do not pass are regarded as not intersecting potential overall AABB region.
+  activeMask = simd::IntersectPacketAABB(localPacket, this->mOverallBoundingBox, activeMask, ioHits.mT.data());
+  if (activeMask == 0) { return; }
 
-    const DVec3 q = Cross(s, edge1);
-    const TReal v = f * Dot(localRay.GetDirection(), q);
-    if (v < 0 || u + v > 1) { continue; }
+  // If only few lanes are remained, trace them as single rays.
+  if (simd::IsPacketDiverged(localPacket, activeMask) == true)
+  {
+    for (TIndex lane = 0, width = localPacket.GetWidth(); lane < width; ++lane)
+    {
+      if ((activeMask & (1u << lane)) == 0) { continue; }
 
-    // We can find `t` to find out where the intersection point is on the line.
-    const TReal t = f * Dot(edge2, q);
-    if (t < 0) { continue; }
+      for (const auto& [t, triangle] : this->GetIntersectedTriangleTValue(localPacket.mRays[lane]))
+      {
+        if (t <= 0.0f || t >= ioHits.mT[lane]) { continue; }
+        ioHits.mT[lane] = t;
+        ioHits.mTriangle[lane] = triangle;
+        ioHits.mHitMask |= 1u << lane;
+      }
+    }
+    return;
+  }
 
-    PTriangleResult result;
-    result.mT = t;
-    result.mIndex = pTriangle->mIndex;
-    tResult.emplace_back(std::move(result));
+  // Check It is leaf node or not. If not, we just forward `localPacket` into children.
+  if (this->mLeftNode != nullptr || this->mRightNode != nullptr)
+  {
+    assert(this->mLeftNode != nullptr);
+    assert(this->mRightNode != nullptr);
+    this->mLeftNode->GetPacketClosestTriangles(localPacket, activeMask, ioHits);
+    this->mRightNode->GetPacketClosestTriangles(localPacket, activeMask, ioHits);
+    return;
+  }
+
+  // If node is leaf, test all lanes with each triangle of blocks at once.
+  for (const auto& block : this->mTriangleBlocks)
+  {
+    for (TIndex triangleLane = 0; triangleLane < block.mCount; ++triangleLane)
+    {
+      const auto hitMask = simd::IntersectPacketTriangle(
+        localPacket, block, triangleLane, activeMask, ioHits.mT.data());
+      if (hitMask == 0) { continue; }
+
+      for (TIndex lane = 0, width = localPacket.GetWidth(); lane < width; ++lane)
+      {
+        if ((hitMask & (1u << lane)) != 0) { ioHits.mTriangle[lane] = block.mTriangle[triangleLane]; }
+      }
+      ioHits.mHitMask |= hitMask;
+    }
   }
-  
-  return tResult;
 }
 
 } /// ::ray namespace
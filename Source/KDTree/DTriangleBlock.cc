@@ -0,0 +1,95 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <KDTree/DTriangleBlock.hpp>
+#include <Resource/DModelTriangle.hpp>
+
+namespace ray
+{
+
+void DTriangleBlock::CreateBlocks(
+  const TU32* pTriangleIds, TIndex count,
+  PArrayView<DModelTriangle> triangles,
+  PArrayView<DVec3> vertices,
+  DTriangleBlock* oBlocks)
+{
+  for (TIndex i = 0, size = GetBlockCount(count); i < size; ++i)
+  {
+    auto& block = oBlocks[i];
+    for (TIndex axis = 0; axis < 3; ++axis)
+    {
+      block.mV0[axis].fill(0);
+      block.mEdge1[axis].fill(0);
+      block.mEdge2[axis].fill(0);
+    }
+    block.mTriangle.fill(0);
+    block.mCount = 0;
+  }
+
+  for (TIndex i = 0; i < count; ++i)
+  {
+    const auto& triangle = triangles[pTriangleIds[i]];
+    auto& block = oBlocks[i / kWidth];
+    const auto lane = i % kWidth;
+
+    const DVec3& v0 = vertices[triangle.mVertex[0]];
+    const DVec3 edge1 = vertices[triangle.mVertex[1]] - v0;
+    const DVec3 edge2 = vertices[triangle.mVertex[2]] - v0;
+    for (TIndex axis = 0; axis < 3; ++axis)
+    {
+      block.mV0[axis][lane]     = v0[axis];
+      block.mEdge1[axis][lane]  = edge1[axis];
+      block.mEdge2[axis][lane]  = edge2[axis];
+    }
+    block.mTriangle[lane] = pTriangleIds[i];
+    block.mCount = lane + 1;
+  }
+}
+
+TU32 DTriangleBlock::IntersectReference(const DRay& localRay, float tMax, float* oT) const noexcept
+{
+  using ::dy::math::Cross;
+  using ::dy::math::Dot;
+  using ::dy::math::IsNearlyZero;
+
+  TU32 hitMask = 0;
+  for (TIndex lane = 0; lane < this->mCount; ++lane)
+  {
+    const DVec3 v0    = {this->mV0[0][lane], this->mV0[1][lane], this->mV0[2][lane]};
+    const DVec3 edge1 = {this->mEdge1[0][lane], this->mEdge1[1][lane], this->mEdge1[2][lane]};
+    const DVec3 edge2 = {this->mEdge2[0][lane], this->mEdge2[1][lane], this->mEdge2[2][lane]};
+
+    const DVec3 h = Cross(localRay.GetDirection(), edge2);
+    const auto a = Dot(edge1, h);
+    // If ray is parallel, just do next triangle.
+    if (IsNearlyZero(a) == true) { continue; }
+
+    const TReal f = 1 / a;
+    const DVec3 s = localRay.GetOrigin() - v0;
+    const TReal u = f * Dot(s, h);
+    if (u < 0 || u > 1) { continue; }
+
+    const DVec3 q = Cross(s, edge1);
+    const TReal v = f * Dot(localRay.GetDirection(), q);
+    if (v < 0 || u + v > 1) { continue; }
+
+    const TReal t = f * Dot(edge2, q);
+    if (t <= 0.0f || t >= tMax) { continue; }
+
+    oT[lane] = t;
+    hitMask |= 1u << lane;
+  }
+  return hitMask;
+}
+
+} /// ::ray namespace
@@ -12,6 +12,7 @@
 ///
 
 #include <Manager/MMaterial.hpp>
+#include <mutex>
 #include <nlohmann/json.hpp>
 
 #include <XCommon.hpp>
@@ -35,7 +36,8 @@ ESuccess MMaterial::pfRelease()
 
 std::optional<DMatId> MMaterial::AddCandidateMaterial(const tinyobj::material_t& materialInfo)
 {
-  DMatId id = ::dy::math::DUuid{true};
+  std::unique_lock lock { this->mCandidateMutex };
+  DMatId id = CreateUuid();
   const auto [it, isSuccessful] = this->mCandidates.try_emplace(id, id, materialInfo);
   if (isSuccessful == false)
   {
@@ -54,6 +56,7 @@ bool MMaterial::HasMaterial(const DMatId& id) const noexcept
 
 bool MMaterial::HasMaterialCandidate(const DMatId& id) const noexcept
 {
+  std::shared_lock lock { this->mCandidateMutex };
   return this->mCandidates.find(id) != this->mCandidates.end();
 }
 
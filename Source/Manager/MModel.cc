@@ -12,13 +12,65 @@
 ///
 
 #include <Manager/MModel.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <set>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include <tinyobj/tiny_obj_loader.h>
 
 #include <Manager/MMaterial.hpp>
 #include <XCommon.hpp>
 #include <Helper/XHelperJson.hpp>
+#include <Helper/FMappedFile.hpp>
+#include <Helper/XHelperParallel.hpp>
+#include <Resource/XObjLoader.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief Process items of [0, count) on threads of budget. Each thread takes next item until all items are processed.
+/// Items should be sorted from heavy to light, so the heaviest item does not start last.
+template <typename TFunc>
+void ForEachItem(TIndex count, TFunc&& itemFunc)
+{
+  const auto threadCount = std::clamp<TIndex>(GetParallelThreadCount(), 1, std::max<TIndex>(count, 1));
+  std::atomic<TIndex> nextItem = 0;
+  ForEachThread(threadCount, [&](TIndex)
+  {
+    for (auto item = nextItem++; item < count; item = nextItem++) { itemFunc(item); }
+  });
+}
+
+/// @brief Get hash of geometry of model file, that is used to share geometry and to find mesh cache.
+/// Material libraries are resolved from directory of model file, so model files of the same content 
+/// can refer to different materials. Resolved path and content of libraries are hashed with model content.
+TU64 GetGeometryHashOf(const FMappedFile& file, const std::filesystem::path& directory)
+{
+  std::vector<TU64> values = { GetContentHashOf(file.GetData(), file.GetSize()) };
+  for (const auto& library : FindMaterialLibraries(file.GetData(), file.GetSize(), directory))
+  {
+    std::error_code error;
+    auto canonicalPath = std::filesystem::weakly_canonical(library, error).string();
+    if (error) { canonicalPath = library.lexically_normal().string(); }
+
+    FMappedFile file;
+    const bool isOpened = file.Open(library.string().c_str());
+    values.emplace_back(GetContentHashOf(canonicalPath.data(), canonicalPath.size()));
+    values.emplace_back(isOpened == true ? file.GetSize() : 0);
+    values.emplace_back(isOpened == true ? GetContentHashOf(file.GetData(), file.GetSize()) : 0);
+  }
+  return GetContentHashOf(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(TU64));
+}
+
+} /// anonymous namespace
 
 namespace ray
 {
@@ -30,44 +82,143 @@ ESuccess MModel::pfInitialize()
 
 ESuccess MModel::pfRelease()
 {
+  // Mesh trees are released per mesh at once with arena, and meshes refer to buffers, so release meshes first.
+  std::unique_lock lock { this->mMutex };
+  this->mMeshContainer.clear();
+  this->mBufferContainer.clear();
+  this->mModelContainer.clear();
+  this->mModelPrefabs.clear();
+  this->mLoadedGeometries.clear();
   return ESuccess::DY_SUCCESS;
 }
 
 bool MModel::AddModelPrefab(const DModelId& id, const DModelPrefab& prefab)
 {
-  if (this->HasModelPrefab(id) == true)
-  {
-    return false;
-  }
-
+  std::unique_lock lock { this->mMutex };
   const auto [it, isSuccessful] = this->mModelPrefabs.try_emplace(id, prefab);
-  assert(isSuccessful == true);
-  if (isSuccessful == false) { return false; }
-
-  return true;
+  return isSuccessful;
 }
 
 bool MModel::HasModelPrefab(const DModelId& id) const noexcept
 {
-  return this->mModelPrefabs.find(id) != this->mModelPrefabs.end();
+  return this->GetModelPrefab(id) != nullptr;
 }
 
 const DModelPrefab* MModel::GetModelPrefab(const DModelId& id) const noexcept
 {
-  if (this->HasModelPrefab(id) == false) { return nullptr; }
-  return &this->mModelPrefabs.find(id)->second;
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mModelPrefabs.find(id);
+  return it != this->mModelPrefabs.end() ? &it->second : nullptr;
+}
+
+bool MModel::AddModels(const std::vector<DModelId>& ids)
+{
+  // Model files are mapped and hashed first, so files of the same content and material libraries 
+  // are loaded once concurrently, and the others share geometry of it after that.
+  // Prefabs of the same path map and hash the file once.
+  std::vector<std::pair<DModelId, const DModelPrefab*>> prefabs;
+  std::vector<TIndex> fileIndices;
+  std::unordered_map<std::string, TIndex> pathIndices;
+  for (const auto& id : ids)
+  {
+    const auto* pPrefab = this->GetModelPrefab(id);
+    if (pPrefab == nullptr)
+    {
+      std::cerr << "Failed to load model. Model prefab is not exist.\n";
+      return false;
+    }
+
+    prefabs.emplace_back(id, pPrefab);
+    fileIndices.emplace_back(pathIndices.try_emplace(pPrefab->mModelPath, pathIndices.size()).first->second);
+  }
+
+  // `std::vector<bool>` can not be written from multiple threads.
+  std::vector<std::string> paths (pathIndices.size());
+  for (const auto& [path, index] : pathIndices) { paths[index] = path; }
+  std::vector<FMappedFile> files (paths.size());
+  std::vector<TU64> geometryHashes (paths.size(), 0);
+  std::vector<char> isOpened (paths.size(), false);
+  ForEachItem(paths.size(), [&](TIndex i)
+  {
+    if (files[i].Open(paths[i].c_str()) == false)
+    {
+      std::cerr << "Failed to load model `" << paths[i] << "`. File is not exist on the path.\n";
+      return;
+    }
+    geometryHashes[i] = GetGeometryHashOf(files[i], std::filesystem::path{paths[i]}.parent_path());
+    isOpened[i] = true;
+  });
+  if (std::all_of(isOpened.begin(), isOpened.end(), [](char result) { return result == true; }) == false) 
+  { 
+    return false; 
+  }
+
+  // Load the largest file first, so loading time is close to the time of the largest file.
+  std::vector<std::pair<TIndex, TIndex>> orders;
+  std::vector<TIndex> sharedLoads;
+  std::set<std::pair<TU64, TIndex>> geometries;
+  for (TIndex i = 0, size = prefabs.size(); i < size; ++i)
+  {
+    const auto& file = files[fileIndices[i]];
+    if (geometries.emplace(geometryHashes[fileIndices[i]], file.GetSize()).second == true)
+    {
+      orders.emplace_back(file.GetSize(), i);
+    }
+    else
+    {
+      sharedLoads.emplace_back(i);
+    }
+  }
+  std::sort(orders.begin(), orders.end(), [](const auto& lhs, const auto& rhs)
+  {
+    return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+  });
+
+  std::vector<char> results (orders.size(), false);
+  ForEachItem(orders.size(), [&](TIndex item)
+  {
+    const auto i = orders[item].second;
+    const auto& [id, pPrefab] = prefabs[i];
+    results[item] = this->AddModelFrom(*pPrefab, &id, files[fileIndices[i]], geometryHashes[fileIndices[i]]).has_value();
+  });
+  if (std::all_of(results.begin(), results.end(), [](char result) { return result == true; }) == false) 
+  { 
+    return false; 
+  }
+
+  for (const auto i : sharedLoads)
+  {
+    const auto& [id, pPrefab] = prefabs[i];
+    if (this->AddModelFrom(*pPrefab, &id, files[fileIndices[i]], geometryHashes[fileIndices[i]]).has_value() == false) 
+    { 
+      return false; 
+    }
+  }
+  return true;
 }
 
 std::optional<DModelId> MModel::AddModel(const DModelPrefab& prefab, const DModelId* preparedId)
 {
-    // Check file is not exist on given path.
+  // Map file once. Content hash and parsing read the same mapped content.
   const auto& path = prefab.mModelPath;
-  if (auto* fp = std::fopen(path.c_str(), "r"); !fp)
+  FMappedFile file;
+  if (file.Open(path.c_str()) == false)
   {
     std::cerr << "Failed to load model `" << path << "`. File is not exist on the path.\n";
     return std::nullopt;
   }
-  else { std::fclose(fp); }
+
+  const auto geometryHash = GetGeometryHashOf(file, std::filesystem::path{path}.parent_path());
+  return this->AddModelFrom(prefab, preparedId, file, geometryHash);
+}
+
+std::optional<DModelId> MModel::AddModelFrom(
+  const DModelPrefab& prefab, 
+  const DModelId* preparedId, 
+  const FMappedFile& file, 
+  TU64 geometryHash)
+{
+  const auto& path = prefab.mModelPath;
 
   // Check file is not started with `.obj`.
 #if 0
@@ -78,44 +229,65 @@ std::optional<DModelId> MModel::AddModel(const DModelPrefab& prefab, const DMode
   }
 #endif
 
-  // Load Obj file.
-  tinyobj::attrib_t attrib;
-  std::vector<tinyobj::shape_t> shapes;
-  std::vector<tinyobj::material_t> materials;
-  std::string error;
-  bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &error, path.c_str());
+  DModelId mModelId;
+  if (preparedId != nullptr)  { mModelId = *preparedId; }
+  else                        { mModelId = CreateUuid(); }
 
-  if (prefab.mScale != 1.0f)
+  // If model file of the same content and material libraries was loaded already, share geometry of it.
+  // Prefab scale is not baked into buffer but applied to instance, so geometry can be shared regardless of scale.
+  if (const auto optGeometry = this->FindLoadedGeometry(geometryHash, file.GetSize()); optGeometry.has_value() == true)
   {
-    // If not checked, just scale tinyobj::attrib_t::vertices with prefab.mScale value that is not 1.0f.
-    for (auto& value : attrib.vertices) { value *= prefab.mScale; }
+    return this->CreateModel(mModelId, *optGeometry, prefab.mScale, path);
   }
-
-  // Check error and ret flag.
-  if (error.empty() == false)
+  const auto byteSize = file.GetSize();
+
+  // If mesh cache of the same content and settings is exist, map it instead of parsing and building.
+  PMeshCacheKey cacheKey;
+  cacheKey.mSourceHash  = geometryHash;
+  cacheKey.mSourceSize  = byteSize;
+  cacheKey.mSettingHash = this->GetMeshSettingHash();
+  const auto cachePath  = this->GetMeshCachePathOf(path, geometryHash);
+  if (this->mIsUsingMeshCache == true)
   {
-    std::cerr << error << "\n";
+    if (auto optCache = ReadMeshCache(cachePath, cacheKey); optCache.has_value() == true)
+    {
+      auto optGeometry = this->CreateGeometryFrom(*optCache, path);
+      if (optGeometry.has_value() == false) { return std::nullopt; }
+
+      optGeometry->mByteSize = byteSize;
+      this->AddLoadedGeometry(geometryHash, *optGeometry);
+      return this->CreateModel(mModelId, *optGeometry, prefab.mScale, path);
+    }
   }
-  if (ret == false)
+
+  // Parse obj file in parallel, directly into final vertex and index lists.
+  const auto directory = std::filesystem::path{path}.parent_path();
+  auto optObjModel = ParseObjModel(file.GetData(), file.GetSize(), directory);
+  if (optObjModel.has_value() == false)
   {
     std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
     return std::nullopt;
   }
+  auto& objModel = *optObjModel;
 
-  // Create DModelBuffer with attrib.
-  const DModelBufferId mId = ::dy::math::DUuid{true};
+  // Create DModelBuffer by moving parsed lists.
+  const DModelBufferId mId = CreateUuid();
+  DModelBuffer* pBuffer = nullptr;
   {
-    const auto [it, isSuccessful] = this->mBufferContainer.try_emplace(mId, mId, attrib);
+    std::unique_lock lock { this->mMutex };
+    const auto [it, isSuccessful] = this->mBufferContainer.try_emplace(
+      mId, mId, std::move(objModel.mVertices), std::move(objModel.mNormals), std::move(objModel.mUV0s));
     if (isSuccessful == false)
     {
       std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
       return std::nullopt;
     }
+    pBuffer = &it->second;
   }
 
   // If external material is exist, create candidate material instance into MMaterial.
   std::vector<DMatId> candidateMaterials;
-  for (const auto& material : materials)
+  for (const auto& material : objModel.mMaterials)
   {
     const auto optId = EXPR_SGT(MMaterial).AddCandidateMaterial(material);
     if (optId.has_value() == false)
@@ -128,30 +300,49 @@ std::optional<DModelId> MModel::AddModel(const DModelPrefab& prefab, const DMode
 
   // Create shape meshes with given id from index of material, and model buffer id.
   std::vector<DMeshId> meshes;
-  for (const auto& shape : shapes)
+  std::vector<TI32> meshMaterials;
+  for (auto& shape : objModel.mShapes)
   {
     DModelMesh::PCtor pctor;
-    pctor.mId = ::dy::math::DUuid{true};
+    pctor.mId = CreateUuid();
     pctor.mBufferId = mId;
-    pctor.mpShape   = &shape;
+    pctor.mpName    = &shape.mName;
+    pctor.mpIndices = &shape.mIndices;
     // If shape has metarial index (default), get id from material id list.
-    const auto matIndex = shape.mesh.material_ids.front();
+    const auto matIndex = shape.mMaterialIndex;
     pctor.mpMatId   = matIndex != -1 ? &candidateMaterials[matIndex] : nullptr;
-    // Insert it.
-    const auto [it, isSuccessful] = this->mMeshContainer.try_emplace(pctor.mId, pctor);
+    // Insert it. Mesh is created out of lock, because constructor checks buffer through manager.
+    DModelMesh mesh { pctor };
+    std::unique_lock lock { this->mMutex };
+    const auto [it, isSuccessful] = this->mMeshContainer.try_emplace(pctor.mId, std::move(mesh));
     if (isSuccessful == false)
     {
       std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
       return std::nullopt;
     }
     meshes.emplace_back(pctor.mId);
+    meshMaterials.emplace_back(matIndex);
+  }
+
+  // Weld vertices and reorder buffer and triangles for locality before normals and trees are created.
+  if (this->mIsOptimizingMeshes == true)
+  {
+    if (pBuffer->OptimizeWith(meshes, this->mWeldTolerance) == false)
+    {
+      std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
+      return std::nullopt;
+    }
   }
 
   // Check buffer has not normals. If true, create normals with shape lists.
-  auto* pBuffer = EXPR_SGT(MModel).GetModelBuffer(mId);
-  if (pBuffer->HasNormals() == false)
+  // If geometric normals are used, normals are not stored at all.
+  if (this->mIsUsingGeometricNormals == true)
+  {
+    pBuffer->ReleaseNormals();
+  }
+  else if (pBuffer->HasNormals() == false)
   {
-    const auto flag = pBuffer->CreateNormalsWith(meshes);
+    const auto flag = pBuffer->CreateNormalsWith(meshes, this->mCreaseAngle);
     if (flag == false)
     {
       std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
@@ -159,26 +350,61 @@ std::optional<DModelId> MModel::AddModel(const DModelPrefab& prefab, const DMode
     }
   }
 
-  // Create KDTree and faces of meshes.
-  for (const auto& meshId : meshes)
+  // Create KDTree and faces of meshes concurrently, from the largest mesh.
+  std::vector<DModelMesh*> pMeshes;
+  for (const auto& meshId : meshes) { pMeshes.emplace_back(this->GetMesh(meshId)); }
+  std::sort(pMeshes.begin(), pMeshes.end(), [](const DModelMesh* lhs, const DModelMesh* rhs) 
+  { 
+    return lhs->GetIndices().size() > rhs->GetIndices().size(); 
+  });
+  ForEachItem(pMeshes.size(), [&pMeshes, this](TIndex i)
+  {
+    pMeshes[i]->CreateTriangles();
+    pMeshes[i]->CreateKdTree(this->mTreeWidth, this->mTreeQuantizeBits);
+  });
+
+  // Write mesh cache for next loading. Model is still usable even though cache is not written.
+  if (this->mIsUsingMeshCache == true)
   {
-    auto* pMesh = EXPR_SGT(MModel).GetMesh(meshId);
-    assert(pMesh != nullptr);
-    pMesh->CreateFaces();
-    pMesh->CreateKdTree();
+    std::vector<const DModelMesh*> pMeshes;
+    for (const auto& meshId : meshes) { pMeshes.emplace_back(this->GetMesh(meshId)); }
+    const auto isTooDeep = std::any_of(pMeshes.begin(), pMeshes.end(), [](const DModelMesh* pMesh)
+    {
+      return pMesh->GetTreeHeader().GetDepth() > kMaxMeshCacheTreeDepth;
+    });
+    if (isTooDeep == true)
+    {
+      std::cerr << "Warning : Mesh cache of model `" << path << "` is not written. Tree of mesh is deeper than " 
+        << kMaxMeshCacheTreeDepth << ".\n";
+    }
+    else if (WriteMeshCache(
+      cachePath, cacheKey, *pBuffer, 
+      pMeshes, meshMaterials, objModel.mMaterials, objModel.mMaterialLibraries) == false)
+    {
+      std::cerr << "Warning : Failed to write mesh cache `" << cachePath.string() << "`.\n";
+    }
   }
 
+  // Register loaded geometry with geometry hash. 
+  PLoadedGeometry geometry;
+  geometry.mByteSize    = byteSize;
+  geometry.mBufferId    = mId;
+  geometry.mMeshIds     = meshes;
+  geometry.mMaterialIds = candidateMaterials;
+  this->AddLoadedGeometry(geometryHash, geometry);
+
   // Create model instance into container, with every id list.
-  DModelId mModelId;
-  if (preparedId != nullptr)  { mModelId = *preparedId; }
-  else                        { mModelId = ::dy::math::DUuid{true}; }
-  {
-    DModel::PCtor pctor;
-    pctor.mId           = mModelId;
-    pctor.mBufferId     = mId;
-    pctor.mMeshIds      = meshes;
-    pctor.mMaterialIds  = candidateMaterials;
-    const auto [it, isSuccessful] = this->mModelContainer.try_emplace(pctor.mId, pctor);
+  return this->CreateModel(mModelId, geometry, prefab.mScale, path);
+}
+
+std::optional<MModel::PLoadedGeometry> MModel::CreateGeometryFrom(PMeshCache& cache, const std::string& path)
+{
+  // Create DModelBuffer that refers to mapped lists. Buffer owns mapped file, and meshes refer to it.
+  const DModelBufferId mId = CreateUuid();
+  {
+    std::unique_lock lock { this->mMutex };
+    const auto [it, isSuccessful] = this->mBufferContainer.try_emplace(
+      mId, mId, cache.mpFile, cache.mVertices, cache.mNormals, cache.mUV0s);
     if (isSuccessful == false)
     {
       std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
@@ -186,70 +412,227 @@ std::optional<DModelId> MModel::AddModel(const DModelPrefab& prefab, const DMode
     }
   }
 
-  return mModelId;
+  std::vector<DMatId> candidateMaterials;
+  for (const auto& material : cache.mMaterials)
+  {
+    const auto optId = EXPR_SGT(MMaterial).AddCandidateMaterial(material);
+    if (optId.has_value() == false)
+    {
+      std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
+      return std::nullopt;
+    }
+    candidateMaterials.emplace_back(*optId);
+  }
+
+  // Meshes refer to mapped indices and triangles, and trees are relinked from flattened nodes.
+  std::vector<DMeshId> meshes;
+  for (const auto& cacheMesh : cache.mMeshes)
+  {
+    DModelMesh::PCtor pctor;
+    pctor.mId = CreateUuid();
+    pctor.mBufferId = mId;
+    pctor.mpName    = &cacheMesh.mName;
+    pctor.mMappedIndices    = cacheMesh.mIndices;
+    pctor.mMappedTriangles  = cacheMesh.mTriangles;
+    const auto matIndex = cacheMesh.mMaterialIndex;
+    pctor.mpMatId   = matIndex != -1 ? &candidateMaterials[matIndex] : nullptr;
+    DModelMesh mesh { pctor };
+    std::unique_lock lock { this->mMutex };
+    const auto [it, isSuccessful] = this->mMeshContainer.try_emplace(pctor.mId, std::move(mesh));
+    if (isSuccessful == false)
+    {
+      std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
+      return std::nullopt;
+    }
+    meshes.emplace_back(pctor.mId);
+  }
+
+  for (TIndex i = 0, size = meshes.size(); i < size; ++i)
+  {
+    const auto& cacheMesh = cache.mMeshes[i];
+    this->GetMesh(meshes[i])->RestoreKdTree(
+      cacheMesh.mNodes, cacheMesh.mBlocks.data(), this->mTreeWidth, this->mTreeQuantizeBits);
+  }
+
+  PLoadedGeometry geometry;
+  geometry.mBufferId    = mId;
+  geometry.mMeshIds     = meshes;
+  geometry.mMaterialIds = candidateMaterials;
+  return geometry;
 }
 
-bool MModel::HasModel(const DModelId & id) const noexcept
+TU64 MModel::GetMeshSettingHash() const noexcept
 {
-  return this->mModelContainer.find(id) != this->mModelContainer.end();
+  // Tree width and quantization are not included, because wide trees are collapsed again on loading.
+  const float values[] = { 
+    this->mIsOptimizingMeshes == true ? 1.0f : 0.0f, this->mWeldTolerance, 
+    this->mIsUsingGeometricNormals == true ? 1.0f : 0.0f, this->mCreaseAngle };
+  char bytes[sizeof(values)];
+  std::memcpy(bytes, values, sizeof(values));
+  return GetContentHashOf(bytes, sizeof(bytes));
 }
 
-DModel* MModel::GetModel(const DModelId& id) noexcept
+std::filesystem::path MModel::GetMeshCachePathOf(const std::string& path, TU64 geometryHash) const
 {
-  if (this->HasModel(id) == false) { return nullptr; }
+  if (this->mMeshCacheDirectory.empty() == true) { return path + ".shmesh"; }
 
-  auto& [_, model] = *this->mModelContainer.find(id);
-  return &model;  
+  // Models of different directories may have the same name, so geometry hash is appended.
+  std::ostringstream name;
+  name << std::filesystem::path{path}.stem().string() << '-' 
+       << std::hex << std::setw(16) << std::setfill('0') << geometryHash << ".shmesh";
+  return std::filesystem::path{this->mMeshCacheDirectory} / name.str();
 }
 
-const DModel* MModel::GetModel(const DModelId& id) const noexcept
+std::optional<MModel::PLoadedGeometry> MModel::FindLoadedGeometry(TU64 geometryHash, TIndex byteSize) const
+{
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mLoadedGeometries.find(geometryHash);
+  if (it == this->mLoadedGeometries.end() || it->second.mByteSize != byteSize) { return std::nullopt; }
+  return it->second;
+}
+
+void MModel::AddLoadedGeometry(TU64 geometryHash, const PLoadedGeometry& geometry)
 {
-  if (this->HasModel(id) == false) { return nullptr; }
+  // When hash collides with geometry of different file, or the same content was loaded concurrently,
+  // the new one is just not shared.
+  std::unique_lock lock { this->mMutex };
+  this->mLoadedGeometries.try_emplace(geometryHash, geometry);
+}
+
+std::optional<DModelId> MModel::CreateModel(
+  const DModelId& id, 
+  const PLoadedGeometry& geometry, 
+  TReal scale, 
+  const std::string& path)
+{
+  DModel::PCtor pctor;
+  pctor.mId           = id;
+  pctor.mBufferId     = geometry.mBufferId;
+  pctor.mMeshIds      = geometry.mMeshIds;
+  pctor.mMaterialIds  = geometry.mMaterialIds;
+  pctor.mScale        = scale;
+  std::unique_lock lock { this->mMutex };
+  const auto [it, isSuccessful] = this->mModelContainer.try_emplace(pctor.mId, pctor);
+  if (isSuccessful == false)
+  {
+    std::cerr << "Failed to load model `" << path << "`. Unexpected error occurred.\n";
+    return std::nullopt;
+  }
 
-  auto& [_, model] = *this->mModelContainer.find(id);
-  return &model;  
+  return id;
+}
+
+bool MModel::HasModel(const DModelId& id) const noexcept
+{
+  return this->GetModel(id) != nullptr;
+}
+
+DModel* MModel::GetModel(const DModelId& id) noexcept
+{
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mModelContainer.find(id);
+  return it != this->mModelContainer.end() ? &it->second : nullptr;
+}
+
+const DModel* MModel::GetModel(const DModelId& id) const noexcept
+{
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mModelContainer.find(id);
+  return it != this->mModelContainer.end() ? &it->second : nullptr;
 }
 
 bool MModel::HasModelBuffer(const DModelBufferId& id) const noexcept
 {
-  return this->mBufferContainer.find(id) != this->mBufferContainer.end();
+  return this->GetModelBuffer(id) != nullptr;
 }
 
 DModelBuffer* MModel::GetModelBuffer(const DModelBufferId& id) noexcept
 {
-  if (this->HasModelBuffer(id) == false) { return nullptr; }
-
-  auto& [_, modelBuffer] = *this->mBufferContainer.find(id);
-  return &modelBuffer;
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mBufferContainer.find(id);
+  return it != this->mBufferContainer.end() ? &it->second : nullptr;
 }
 
 const DModelBuffer* MModel::GetModelBuffer(const DModelBufferId& id) const noexcept
 {
-  if (this->HasModelBuffer(id) == false) { return nullptr; }
-
-  const auto& [_, modelBuffer] = *this->mBufferContainer.find(id);
-  return &modelBuffer;
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mBufferContainer.find(id);
+  return it != this->mBufferContainer.end() ? &it->second : nullptr;
 }
 
 bool MModel::HasMesh(const DMeshId& id) const noexcept
 {
-  return this->mMeshContainer.find(id) != this->mMeshContainer.end();
+  return this->GetMesh(id) != nullptr;
 }
 
 DModelMesh* MModel::GetMesh(const DMeshId& id) noexcept
 {
-  if (this->HasMesh(id) == false) { return nullptr; }
-
-  auto& [_, mesh] = *this->mMeshContainer.find(id);
-  return &mesh;
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mMeshContainer.find(id);
+  return it != this->mMeshContainer.end() ? &it->second : nullptr;
 }
 
 const DModelMesh* MModel::GetMesh(const DMeshId& id) const noexcept
 {
-  if (this->HasMesh(id) == false) { return nullptr; }
+  std::shared_lock lock { this->mMutex };
+  const auto it = this->mMeshContainer.find(id);
+  return it != this->mMeshContainer.end() ? &it->second : nullptr;
+}
+
+void MModel::SetTreeWidth(TIndex width) noexcept
+{
+  assert(width == 2 || width == 4 || width == 8);
+  this->mTreeWidth = width;
+}
+
+TIndex MModel::GetTreeWidth() const noexcept
+{
+  return this->mTreeWidth;
+}
+
+void MModel::SetTreeQuantizeBits(TIndex bits) noexcept
+{
+  assert(bits == 0 || bits == 8 || bits == 16);
+  this->mTreeQuantizeBits = bits;
+}
+
+TIndex MModel::GetTreeQuantizeBits() const noexcept
+{
+  return this->mTreeQuantizeBits;
+}
+
+void MModel::SetCreaseAngle(TReal degree) noexcept
+{
+  this->mCreaseAngle = degree;
+}
+
+void MModel::SetUsingGeometricNormals(bool isUsing) noexcept
+{
+  this->mIsUsingGeometricNormals = isUsing;
+}
+
+void MModel::SetMeshOptimization(bool isEnabled, TReal weldTolerance) noexcept
+{
+  assert(weldTolerance >= 0.0f);
+  this->mIsOptimizingMeshes = isEnabled;
+  this->mWeldTolerance = weldTolerance;
+}
+
+void MModel::SetMeshCache(bool isEnabled, const std::string& directory)
+{
+  this->mIsUsingMeshCache = isEnabled;
+  this->mMeshCacheDirectory = directory;
+}
 
-  auto& [_, mesh] = *this->mMeshContainer.find(id);
-  return &mesh;
+PWideTreeMemory MModel::GetWideTreeMemory() const noexcept
+{
+  std::shared_lock lock { this->mMutex };
+  PWideTreeMemory memory;
+  for (const auto& [_, mesh] : this->mMeshContainer)
+  {
+    if (const auto* pWideTree = mesh.GetWideTree(); pWideTree != nullptr) { memory += pWideTree->GetMemory(); }
+  }
+  return memory;
 }
 
 } /// ::ray namespace
\ No newline at end of file
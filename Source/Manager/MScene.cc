@@ -13,7 +13,9 @@
 
 #include <Manager/MScene.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <iostream>
 #include <vector>
 
@@ -39,6 +41,7 @@
 #include <OldMaterial/FMatMetal.hpp>
 #include <OldMaterial/FMatDielectric.hpp>
 #include <Resource/DModelPrefab.hpp>
+#include <KDTree/XTraversalStats.hpp>
 
 namespace ray
 {
@@ -50,6 +53,8 @@ ESuccess MScene::pfInitialize()
 
 ESuccess MScene::pfRelease()
 {
+  this->mWideObjectTree = nullptr;
+  this->mObjectTree.Clear();
   this->mObjects.clear();
   return ESuccess::DY_SUCCESS;
 }
@@ -159,13 +164,7 @@ void MScene::AddSampleObjects(const MScene::PSceneDefaults& defaults)
   }
 
   // Make KDTree for objects (optimization).
-  std::vector<const IHitable*> mpObjects;
-  for (const auto& smtObject : this->mObjects)
-  {
-    mpObjects.emplace_back(smtObject.get());
-  }
-  this->mObjectTree = std::make_unique<DObjectNode>();
-  this->mObjectTree->BuildTree(mpObjects);
+  this->BuildObjectTree(defaults.mTreeWidth, defaults.mTreeQuantizeBits);
 }
 
 bool MScene::LoadSceneFile(const std::string& pathString, const PSceneDefaults& defaults)
@@ -180,6 +179,14 @@ bool MScene::LoadSceneFile(const std::string& pathString, const PSceneDefaults&
     return false; 
   } else { std::fclose(fp); }
 
+  // Mesh trees are built while loading models, so tree width must be set up first.
+  EXPR_SGT(MModel).SetTreeWidth(defaults.mTreeWidth);
+  EXPR_SGT(MModel).SetTreeQuantizeBits(defaults.mTreeQuantizeBits);
+  EXPR_SGT(MModel).SetCreaseAngle(defaults.mCreaseAngle);
+  EXPR_SGT(MModel).SetUsingGeometricNormals(defaults.mIsUsingGeometricNormals);
+  EXPR_SGT(MModel).SetMeshOptimization(defaults.mIsOptimizingMeshes, defaults.mWeldTolerance);
+  EXPR_SGT(MModel).SetMeshCache(defaults.mIsUsingMeshCache, defaults.mMeshCacheDirectory);
+
   // Load sequence.
   const auto jsonAtlas = json::GetAtlasFromFile(pathString);
   if (jsonAtlas.has_value() == false) { return false; }
@@ -288,6 +295,11 @@ bool MScene::LoadSceneFile190710(const nlohmann::json& json, const MScene::PScen
     std::cerr << "Can not find `objects` list header.\n";
     return false;
   }
+  if (this->AddModelsOfObjectsFromJson190710(json["objects"]) == false)
+  {
+    std::cerr << "Failed to load models of scene objects.\n";
+    return false;
+  }
   if (this->AddObjectsFromJson190710(json["objects"], defaults) == false)
   {
     std::cerr << "Failed to create scene objects list. Unexpected error occurred inside.\n";
@@ -295,13 +307,7 @@ bool MScene::LoadSceneFile190710(const nlohmann::json& json, const MScene::PScen
   }
 
   // Make KDTree for objects (optimization).
-  std::vector<const IHitable*> mpObjects;
-  for (const auto& smtObject : this->mObjects)
-  {
-    mpObjects.emplace_back(smtObject.get());
-  }
-  this->mObjectTree = std::make_unique<DObjectNode>();
-  this->mObjectTree->BuildTree(mpObjects);
+  this->BuildObjectTree(defaults.mTreeWidth, defaults.mTreeQuantizeBits);
   
   return true;
 }
@@ -821,28 +827,49 @@ bool MScene::AddObjectsFromJson190710(const nlohmann::json& json, const PSceneDe
   return true;
 }
 
-DVec3 MScene::ProceedRay(const DRay& ray, TIndex cnt, TIndex limit)
+bool MScene::AddModelsOfObjectsFromJson190710(const nlohmann::json& json)
 {
-  if (++cnt; cnt <= limit)
+  std::vector<DModelId> modelIds;
+  const auto AddModelId = [&modelIds](const std::string& name)
   {
-    // Process culling to all objects with DAABB.
-    //IHitable::TValueResults tList;
+    const auto id = DModelId{name};
+    if (EXPR_SGT(MModel).HasModelPrefab(id) == false || EXPR_SGT(MModel).HasModel(id) == true) { return; }
+    if (std::find(modelIds.begin(), modelIds.end(), id) == modelIds.end()) { modelIds.emplace_back(id); }
+  };
 
-    // Get closest SDF value.
-    auto tValues = this->mObjectTree->GetIntersectedTriangleTValue(ray);
-    tValues.erase(std::remove_if(
-      EXPR_BIND_BEGIN_END(tValues), 
-      [](const PTValueResult& item) { return item.mT <= 0.0f; }), tValues.end());
+  // Model resource name is resolved in the same way of `AddObjectsFromJson190710`.
+  for (const auto& item : json)
+  {
+    if (json::HasJsonKey(item, "name") == true)
+    {
+      const auto itPrefab = this->mPrefabs.find(json::GetValueFrom<std::string>(item, "name"));
+      if (itPrefab == this->mPrefabs.end() || itPrefab->second->GetObjectType() != EObject::Hitable) { continue; }
 
-    // Sort and get only shortest T one.
-    std::sort(
-      EXPR_BIND_BEGIN_END(tValues),
-      [](const auto& lhs, const auto& rhs) { return lhs.mT < rhs.mT; });
+      const auto& hitable = static_cast<const IHitable&>(*itPrefab->second);
+      if (hitable.GetType() != EShapeType::Model) { continue; }
 
-    // Render
-    if (tValues.empty() == false)
+      const auto [ctor, list] = json::GetValueFromOptionally<PModelCtor>(item, "detail");
+      const auto& modelPrefab = static_cast<const FModelPrefab&>(hitable);
+      AddModelId(modelPrefab.GetPCtor().Overwrite(ctor, list).mModelResourceName);
+    }
+    else if (json::HasJsonKey(item, "type") == true && json::HasJsonKey(item, "detail") == true)
     {
-      auto& [t, type, pObj, normal] = tValues.front();
+      if (json::GetValueFrom<std::string>(item, "type") != "model") { continue; }
+      AddModelId(json::GetValueFrom<PModelCtor>(item, "detail").mModelResourceName);
+    }
+  }
+
+  return EXPR_SGT(MModel).AddModels(modelIds);
+}
+
+DVec3 MScene::ProceedRay(const DRay& ray, TIndex cnt, TIndex limit)
+{
+  if (++cnt; cnt <= limit)
+  {
+    // Get closest SDF value.
+    if (const auto optHit = this->GetClosestIntersection(ray); optHit.has_value() == true)
+    {
+      const auto& [t, type, pObj, normal] = *optHit;
       auto optResult = pObj->TryScatter(ray, t, normal);
       const auto& [refDir, attCol, isScattered] = *optResult;
 
@@ -855,6 +882,86 @@ DVec3 MScene::ProceedRay(const DRay& ray, TIndex cnt, TIndex limit)
   }
 
   // Background section.
+  return this->GetBackgroundColor(ray);
+}
+
+void MScene::BuildObjectTree(TIndex width, TIndex quantizeBits)
+{
+  std::vector<const IHitable*> mpObjects;
+  for (const auto& smtObject : this->mObjects)
+  {
+    mpObjects.emplace_back(smtObject.get());
+  }
+  // Binary tree of N objects has at most 2N - 1 nodes, so all nodes are placed in one chunk.
+  this->mObjectTree.Clear();
+  this->mObjectTree.Reserve(std::max<TIndex>(mpObjects.size() * 2, 1) - 1, mpObjects.size());
+  auto& root = this->mObjectTree.CreateNode();
+  root.BuildTree(this->mObjectTree, mpObjects);
+
+  this->mWideObjectTree = nullptr;
+  if (width == 4 || width == 8)
+  {
+    this->mWideObjectTree = std::make_unique<DWideTree<DObjectNode>>();
+    this->mWideObjectTree->BuildFrom(root, width, quantizeBits);
+  }
+}
+
+PWideTreeMemory MScene::GetWideTreeMemory() const noexcept
+{
+  if (this->mWideObjectTree == nullptr) { return {}; }
+  return this->mWideObjectTree->GetMemory();
+}
+
+std::optional<PTValueResult> MScene::GetClosestIntersection(const DRay& ray) const
+{
+  GetThreadTraversalStats().mRayCount += 1;
+
+  // If wide tree is created, traverse it in near-to-far order, culling objects behind the closest hit.
+  if (this->mWideObjectTree != nullptr)
+  {
+    auto closestT = std::numeric_limits<float>::max();
+    std::optional<PTValueResult> result = std::nullopt;
+    this->mWideObjectTree->Traverse(ray, closestT,
+      [&ray, &result](const DObjectNode& leaf, float& ioTMax)
+      {
+        for (const auto* pObject : leaf.GetItems())
+        {
+          const auto optTValues = pObject->GetRayIntersectedTValues(ray);
+          if (optTValues.has_value() == false) { continue; }
+
+          for (const auto& item : *optTValues)
+          {
+            if (item.mT <= 0.0f || item.mT >= ioTMax) { continue; }
+            ioTMax = item.mT;
+            result = item;
+          }
+        }
+      });
+    return result;
+  }
+
+  const auto tValues = this->mObjectTree.GetRoot().GetIntersectedTriangleTValue(ray);
+
+  // Get only shortest T one, except for values that is behind of ray origin.
+  const PTValueResult* pClosest = nullptr;
+  for (const auto& item : tValues)
+  {
+    if (item.mT <= 0.0f) { continue; }
+    if (pClosest == nullptr || item.mT < pClosest->mT) { pClosest = &item; }
+  }
+
+  if (pClosest == nullptr) { return std::nullopt; }
+  return *pClosest;
+}
+
+void MScene::GetClosestIntersections(const DRayPacket& packet, DPacketHits& ioHits) const
+{
+  GetThreadTraversalStats().mRayCount += packet.GetWidth();
+  this->mObjectTree.GetRoot().GetPacketIntersections(packet, packet.GetFullMask(), ioHits);
+}
+
+DVec3 MScene::GetBackgroundColor(const DRay& ray) const noexcept
+{
   float skyT = 0.5f * (ray.GetDirection().Y + 1.0f); // [0, 1]
   return Lerp(DVec3{1.0f, 1.0f, 1.0f}, DVec3{0.2f, 0.5f, 1.0f}, skyT);
 }
@@ -17,10 +17,10 @@
 #include <sstream>
 #include <nlohmann/json.hpp>
 #include <Math/Utility/XLinearMath.h>
-#include <Math/Utility/XRandom.h>
 
 #include <XCommon.hpp>
 #include <Helper/XHelperJson.hpp>
+#include <Helper/XHelperRandom.hpp>
 #include <Manager/MScene.hpp>
 
 namespace ray
@@ -137,6 +137,7 @@ FCamera::FCamera(const FCamera::PCtor& arg)
   const auto scaledHeight = defScrHeight * this->mSensorSize;
   this->mCellRight  = mSide * (scaledHeight * arg.mScreenRatioXy / TReal(this->mScreenSize.X) );
   this->mCellUp     = mUp * (scaledHeight / TReal(this->mScreenSize.Y) );
+  this->mSampleOffsets = GetSampleOffsetsOf(this->mCellRight, this->mCellUp, this->mSamples);
 }
 
 const DUVec2& FCamera::GetImageSize() const noexcept
@@ -145,51 +146,56 @@ const DUVec2& FCamera::GetImageSize() const noexcept
 }
 
 std::vector<DRay> FCamera::CreateRay(TIndex x, TIndex y) const noexcept
+{
+  std::vector<DRay> rayList;
+  rayList.reserve(this->mSampleOffsets.size());
+  for (TIndex i = 0, size = this->mSampleOffsets.size(); i < size; ++i)
+  {
+    rayList.emplace_back(this->CreateSampleRay(x, y, i));
+  }
+
+  return rayList;
+}
+
+DRay FCamera::CreateSampleRay(TIndex x, TIndex y, TIndex offsetIndex) const noexcept
 {
   assert(x < this->mScreenSize[0] && y < this->mScreenSize[1]);
+  assert(offsetIndex < this->mSampleOffsets.size());
   
   const auto screenPos = this->mLowLeftCorner + (this->mCellRight * TReal(x)) + (this->mCellUp * TReal(y));
-  const std::vector<DVec3> offsets = GetSampleOffsetsOf(this->mCellRight, this->mCellUp, this->mSamples);
+  const auto& offset = this->mSampleOffsets[offsetIndex];
 
-  std::vector<DRay> rayList;
   if (this->IsUsingDepthOfField() == false)
   {
     // If camera is not using depth of field, just model perfect pin-hole camera.
-    for (const auto& offset : offsets)
-    {
-      const auto orig = screenPos + offset;
-      const auto dir = this->mOrigin - orig;
-      rayList.emplace_back(this->mOrigin, dir);
-    }
-  }
-  else
-  {
-    using ::dy::math::RandomVector2Range;
-    using ::dy::math::ERandomPolicy;
-    using ::dy::math::Dot;
-
-    // If camera is using depth of field, model convex (positive) thin-lens camera.
-    // f-number = this->mSensorSize (diameter) / this->mDistance;
-    // We need to get positive focal plane's focal point.
-    for (const auto& offset : offsets)
-    {
-      const auto origDir    = (this->mOrigin - (screenPos + offset)).Normalize();
-      const auto rayFocalCos= Dot(origDir, this->mForward);
-      const auto focalPoint = this->mOrigin + (origDir * (this->mDistance / rayFocalCos));
-      
-      // And get uniform random arbitary point of lens with this->mCellRight and this->mCellUp.
-      const auto xyPoint = RandomVector2Range<TReal>(ERandomPolicy::Uniform, 0, this->mSensorSize * 0.0625f);
-      const auto aperturePoint = 
-          this->mOrigin
-        + this->mSide * xyPoint[0]
-        + this->mUp * xyPoint[1];
-      // Finally get actual direction and insert it as a ray.
-      const auto dir = (focalPoint - aperturePoint).Normalize();
-      rayList.emplace_back(aperturePoint, dir);
-    }
+    const auto orig = screenPos + offset;
+    const auto dir = this->mOrigin - orig;
+    return DRay{this->mOrigin, dir};
   }
 
-  return rayList;
+  using ::dy::math::Dot;
+
+  // If camera is using depth of field, model convex (positive) thin-lens camera.
+  // f-number = this->mSensorSize (diameter) / this->mDistance;
+  // We need to get positive focal plane's focal point.
+  const auto origDir    = (this->mOrigin - (screenPos + offset)).Normalize();
+  const auto rayFocalCos= Dot(origDir, this->mForward);
+  const auto focalPoint = this->mOrigin + (origDir * (this->mDistance / rayFocalCos));
+  
+  // And get uniform random arbitary point of lens with this->mCellRight and this->mCellUp.
+  const auto xyPoint = random::GetVector2Range(0, this->mSensorSize * 0.0625f);
+  const auto aperturePoint = 
+      this->mOrigin
+    + this->mSide * xyPoint[0]
+    + this->mUp * xyPoint[1];
+  // Finally get actual direction and insert it as a ray.
+  const auto dir = (focalPoint - aperturePoint).Normalize();
+  return DRay{aperturePoint, dir};
+}
+
+TIndex FCamera::GetSampleOffsetCount() const noexcept
+{
+  return this->mSampleOffsets.size();
 }
 
 std::vector<DVec3> FCamera::GetSampleOffsetsOf(const DVec3& right, const DVec3& up, TU32 samples) const
@@ -294,6 +300,7 @@ std::vector<DVec3> FCamera::GetSampleOffsetsOf(const DVec3& right, const DVec3&
 void FCamera::SetSamples(TU32 sample)
 {
   this->mSamples = sample;
+  this->mSampleOffsets = GetSampleOffsetsOf(this->mCellRight, this->mCellUp, this->mSamples);
 }
 
 TU32 FCamera::GetSamples() const noexcept
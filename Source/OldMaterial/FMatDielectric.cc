@@ -17,7 +17,7 @@
 #include <Math/Utility/XLinearMath.h>
 #include <Math/Utility/XGraphicsMath.h>
 #include <Math/Utility/XShapeMath.h>
-#include <Math/Utility/XRandom.h>
+#include <Helper/XHelperRandom.hpp>
 #include <Helper/XHelperJson.hpp>
 #include <Manager/MScene.hpp>
 
@@ -37,8 +37,6 @@ std::optional<PScatterResult>
 FMatDielectric::Scatter(const DRay& intersectedRay, const DVec3& normal) const
 {
   using ::dy::math::GetClosestTValueOf;
-  using ::dy::math::RandomVector3Length;
-  using ::dy::math::RandomUniformReal;
   using ::dy::math::Dot;
   using ::dy::math::Refract;
   using ::dy::math::Reflect;
@@ -61,7 +59,7 @@ FMatDielectric::Scatter(const DRay& intersectedRay, const DVec3& normal) const
     else
     {
       const auto presnelFactor = Schlick(sceneIor, this->mIor(), incidentNormal, normal);
-      if (RandomUniformReal(0.f, 1.f) < presnelFactor)
+      if (random::GetUniformReal(0.f, 1.f) < presnelFactor)
       {
         const auto reflectDir = Reflect(incidentNormal, normal);
         return PScatterResult{reflectDir, this->mColor, true};
@@ -85,7 +83,7 @@ FMatDielectric::Scatter(const DRay& intersectedRay, const DVec3& normal) const
     else
     {
       const auto presnelFactor = Schlick(this->mIor(), sceneIor, incidentNormal, normal);
-      if (RandomUniformReal(0.f, 1.f) < presnelFactor)
+      if (random::GetUniformReal(0.f, 1.f) < presnelFactor)
       {
         const auto reflectDir = Reflect(incidentNormal, normal * -1.0f);
         return PScatterResult{reflectDir, this->mColor, true};
@@ -129,7 +127,7 @@ FMatDielectric::Scatter(const DRay& intersectedRay, const DVec3& normal) const
     return PScatterResult {*optRefract, DVec3{1}, true};
   }
 
-  if (::dy::math::RandomUniformReal(0.0f, 1.0f) < reflectProb)
+  if (random::GetUniformReal(0.0f, 1.0f) < reflectProb)
   {
     const auto refDir = Reflect(incidentNor, normal);
     return PScatterResult {refDir, DVec3{1}, true};
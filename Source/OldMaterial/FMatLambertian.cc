@@ -16,7 +16,7 @@
 
 #include <Math/Utility/XLinearMath.h>
 #include <Math/Utility/XShapeMath.h>
-#include <Math/Utility/XRandom.h>
+#include <Helper/XHelperRandom.hpp>
 #include <Helper/XHelperJson.hpp>
 
 namespace ray
@@ -33,13 +33,12 @@ std::optional<PScatterResult>
 FMatLambertian::Scatter([[maybe_unused]] const DRay& intersectedRay, const DVec3& normal) const 
 {
   using ::dy::math::GetClosestTValueOf;
-  using ::dy::math::RandomVector3Length;
   using ::dy::math::Dot;
 
-  DVec3 refDir = RandomVector3Length<TReal>(1.0f);
+  DVec3 refDir = random::GetVector3Length(1.0f);
   while (Dot(refDir, normal) <= 0)
   {
-    refDir = RandomVector3Length<TReal>(1.0f);
+    refDir = random::GetVector3Length(1.0f);
   }
 
   return PScatterResult{(normal + refDir).Normalize(), this->mColor * 0.9f, true};
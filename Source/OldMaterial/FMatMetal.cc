@@ -16,7 +16,7 @@
 #include <nlohmann/json.hpp>
 #include <Math/Utility/XLinearMath.h>
 #include <Math/Utility/XGraphicsMath.h>
-#include <Math/Utility/XRandom.h>
+#include <Helper/XHelperRandom.hpp>
 #include <Helper/XHelperJson.hpp>
 
 namespace ray
@@ -36,13 +36,12 @@ FMatMetal::Scatter(const DRay& intersectedRay, const DVec3& normal) const
 {
   using ::dy::math::Dot;
   using ::dy::math::Reflect;
-  using ::dy::math::RandomVector3Length;
 
   const auto baseRefDir = Reflect(intersectedRay.GetDirection() * -1.0f, normal);
-  auto refDir = RandomVector3Length<TReal>(1.0f);
+  auto refDir = random::GetVector3Length(1.0f);
   while (Dot(refDir, normal) <= 0)
   {
-    refDir = RandomVector3Length<TReal>(1.0f);
+    refDir = random::GetVector3Length(1.0f);
   }
   refDir *= this->mRoughness();
   refDir = (baseRefDir + refDir).Normalize();
@@ -20,7 +20,8 @@ DModel::DModel(const PCtor& ctor)
   : mId { ctor.mId },
     mBufferId { ctor.mBufferId },
     mMeshes { ctor.mMeshIds },
-    mMaterials { ctor.mMaterialIds }
+    mMaterials { ctor.mMaterialIds },
+    mScale { ctor.mScale }
 { }
 
 const std::vector<DMeshId>& DModel::GetMeshIds() const noexcept
@@ -33,4 +34,9 @@ const std::vector<DMatId>& DModel::GetInternalMaterials() const noexcept
   return this->mMaterials;
 }
 
+TReal DModel::GetScale() const noexcept
+{
+  return this->mScale;
+}
+
 } /// ::ray namespace
\ No newline at end of file
@@ -12,37 +12,374 @@
 ///
 
 #include <Resource/DModelBuffer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <Expr/TZip.h>
+#include <Helper/XHelperParallel.hpp>
 #include <Resource/DModelMesh.hpp>
 #include <Manager/MModel.hpp>
 
+namespace
+{
+
+using namespace ray;
+
+/// @brief Minimum item count of chunk of parallel loops. Small range is not worth to spawn threads.
+constexpr TIndex kMinChunkSize = 4096;
+
+/// @brief Get 30-bit Morton code of given position that is normalized into [0, 1] of each axis.
+TU32 GetMortonCode(const DVec3& normalized) noexcept
+{
+  const auto ExpandBits = [](TU32 value) 
+  {
+    value = (value * 0x00010001u) & 0xFF0000FFu;
+    value = (value * 0x00000101u) & 0x0F00F00Fu;
+    value = (value * 0x00000011u) & 0xC30C30C3u;
+    value = (value * 0x00000005u) & 0x49249249u;
+    return value;
+  };
+
+  TU32 code = 0;
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    // Not-a-number is mapped to 0, because casting it to integer is undefined.
+    const auto value = normalized[axis] * 1024.0f;
+    const auto cell = value > 0.0f ? TU32(std::min(value, 1023.0f)) : 0u;
+    code |= ExpandBits(cell) << (2 - axis);
+  }
+  return code;
+}
+
+} /// anonymous namespace
+
 namespace ray
 {
 
-DModelBuffer::DModelBuffer(const DModelBufferId& id, const tinyobj::attrib_t& attrib)
+DModelBuffer::DModelBuffer(const DModelBufferId& id, TPointVertices&& vertices, TNormals&& normals, TUVs&& uv0s)
+  : mId { id },
+    mVertices { std::move(vertices) },
+    mNormals { std::move(normals) },
+    mUV0s { std::move(uv0s) }
+{ }
+
+DModelBuffer::DModelBuffer(
+  const DModelBufferId& id, 
+  std::shared_ptr<const FMappedFile> pCacheFile,
+  PArrayView<DVec3> vertices, PArrayView<DVec3> normals, PArrayView<DVec2> uv0s)
   : mId { id },
-    mVertices ( attrib.vertices.size() ),
-    mNormals ( attrib.normals.size() ),
-    mUV0s ( attrib.texcoords.size() )
+    mpCacheFile { std::move(pCacheFile) },
+    mMappedVertices { vertices },
+    mMappedNormals { normals },
+    mMappedUV0s { uv0s }
+{
+  assert(this->mpCacheFile != nullptr);
+}
+
+bool DModelBuffer::OptimizeWith(const std::vector<DMeshId>& meshIds, TReal weldTolerance)
 {
-  static_assert(sizeof(TReal) == sizeof(tinyobj::real_t));
-  static_assert(sizeof(DVec3) == sizeof(tinyobj::real_t) * 3);
+  if (this->IsMapped() == true)
+  {
+    std::cerr << "Failed to optimize buffer. Buffer of mesh cache can not be modified.\n";
+    return false;
+  }
+
+  // Get pointer of mesh from id, and check all indices are valid.
+  std::vector<DModelMesh*> pMeshes (meshIds.size());
+  for (TIndex i = 0, size = meshIds.size(); i < size; ++i)
+  {
+    if (EXPR_SGT(MModel).HasMesh(meshIds[i]) == false)
+    {
+      std::cerr << "Failed to optimize buffer. Given meshId is not valid.\n";
+      return false;
+    }
+    pMeshes[i] = EXPR_SGT(MModel).GetMesh(meshIds[i]);
+
+    const auto& indices = pMeshes[i]->GetIndices();
+    if (indices.size() % 3 != 0)
+    {
+      std::cerr << "Failed to optimize buffer. The count of given index size can not be divided by 3.\n";
+      return false;
+    }
+    for (const auto& index : indices)
+    {
+      if (index.mVertexIndex < 0 || TIndex(index.mVertexIndex) >= this->mVertices.size()
+      ||  index.mNormalIndex >= TI32(this->mNormals.size())
+      ||  index.mUv0Index >= TI32(this->mUV0s.size()))
+      {
+        std::cerr << "Failed to optimize buffer. Index of mesh is out of range.\n";
+        return false;
+      }
+    }
+  }
+  if (this->mVertices.empty() == true) { return true; }
+
+  // First, weld vertices. When tolerance is 0, vertices in the same cell are welded into the first vertex of cell,
+  // and bit pattern of position is used as cell, except for sign of zero. 
+  // Otherwise, cell size is tolerance, and vertices are welded by distance to vertices of neighbouring cells.
+  // Cell is clamped, so cell of far vertex and its neighbouring cells are in range of TI64.
+  // Vertices that have infinite or not-a-number position are not welded, and kept as they are.
+  constexpr TReal kMaxWeldCell = TReal(TI64(1) << 62);
+  const auto vertexCount = this->mVertices.size();
+  const auto IsFiniteVertex = [this](TIndex v)
+  {
+    const auto& vertex = this->mVertices[v];
+    return std::isfinite(vertex.X) && std::isfinite(vertex.Y) && std::isfinite(vertex.Z);
+  };
+  std::vector<std::array<TI64, 3>> cells (vertexCount);
+  ForEachRange(vertexCount, 0, kMinChunkSize, [&](TIndex start, TIndex end)
+  {
+    for (TIndex v = start; v < end; ++v)
+    {
+      if (IsFiniteVertex(v) == false) { cells[v] = {}; continue; }
+      for (TIndex axis = 0; axis < 3; ++axis)
+      {
+        const float value = this->mVertices[v][axis];
+        if (weldTolerance > 0) 
+        { 
+          const auto cell = std::floor(value / weldTolerance);
+          cells[v][axis] = std::isfinite(cell) ? TI64(std::clamp(cell, -kMaxWeldCell, kMaxWeldCell)) : 0;
+          continue; 
+        }
+
+        TU32 bits = 0;
+        if (value != 0.0f) { std::memcpy(&bits, &value, sizeof(bits)); }
+        cells[v][axis] = bits;
+      }
+    }
+  });
+
+  std::vector<TU32> weldOrder (vertexCount);
+  std::iota(weldOrder.begin(), weldOrder.end(), 0);
+  std::sort(weldOrder.begin(), weldOrder.end(), [&cells](TU32 lhs, TU32 rhs)
+  {
+    return cells[lhs] != cells[rhs] ? cells[lhs] < cells[rhs] : lhs < rhs;
+  });
+  std::vector<TU32> weldedVertices (vertexCount);
+  if (weldTolerance <= 0)
+  {
+    for (TIndex i = 0; i < vertexCount; ++i)
+    {
+      const auto vertex = weldOrder[i];
+      if (IsFiniteVertex(vertex) == false) { weldedVertices[vertex] = vertex; continue; }
+      const bool isSameCell = i > 0 && cells[weldOrder[i - 1]] == cells[vertex] && IsFiniteVertex(weldOrder[i - 1]);
+      weldedVertices[vertex] = isSameCell == true ? weldedVertices[weldOrder[i - 1]] : vertex;
+    }
+  }
+  else
+  {
+    // Vertices are visited in index order, and each vertex is welded into the nearest representative 
+    // within tolerance in its cell and 26 neighbouring cells. If not found, vertex becomes representative.
+    // So vertices close to each other across cell boundary are welded too.
+    // Representatives of each cell are linked list from head of cell, and they are not many 
+    // because representatives of one cell are farther than tolerance from each other.
+    constexpr auto kNone = std::numeric_limits<TU32>::max();
+    std::vector<std::array<TI64, 3>> uniqueCells;
+    for (TIndex i = 0; i < vertexCount; ++i)
+    {
+      const auto& cell = cells[weldOrder[i]];
+      if (uniqueCells.empty() == true || uniqueCells.back() != cell) { uniqueCells.emplace_back(cell); }
+    }
+    const auto FindCell = [&uniqueCells](const std::array<TI64, 3>& cell)
+    {
+      const auto it = std::lower_bound(uniqueCells.begin(), uniqueCells.end(), cell);
+      return it != uniqueCells.end() && *it == cell ? TU32(it - uniqueCells.begin()) : kNone;
+    };
+
+    using ::dy::math::Dot;
+    const auto toleranceSquare = weldTolerance * weldTolerance;
+    std::vector<TU32> cellHeads (uniqueCells.size(), kNone);
+    std::vector<TU32> nextRepresentatives (vertexCount, kNone);
+    for (TIndex v = 0; v < vertexCount; ++v)
+    {
+      if (IsFiniteVertex(v) == false) { weldedVertices[v] = TU32(v); continue; }
+
+      auto nearest = TU32(v);
+      auto nearestSquare = toleranceSquare;
+      for (TI64 neighbour = 0; neighbour < 27; ++neighbour)
+      {
+        const auto cellIndex = FindCell({
+          cells[v][0] + neighbour % 3 - 1, 
+          cells[v][1] + neighbour / 3 % 3 - 1, 
+          cells[v][2] + neighbour / 9 - 1});
+        if (cellIndex == kNone) { continue; }
+        for (auto other = cellHeads[cellIndex]; other != kNone; other = nextRepresentatives[other])
+        {
+          const auto offset = this->mVertices[other] - this->mVertices[v];
+          const auto square = Dot(offset, offset);
+          if (square < nearestSquare || (square == nearestSquare && other < nearest)) 
+          { 
+            nearest = other; 
+            nearestSquare = square;
+          }
+        }
+      }
+
+      weldedVertices[v] = nearest;
+      if (nearest == v)
+      {
+        const auto cellIndex = FindCell(cells[v]);
+        nextRepresentatives[v] = cellHeads[cellIndex];
+        cellHeads[cellIndex] = TU32(v);
+      }
+    }
+  }
+  cells = {};
+  weldOrder = {};
+
+  for (auto* pMesh : pMeshes)
+  {
+    for (auto& index : pMesh->GetMutableIndices()) { index.mVertexIndex = TI32(weldedVertices[index.mVertexIndex]); }
+  }
+
+  // Second, remove triangles that are degenerated by welding. 
+  // If all triangles of mesh are degenerated, mesh is kept as it is not to be empty.
+  for (auto* pMesh : pMeshes)
+  {
+    auto& indices = pMesh->GetMutableIndices();
+    std::vector<DModelIndex> validIndices;
+    validIndices.reserve(indices.size());
+    for (TIndex i = 0, size = indices.size(); i < size; i += 3)
+    {
+      const auto v0 = indices[i+0].mVertexIndex;
+      const auto v1 = indices[i+1].mVertexIndex;
+      const auto v2 = indices[i+2].mVertexIndex;
+      if (v0 == v1 || v1 == v2 || v2 == v0) { continue; }
+      validIndices.insert(validIndices.end(), &indices[i], &indices[i] + 3);
+    }
+    if (validIndices.empty() == false) { indices = std::move(validIndices); }
+  }
+
+  // Third, reorder referenced vertices along Morton curve of buffer bounds, and drop unreferenced vertices.
+  constexpr auto kInvalid = std::numeric_limits<TU32>::max();
+  std::vector<TU32> newVertices (vertexCount, kInvalid);
+  std::vector<TU32> referencedVertices;
+  for (const auto* pMesh : pMeshes)
+  {
+    for (const auto& index : pMesh->GetIndices())
+    {
+      if (newVertices[index.mVertexIndex] != kInvalid) { continue; }
+      newVertices[index.mVertexIndex] = 0;
+      referencedVertices.emplace_back(TU32(index.mVertexIndex));
+    }
+  }
+  if (referencedVertices.empty() == true)
+  {
+    this->mVertices.clear();
+    this->mNormals.clear();
+    this->mUV0s.clear();
+    return true;
+  }
+
+  // Bounds are made of finite vertices only, so other vertices do not collapse Morton codes.
+  DVec3 min = DVec3{std::numeric_limits<TReal>::max()};
+  DVec3 max = DVec3{std::numeric_limits<TReal>::lowest()};
+  for (const auto& vertex : referencedVertices)
+  {
+    if (IsFiniteVertex(vertex) == false) { continue; }
+    for (TIndex axis = 0; axis < 3; ++axis)
+    {
+      min[axis] = std::min(min[axis], this->mVertices[vertex][axis]);
+      max[axis] = std::max(max[axis], this->mVertices[vertex][axis]);
+    }
+  }
+  const auto GetNormalizedOf = [&min, &max](const DVec3& position)
+  {
+    DVec3 result;
+    for (TIndex axis = 0; axis < 3; ++axis)
+    {
+      const auto length = max[axis] - min[axis];
+      result[axis] = length > 0 ? (position[axis] - min[axis]) / length : 0.0f;
+    }
+    return result;
+  };
+
+  std::vector<TU32> vertexCodes (vertexCount, 0);
+  for (const auto& vertex : referencedVertices) 
+  { 
+    vertexCodes[vertex] = GetMortonCode(GetNormalizedOf(this->mVertices[vertex])); 
+  }
+  std::sort(referencedVertices.begin(), referencedVertices.end(), [&vertexCodes](TU32 lhs, TU32 rhs)
+  {
+    return vertexCodes[lhs] != vertexCodes[rhs] ? vertexCodes[lhs] < vertexCodes[rhs] : lhs < rhs;
+  });
+
+  TPointVertices vertices (referencedVertices.size());
+  for (TIndex i = 0, size = referencedVertices.size(); i < size; ++i)
+  {
+    vertices[i] = this->mVertices[referencedVertices[i]];
+    newVertices[referencedVertices[i]] = TU32(i);
+  }
+  this->mVertices = std::move(vertices);
+
+  // Fourth, reorder triangles of each mesh along Morton curve of centroid.
+  for (auto* pMesh : pMeshes)
+  {
+    auto& indices = pMesh->GetMutableIndices();
+    for (auto& index : indices) { index.mVertexIndex = TI32(newVertices[index.mVertexIndex]); }
+
+    const auto triangleCount = indices.size() / 3;
+    std::vector<std::pair<TU32, TU32>> triangleCodes (triangleCount);
+    for (TIndex t = 0; t < triangleCount; ++t)
+    {
+      const auto centroid = (this->mVertices[indices[3*t+0].mVertexIndex]
+        + this->mVertices[indices[3*t+1].mVertexIndex]
+        + this->mVertices[indices[3*t+2].mVertexIndex]) / 3;
+      triangleCodes[t] = {GetMortonCode(GetNormalizedOf(centroid)), TU32(t)};
+    }
+    std::sort(triangleCodes.begin(), triangleCodes.end());
+
+    std::vector<DModelIndex> sortedIndices (indices.size());
+    for (TIndex t = 0; t < triangleCount; ++t)
+    {
+      std::copy_n(&indices[3 * triangleCodes[t].second], 3, &sortedIndices[3 * t]);
+    }
+    indices = std::move(sortedIndices);
+  }
 
-  // Copy vertices, normal and uv0 into vertices, normals and uv0s list.
-  std::memcpy(this->mVertices.data(), attrib.vertices.data(), attrib.vertices.size() * sizeof(TReal));
-  std::memcpy(this->mNormals.data(), attrib.normals.data(), attrib.normals.size() * sizeof(TReal));
-  std::memcpy(this->mUV0s.data(), attrib.texcoords.data(), attrib.texcoords.size() * sizeof(TReal));
+  // Fifth, drop unreferenced normals and uvs, and place them in order of first use.
+  const auto CompactAttributes = [&pMeshes](auto& attributes, TI32 DModelIndex::* pMember)
+  {
+    std::vector<TI32> newAttributes (attributes.size(), -1);
+    std::remove_reference_t<decltype(attributes)> compacted;
+    for (auto* pMesh : pMeshes)
+    {
+      for (auto& index : pMesh->GetMutableIndices())
+      {
+        auto& attribute = index.*pMember;
+        if (attribute < 0) { continue; }
+        if (newAttributes[attribute] < 0)
+        {
+          newAttributes[attribute] = TI32(compacted.size());
+          compacted.emplace_back(attributes[attribute]);
+        }
+        attribute = newAttributes[attribute];
+      }
+    }
+    attributes = std::move(compacted);
+  };
+  CompactAttributes(this->mNormals, &DModelIndex::mNormalIndex);
+  CompactAttributes(this->mUV0s, &DModelIndex::mUv0Index);
+
+  return true;
 }
 
-bool DModelBuffer::CreateNormalsWith([[maybe_unused]] const std::vector<DMeshId>& meshIds)
+bool DModelBuffer::CreateNormalsWith(const std::vector<DMeshId>& meshIds, TReal creaseAngle)
 {
   // https://computergraphics.stackexchange.com/questions/4031/programmatically-generating-vertex-normals
-  // https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
-  // Not implemented yet.
+  if (this->IsMapped() == true)
+  {
+    std::cerr << "Failed to create normals. Buffer of mesh cache can not be modified.\n";
+    return false;
+  }
 
   // Get pointer of mesh from id.
   std::vector<DModelMesh*> pMeshes (meshIds.size());
+  std::vector<TIndex> cornerOffsets (meshIds.size() + 1, 0);
   for (TIndex i = 0, size = meshIds.size(); i < size; ++i)
   {
     if (EXPR_SGT(MModel).HasMesh(meshIds[i]) == false)
@@ -51,76 +388,244 @@ bool DModelBuffer::CreateNormalsWith([[maybe_unused]] const std::vector<DMeshId>
       return false;
     }
     pMeshes[i] = EXPR_SGT(MModel).GetMesh(meshIds[i]);
-  }
-
-  // Resize normal container into this->mVertices.size().
-  this->mNormals.resize(this->mVertices.size());
 
-  // Loop each triangle.
-  for (auto& pMesh : pMeshes)
-  {
-    auto& indices = pMesh->GetIndices();
+    const auto& indices = pMeshes[i]->GetIndices();
     if (indices.size() % 3 != 0)
     {
       std::cerr << "Failed to create normal. The count of given index size can not be divided by 3.\n";
       return false;
     }
+    for (const auto& index : indices)
+    {
+      if (index.mVertexIndex < 0 || TIndex(index.mVertexIndex) >= this->mVertices.size())
+      {
+        std::cerr << "Failed to create normal. Vertex index of mesh is out of range.\n";
+        return false;
+      }
+    }
+    cornerOffsets[i + 1] = cornerOffsets[i] + indices.size();
+  }
 
-    // Flat normals (temporary)
-    using ::dy::math::Cross;
-    for (TIndex i = 0, size = indices.size(); i < size; i += 3)
+  // Flatten corners of all meshes, because meshes of buffer share vertices.
+  const auto cornerCount = cornerOffsets.back();
+  std::vector<TU32> cornerVertices (cornerCount);
+  for (TIndex m = 0, size = pMeshes.size(); m < size; ++m)
+  {
+    const auto& indices = pMeshes[m]->GetIndices();
+    for (TIndex i = 0, count = indices.size(); i < count; ++i) 
+    { 
+      cornerVertices[cornerOffsets[m] + i] = TU32(indices[i].mVertexIndex); 
+    }
+  }
+
+  // First, get unit face normal and interior angle of each corner.
+  using ::dy::math::Cross;
+  using ::dy::math::Dot;
+  std::vector<DVec3> cornerNormals (cornerCount);
+  std::vector<TReal> cornerAngles (cornerCount);
+  ForEachRange(cornerCount / 3, 0, kMinChunkSize, [&](TIndex start, TIndex end)
+  {
+    for (TIndex t = start; t < end; ++t)
+    {
+      const DVec3 p[3] = 
+      {
+        this->mVertices[cornerVertices[3*t+0]], 
+        this->mVertices[cornerVertices[3*t+1]], 
+        this->mVertices[cornerVertices[3*t+2]]
+      };
+      const auto cross = Cross(p[1] - p[0], p[2] - p[0]);
+      const auto length = cross.GetLength();
+      const auto normal = length > 0 ? cross / length : DVec3{};
+
+      for (TIndex k = 0; k < 3; ++k)
+      {
+        const auto edge1 = p[(k + 1) % 3] - p[k];
+        const auto edge2 = p[(k + 2) % 3] - p[k];
+        const auto lengths = edge1.GetLength() * edge2.GetLength();
+        cornerNormals[3*t+k] = normal;
+        cornerAngles[3*t+k] = lengths > 0 
+          ? std::acos(std::clamp(Dot(edge1, edge2) / lengths, TReal(-1), TReal(1))) 
+          : TReal(0);
+      }
+    }
+  });
+
+  // Second, make corner list of each vertex.
+  const auto vertexCount = this->mVertices.size();
+  std::vector<TIndex> vertexStarts (vertexCount + 1, 0);
+  for (const auto& vertex : cornerVertices) { vertexStarts[vertex + 1] += 1; }
+  for (TIndex v = 0; v < vertexCount; ++v) { vertexStarts[v + 1] += vertexStarts[v]; }
+  std::vector<TU32> vertexCorners (cornerCount);
+  {
+    auto cursors = vertexStarts;
+    for (TIndex c = 0; c < cornerCount; ++c) { vertexCorners[cursors[cornerVertices[c]]++] = TU32(c); }
+  }
+
+  // Third, average faces around each vertex that are within crease angle of each corner.
+  // Corners that have the same face normal get the same result, so corners are grouped by face normal first
+  // and faces are compared per group. Comparing all pairs of groups is quadratic to valence, so vertex that has 
+  // too many distinct faces (such as pole of sphere or apex of cone) compares each group with one angle-weighted 
+  // average of all groups instead. Groups within crease angle of it share average of them, and others keep face normal.
+  // Corners that have the same result share one normal, which is placed at [start, start + unique count) temporarily.
+  constexpr TIndex kMaxCreaseGroupCount = 64;
+  const auto creaseCos = std::cos(std::clamp(creaseAngle, TReal(0), TReal(180)) * TReal(3.14159265358979) / 180);
+  const auto IsLessNormal = [&cornerNormals](TU32 lhs, TU32 rhs)
+  {
+    const auto& a = cornerNormals[lhs];
+    const auto& b = cornerNormals[rhs];
+    if (a.X != b.X) { return a.X < b.X; }
+    if (a.Y != b.Y) { return a.Y < b.Y; }
+    return a.Z < b.Z;
+  };
+  std::vector<DVec3> uniqueNormals (cornerCount);
+  std::vector<TU32> uniqueCounts (vertexCount, 0);
+  std::vector<TU32> cornerSlots (cornerCount, 0);
+  ForEachRange(vertexCount, 0, kMinChunkSize, [&](TIndex start, TIndex end)
+  {
+    // Group [begin, end) of vertex corners, face normal and sum of interior angles of each group.
+    std::vector<std::pair<TIndex, TIndex>> groupRanges;
+    std::vector<DVec3> groupNormals;
+    std::vector<TReal> groupAngles;
+    for (TIndex v = start; v < end; ++v)
     {
-      assert(indices[i+0].mVertexIndex != -1);
-      assert(indices[i+1].mVertexIndex != -1);
-      assert(indices[i+2].mVertexIndex != -1);
-
-      const std::array<TI32, 3> idx = {indices[i+0].mVertexIndex, indices[i+1].mVertexIndex, indices[i+2].mVertexIndex};
-      const auto& p0 = this->mVertices[idx[0]];
-      const auto& p1 = this->mVertices[idx[1]];
-      const auto& p2 = this->mVertices[idx[2]];
-
-      // Calculate flat normal.
-      const auto normal = Cross(p1 - p0, p2 - p0).Normalize();
-      
-      // Check given (i0, i1, i2) is empty (DVec3{0}).
-      // If empty, just insert it into [in]. But if not empty, insert normal into last and get new index from list.
-      for (TIndex j = 0; j < 3; ++j)
+      const auto cornerStart = vertexStarts[v];
+      const auto cornerEnd   = vertexStarts[v + 1];
+      std::sort(vertexCorners.begin() + cornerStart, vertexCorners.begin() + cornerEnd, IsLessNormal);
+
+      groupRanges.clear();
+      groupNormals.clear();
+      groupAngles.clear();
+      for (TIndex i = cornerStart; i < cornerEnd; ++i)
       {
-        if (this->mNormals[idx[j]] == DVec3{})
+        const auto corner = vertexCorners[i];
+        if (groupNormals.empty() == true || (groupNormals.back() == cornerNormals[corner]) == false)
         {
-          this->mNormals[idx[j]] = normal;
-          indices[i+j].mNormalIndex = idx[j];
+          groupRanges.emplace_back(i, i);
+          groupNormals.emplace_back(cornerNormals[corner]);
+          groupAngles.emplace_back(TReal(0));
         }
-        else
+        groupRanges.back().second = i + 1;
+        groupAngles.back() += cornerAngles[corner];
+      }
+
+      const auto groupCount = groupNormals.size();
+      if (groupCount > kMaxCreaseGroupCount)
+      {
+        DVec3 average = DVec3{};
+        for (TIndex g = 0; g < groupCount; ++g) { average += groupNormals[g] * groupAngles[g]; }
+        const auto averageLength = average.GetLength();
+        if (averageLength > 0) { average = average / averageLength; }
+
+        DVec3 sum = DVec3{};
+        for (TIndex g = 0; g < groupCount; ++g)
         {
-          this->mNormals.emplace_back(normal);
-          indices[i+j].mNormalIndex = TI32(this->mNormals.size() - 1);
+          if (Dot(average, groupNormals[g]) >= creaseCos) { sum += groupNormals[g] * groupAngles[g]; }
         }
+        const auto sumLength = sum.GetLength();
+        const auto smoothNormal = sumLength > 0 ? sum / sumLength : average;
+
+        // Face normals of groups are distinct already, so slots are not searched.
+        std::optional<TU32> smoothSlot = std::nullopt;
+        for (TIndex g = 0; g < groupCount; ++g)
+        {
+          const auto& faceNormal = groupNormals[g];
+          const bool isSmoothed = sumLength > 0 && Dot(average, faceNormal) >= creaseCos;
+          if (isSmoothed == true && smoothSlot.has_value() == true) 
+          {
+            const auto& [groupBegin, groupEnd] = groupRanges[g];
+            for (TIndex i = groupBegin; i < groupEnd; ++i) { cornerSlots[vertexCorners[i]] = *smoothSlot; }
+            continue;
+          }
+
+          const auto slot = uniqueCounts[v]++;
+          if (isSmoothed == true) { smoothSlot = slot; }
+          uniqueNormals[cornerStart + slot] = isSmoothed == true 
+            ? smoothNormal 
+            : ((faceNormal == DVec3{}) == false ? faceNormal : DVec3{0, 1, 0});
+          const auto& [groupBegin, groupEnd] = groupRanges[g];
+          for (TIndex i = groupBegin; i < groupEnd; ++i) { cornerSlots[vertexCorners[i]] = slot; }
+        }
+        continue;
+      }
+
+      for (TIndex g = 0; g < groupCount; ++g)
+      {
+        const auto& faceNormal = groupNormals[g];
+        DVec3 sum = DVec3{};
+        for (TIndex h = 0; h < groupCount; ++h)
+        {
+          if (Dot(faceNormal, groupNormals[h]) < creaseCos) { continue; }
+          sum += groupNormals[h] * groupAngles[h];
+        }
+        // Degenerated faces do not have normal, so fallback to face normal or arbitrary axis.
+        const auto length = sum.GetLength();
+        const auto normal = length > 0 ? sum / length : ((faceNormal == DVec3{}) == false ? faceNormal : DVec3{0, 1, 0});
+
+        TU32 slot = 0;
+        while (slot < uniqueCounts[v] && (uniqueNormals[cornerStart + slot] == normal) == false) { ++slot; }
+        if (slot == uniqueCounts[v]) 
+        { 
+          uniqueNormals[cornerStart + slot] = normal; 
+          uniqueCounts[v] += 1;
+        }
+        const auto& [groupBegin, groupEnd] = groupRanges[g];
+        for (TIndex i = groupBegin; i < groupEnd; ++i) { cornerSlots[vertexCorners[i]] = slot; }
       }
     }
+  });
+
+  // Fourth, pack unique normals into normal list and update normal index of meshes.
+  std::vector<TIndex> normalStarts (vertexCount + 1, 0);
+  for (TIndex v = 0; v < vertexCount; ++v) { normalStarts[v + 1] = normalStarts[v] + uniqueCounts[v]; }
+  this->mNormals.assign(normalStarts.back(), DVec3{});
+  ForEachRange(vertexCount, 0, kMinChunkSize, [&](TIndex start, TIndex end)
+  {
+    for (TIndex v = start; v < end; ++v)
+    {
+      std::copy_n(&uniqueNormals[vertexStarts[v]], uniqueCounts[v], &this->mNormals[normalStarts[v]]);
+    }
+  });
+  for (TIndex m = 0, size = pMeshes.size(); m < size; ++m)
+  {
+    auto& indices = pMeshes[m]->GetMutableIndices();
+    ForEachRange(indices.size(), 0, kMinChunkSize, [&](TIndex start, TIndex end)
+    {
+      for (TIndex i = start; i < end; ++i)
+      {
+        const auto corner = cornerOffsets[m] + i;
+        indices[i].mNormalIndex = TI32(normalStarts[cornerVertices[corner]] + cornerSlots[corner]);
+      }
+    });
   }
 
   return true;
 }
 
+void DModelBuffer::ReleaseNormals() noexcept
+{
+  this->mNormals.clear();
+  this->mNormals.shrink_to_fit();
+  this->mMappedNormals = {};
+}
+
 TIndex DModelBuffer::GetCountOfVertices() const noexcept
 {
-  return this->mVertices.size();
+  return this->GetVertices().size();
 }
 
 TIndex DModelBuffer::GetCountOfNormals() const noexcept
 {
-  return this->mNormals.size();
+  return this->GetNormals().size();
 }
 
 TIndex DModelBuffer::GetCountOfUv0s() const noexcept
 {
-  return this->mUV0s.size();
+  return this->GetUV0s().size();
 }
 
 bool DModelBuffer::HasVertices() const noexcept
 {
-  return this->mVertices.empty() == false;
+  return this->GetCountOfVertices() != 0;
 }
 
 bool DModelBuffer::HasNormals() const noexcept
@@ -130,21 +635,24 @@ bool DModelBuffer::HasNormals() const noexcept
 
 bool DModelBuffer::HasUv0s() const noexcept
 {
-  return this->mUV0s.empty() == false;
+  return this->GetCountOfUv0s() != 0;
 }
 
-const DModelBuffer::TPointVertices& DModelBuffer::GetVertices() const noexcept
+PArrayView<DVec3> DModelBuffer::GetVertices() const noexcept
 {
+  if (this->IsMapped() == true) { return this->mMappedVertices; }
   return this->mVertices;
 }
 
-const DModelBuffer::TNormals& DModelBuffer::GetNormals() const noexcept
+PArrayView<DVec3> DModelBuffer::GetNormals() const noexcept
 {
+  if (this->IsMapped() == true) { return this->mMappedNormals; }
   return this->mNormals;
 }
 
-const DModelBuffer::TUVs& DModelBuffer::GetUV0s() const noexcept
+PArrayView<DVec2> DModelBuffer::GetUV0s() const noexcept
 {
+  if (this->IsMapped() == true) { return this->mMappedUV0s; }
   return this->mUV0s;
 }
 
@@ -12,6 +12,7 @@
 ///
 
 #include <Resource/DModelMesh.hpp>
+#include <algorithm>
 #include <Manager/MModel.hpp>
 #include <Manager/MMaterial.hpp>
 
@@ -22,12 +23,12 @@ DModelMesh::DModelMesh(const PCtor& ctor)
   : mId { ctor.mId },
     mDefaultMatId { ctor.mpMatId != nullptr ? *ctor.mpMatId : DMatId{} },
     mModelBufferId { ctor.mBufferId },
-    mName { ctor.mpShape->name },
-    mIndices ( ctor.mpShape->mesh.indices.size() )
+    mName { *ctor.mpName },
+    mIsMapped { ctor.mpIndices == nullptr },
+    mMappedIndices { ctor.mMappedIndices },
+    mMappedTriangles { ctor.mMappedTriangles }
 {
-  // Copy indices.
-  static_assert(sizeof(DModelIndex) == sizeof(tinyobj::index_t));
-  std::memcpy(this->mIndices.data(), ctor.mpShape->mesh.indices.data(), sizeof(DModelIndex) * this->mIndices.size());
+  if (this->mIsMapped == false) { this->mIndices = std::move(*ctor.mpIndices); }
 
   // Check given id is valid.
   if (this->HasDefaultMaterial() == true)
@@ -43,44 +44,67 @@ DModelMesh::DModelMesh(const PCtor& ctor)
   }
 }
 
-void DModelMesh::CreateFaces()
+void DModelMesh::CreateTriangles()
 {
-  // Create Face and AABB.
-  const auto* mpBuffer  = EXPR_SGT(MModel).GetModelBuffer(this->mModelBufferId);
-  const auto& vertices  = mpBuffer->GetVertices();
-  const auto& normals   = mpBuffer->GetNormals();
-  const auto& uv0s      = mpBuffer->GetUV0s();
-  for (TIndex i = 0, size = this->mIndices.size(); i < size; i += 3)
+  // Mapped mesh already has triangles.
+  if (this->mIsMapped == true) { return; }
+
+  // Create triangles that only have vertex indices. 
+  // Normals and uvs are referred with index list, and bounds are computed while building tree.
+  [[maybe_unused]] const auto vertexCount 
+    = EXPR_SGT(MModel).GetModelBuffer(this->mModelBufferId)->GetVertices().size();
+  this->mTriangles.clear();
+  this->mTriangles.reserve(this->mIndices.size() / 3);
+  for (TIndex i = 0, size = this->mIndices.size(); i + 2 < size; i += 3)
   {
-    const auto& i0 = this->mIndices[i+0];
-    const auto& i1 = this->mIndices[i+1];
-    const auto& i2 = this->mIndices[i+2];
-
-    DModelFace face;
-    face.mVertex = {&vertices[i0.mVertexIndex], &vertices[i1.mVertexIndex], &vertices[i2.mVertexIndex]};
-    face.mNormal = {&normals[i0.mNormalIndex], &normals[i1.mNormalIndex], &normals[i2.mNormalIndex]};
-    face.mIndex  = {i, i+1, i+2};
-
-    if (i0.mUv0Index != -1) { face.mUv0[0] = &uv0s[i0.mUv0Index]; }
-    if (i1.mUv0Index != -1) { face.mUv0[1] = &uv0s[i1.mUv0Index]; }
-    if (i2.mUv0Index != -1) { face.mUv0[2] = &uv0s[i2.mUv0Index]; }
-    
-    const auto flag = face.CreateAABB();
-    assert(flag == true);
+    DModelTriangle triangle;
+    for (TIndex k = 0; k < 3; ++k)
+    {
+      const auto vertexIndex = this->mIndices[i+k].mVertexIndex;
+      assert(vertexIndex >= 0 && TIndex(vertexIndex) < vertexCount);
+      triangle.mVertex[k] = TU32(vertexIndex);
+    }
+    this->mTriangles.emplace_back(triangle);
+  }
+  this->mTriangles.shrink_to_fit();
+}
+
+void DModelMesh::CreateKdTree(TIndex width, TIndex quantizeBits)
+{
+  this->mLocalSpaceTree.Clear();
+  if (this->mLocalSpaceWideTree != nullptr) { this->mLocalSpaceWideTree = nullptr; }
+
+  const auto* pBuffer = EXPR_SGT(MModel).GetModelBuffer(this->mModelBufferId);
+  // Binary tree of N triangles has at most 2N - 1 nodes, so all nodes are placed in one chunk.
+  this->mLocalSpaceTree.Reserve(std::max<TIndex>(this->mTriangles.size() * 2, 1) - 1, 0);
+  auto& root = this->mLocalSpaceTree.CreateNode();
+  root.BuildTree(this->mLocalSpaceTree, this->GetTriangles(), pBuffer->GetVertices());
 
-    this->mFaces.emplace_back(std::move(face));
+  // Collapse binary tree into wide tree if needed. Binary tree is kept for packet traversal.
+  if (width == 4 || width == 8)
+  {
+    this->mLocalSpaceWideTree = std::make_unique<DWideTree<DTreeNode>>();
+    this->mLocalSpaceWideTree->BuildFrom(root, width, quantizeBits);
   }
 }
 
-void DModelMesh::CreateKdTree()
+void DModelMesh::RestoreKdTree(
+  PArrayView<DTreeNode::PFlatNode> nodes, const DTriangleBlock* pBlocks, 
+  TIndex width, TIndex quantizeBits)
 {
-  if (this->mLocalSpaceTree != nullptr) { this->mLocalSpaceTree = nullptr; }
+  this->mLocalSpaceTree.Clear();
+  if (this->mLocalSpaceWideTree != nullptr) { this->mLocalSpaceWideTree = nullptr; }
 
-  std::vector<const DModelFace*> pFaces;
-  for (const auto& face : this->mFaces) { pFaces.emplace_back(&face); }
+  // Leaves refer to given blocks, so only nodes are created from arena.
+  this->mLocalSpaceTree.Reserve(nodes.size(), 0);
+  auto& root = this->mLocalSpaceTree.CreateNode();
+  root.Restore(this->mLocalSpaceTree, nodes, pBlocks);
 
-  this->mLocalSpaceTree = std::make_unique<DTreeNode>();
-  this->mLocalSpaceTree->BuildTree(pFaces);
+  if (width == 4 || width == 8)
+  {
+    this->mLocalSpaceWideTree = std::make_unique<DWideTree<DTreeNode>>();
+    this->mLocalSpaceWideTree->BuildFrom(root, width, quantizeBits);
+  }
 }
 
 const DMeshId& DModelMesh::GetId() const noexcept
@@ -108,24 +132,37 @@ const std::string& DModelMesh::GetName() const noexcept
   return this->mName;
 }
 
-std::vector<DModelIndex>& DModelMesh::GetIndices() noexcept
+PArrayView<DModelIndex> DModelMesh::GetIndices() const noexcept
 {
+  if (this->mIsMapped == true) { return this->mMappedIndices; }
   return this->mIndices;
 }
 
-const std::vector<DModelIndex>& DModelMesh::GetIndices() const noexcept
+std::vector<DModelIndex>& DModelMesh::GetMutableIndices() noexcept
 {
+  assert(this->mIsMapped == false);
   return this->mIndices;
 }
 
-const std::vector<DModelFace>& DModelMesh::GetFaces() const noexcept
+PArrayView<DModelTriangle> DModelMesh::GetTriangles() const noexcept
+{
+  if (this->mIsMapped == true) { return this->mMappedTriangles; }
+  return this->mTriangles;
+}
+
+bool DModelMesh::IsMapped() const noexcept
 {
-  return this->mFaces;
+  return this->mIsMapped;
 }
 
 const DTreeNode& DModelMesh::GetTreeHeader() const noexcept
 {
-  return *this->mLocalSpaceTree;
+  return this->mLocalSpaceTree.GetRoot();
+}
+
+const DWideTree<DTreeNode>* DModelMesh::GetWideTree() const noexcept
+{
+  return this->mLocalSpaceWideTree.get();
 }
 
 } /// ::ray namespace
\ No newline at end of file
@@ -0,0 +1,565 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Resource/XMeshCache.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <Helper/XHelperParallel.hpp>
+#include <Resource/DModelMesh.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+constexpr char kMagic[8] = { 'S', 'H', 'M', 'E', 'S', 'H', '\0', '\0' };
+/// @brief Version of file format. Increase it when layout of records is changed.
+constexpr TU32 kVersion = 2;
+constexpr TU32 kByteOrder = 0x01020304;
+/// @brief Alignment of list sections. It covers 32-byte alignment of triangle blocks.
+constexpr TU64 kSectionAlignment = 64;
+constexpr TIndex kTextureCount = 7;
+
+/// @brief Range of section in file. `mCount` is the count of items, or byte size of string.
+struct PSection final
+{
+  TU64 mOffset = 0;
+  TU64 mCount = 0;
+};
+
+struct PFileHeader final
+{
+  char mMagic[8];
+  TU32 mVersion = kVersion;
+  TU32 mByteOrder = kByteOrder;
+  TU64 mLayoutHash = 0;
+  PMeshCacheKey mKey;
+  TU64 mFileSize = 0;
+  PSection mVertices;
+  PSection mNormals;
+  PSection mUV0s;
+  PSection mMeshes;
+  PSection mMaterials;
+  PSection mLibraries;
+};
+
+struct PMeshRecord final
+{
+  PSection mName;
+  PSection mIndices;
+  PSection mTriangles;
+  PSection mNodes;
+  PSection mBlocks;
+  TI32 mMaterialIndex = -1;
+  TU32 mPadding = 0;
+};
+
+struct PMaterialRecord final
+{
+  float mAmbient[3];
+  float mDiffuse[3];
+  float mSpecular[3];
+  float mTransmittance[3];
+  float mEmission[3];
+  float mShininess;
+  float mIor;
+  float mDissolve;
+  PSection mTextures[kTextureCount];
+};
+
+struct PLibraryRecord final
+{
+  PSection mPath;
+  TU64 mSize = 0;
+  TU64 mHash = 0;
+};
+
+/// @brief Get texture name members of material, in order of `PMaterialRecord::mTextures`.
+template <typename TMaterial>
+auto GetTexturesOf(TMaterial& material) noexcept
+{
+  return std::array<decltype(&material.ambient_texname), kTextureCount>{
+    &material.ambient_texname, &material.diffuse_texname, &material.specular_texname, 
+    &material.specular_highlight_texname, &material.bump_texname, &material.displacement_texname, 
+    &material.alpha_texname };
+}
+
+/// @brief Hash content by block of this size. Block hashes are independent, so blocks are hashed in parallel.
+constexpr TIndex kHashBlockSize = 1 << 22;
+constexpr TU64 kHashPrime1 = 0x9E3779B185EBCA87ull;
+constexpr TU64 kHashPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+/// @brief Mix given 64-bit word into hash. (Round of xxHash64)
+TU64 MixWord(TU64 hash, TU64 word) noexcept
+{
+  hash += word * kHashPrime2;
+  hash = (hash << 31) | (hash >> 33);
+  return hash * kHashPrime1;
+}
+
+/// @brief Avalanche bits of hash value. (SplitMix64 finalizer)
+TU64 Finalize(TU64 hash) noexcept
+{
+  hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+  return hash ^ (hash >> 31);
+}
+
+/// @brief Hash content of block word by word. Remained bytes are zero-padded into the last word.
+TU64 GetBlockHashOf(const char* pData, TIndex size) noexcept
+{
+  TU64 hash = kHashPrime1 ^ TU64(size);
+  TIndex i = 0;
+  for (; i + sizeof(TU64) <= size; i += sizeof(TU64))
+  {
+    TU64 word;
+    std::memcpy(&word, pData + i, sizeof(TU64));
+    hash = MixWord(hash, word);
+  }
+  if (i < size)
+  {
+    TU64 word = 0;
+    std::memcpy(&word, pData + i, size - i);
+    hash = MixWord(hash, word);
+  }
+  return Finalize(hash);
+}
+
+/// @brief Get hash of sizes of stored types. 
+/// Cache file that is written by build of different type layout is regarded as stale.
+TU64 GetLayoutHash() noexcept
+{
+  const TU64 sizes[] = {
+    sizeof(TIndex), sizeof(DVec3), sizeof(DVec2), sizeof(DModelIndex), sizeof(DModelTriangle), 
+    sizeof(DTreeNode::PFlatNode), sizeof(DTriangleBlock), alignof(DTriangleBlock), DTriangleBlock::kWidth,
+    offsetof(DTriangleBlock, mTriangle), offsetof(DTriangleBlock, mCount),
+    sizeof(PFileHeader), sizeof(PMeshRecord), sizeof(PMaterialRecord), sizeof(PLibraryRecord) };
+  return GetContentHashOf(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+}
+
+/// @class FCacheWriter
+/// @brief Write sections of cache file sequentially and track offset of them.
+class FCacheWriter final
+{
+public:
+  explicit FCacheWriter(std::ofstream& stream) : mStream { stream } {}
+
+  /// @brief Write items into new aligned section.
+  template <typename TType>
+  PSection WriteList(const TType* pItems, TIndex count)
+  {
+    this->Align();
+    const PSection section = { this->mOffset, count };
+    this->WriteBytes(pItems, sizeof(TType) * count);
+    return section;
+  }
+
+  /// @brief Write string into new unaligned section.
+  PSection WriteString(const std::string& value)
+  {
+    const PSection section = { this->mOffset, value.size() };
+    this->WriteBytes(value.data(), value.size());
+    return section;
+  }
+
+  void WriteBytes(const void* pData, TIndex size)
+  {
+    this->mStream.write(static_cast<const char*>(pData), std::streamsize(size));
+    this->mOffset += size;
+  }
+
+  /// @brief Write zero padding until offset is aligned.
+  void Align()
+  {
+    static constexpr char kZeros[kSectionAlignment] = {};
+    const auto padding = (kSectionAlignment - this->mOffset % kSectionAlignment) % kSectionAlignment;
+    this->WriteBytes(kZeros, padding);
+  }
+
+  TU64 GetOffset() const noexcept { return this->mOffset; }
+
+private:
+  std::ofstream& mStream;
+  TU64 mOffset = 0;
+};
+
+/// @class FCacheReader
+/// @brief Get sections of mapped cache file with validating their ranges.
+class FCacheReader final
+{
+public:
+  explicit FCacheReader(const FMappedFile& file) : mpData { file.GetData() }, mSize { file.GetSize() } {}
+
+  /// @brief Get items of aligned section.
+  /// @return If section is aligned and in range of file, return true. Otherwise, return false.
+  template <typename TType>
+  bool GetList(const PSection& section, PArrayView<TType>& oItems) const noexcept
+  {
+    if (section.mCount == 0) { oItems = {}; return true; }
+    if (section.mOffset % kSectionAlignment != 0 || section.mOffset > this->mSize) { return false; }
+    if (section.mCount > (this->mSize - section.mOffset) / sizeof(TType)) { return false; }
+
+    oItems = { reinterpret_cast<const TType*>(this->mpData + section.mOffset), TIndex(section.mCount) };
+    return true;
+  }
+
+  /// @brief Get string of section.
+  /// @return If section is in range of file, return true. Otherwise, return false.
+  bool GetString(const PSection& section, std::string& oValue) const
+  {
+    if (section.mOffset > this->mSize || section.mCount > this->mSize - section.mOffset) { return false; }
+
+    oValue.assign(this->mpData + section.mOffset, section.mCount);
+    return true;
+  }
+
+private:
+  const char* mpData;
+  TU64 mSize;
+};
+
+/// @brief Check all references of mesh are in range of given lists, and get depth of tree of mesh.
+bool IsValidMesh(
+  const PMeshCacheMesh& mesh, 
+  TIndex vertexCount, TIndex normalCount, TIndex uvCount, TIndex materialCount, 
+  TIndex& outTreeDepth)
+{
+  if (mesh.mMaterialIndex < -1 || mesh.mMaterialIndex >= TI32(materialCount)) { return false; }
+  if (mesh.mIndices.size() % 3 != 0 || mesh.mTriangles.size() != mesh.mIndices.size() / 3) { return false; }
+  if (mesh.mNodes.empty() == true) { return false; }
+
+  const auto IsInRange = [](TI32 value, TIndex count) { return value >= 0 && TIndex(value) < count; };
+  for (const auto& index : mesh.mIndices)
+  {
+    if (IsInRange(index.mVertexIndex, vertexCount) == false) { return false; }
+    if (index.mNormalIndex != -1 && IsInRange(index.mNormalIndex, normalCount) == false) { return false; }
+    if (index.mUv0Index != -1 && IsInRange(index.mUv0Index, uvCount) == false) { return false; }
+  }
+  for (TIndex i = 0, size = mesh.mTriangles.size(); i < size; ++i)
+  {
+    for (TIndex k = 0; k < 3; ++k)
+    {
+      if (mesh.mTriangles[i].mVertex[k] != TU32(mesh.mIndices[i * 3 + k].mVertexIndex)) { return false; }
+    }
+  }
+
+  // Children are always placed after parent, so restoring tree never loops.
+  // Each node except root must have one parent, so restored tree is not bigger than flattened nodes.
+  // Depth of child is decided when parent is visited, because parent is placed before it.
+  using PFlatNode = DTreeNode::PFlatNode;
+  std::vector<TU32> depths (mesh.mNodes.size(), 0);
+  outTreeDepth = 1;
+  for (TIndex i = 0, size = mesh.mNodes.size(); i < size; ++i)
+  {
+    const auto& node = mesh.mNodes[i];
+    if (i > 0 && depths[i] == 0) { return false; }
+    if (node.mLeft == PFlatNode::kNone && node.mRight == PFlatNode::kNone)
+    {
+      if (TU64(node.mBlockBegin) + node.mBlockCount > mesh.mBlocks.size()) { return false; }
+      continue;
+    }
+    if (node.mLeft <= i || node.mLeft >= size || node.mRight <= i || node.mRight >= size) { return false; }
+    if (depths[node.mLeft] != 0 || depths[node.mRight] != 0) { return false; }
+    depths[node.mLeft] = depths[node.mRight] = depths[i] + 1;
+    outTreeDepth = std::max<TIndex>(outTreeDepth, depths[i] + 2);
+  }
+  for (const auto& block : mesh.mBlocks)
+  {
+    if (block.mCount > DTriangleBlock::kWidth) { return false; }
+    for (TIndex lane = 0; lane < block.mCount; ++lane)
+    {
+      if (block.mTriangle[lane] >= mesh.mTriangles.size()) { return false; }
+    }
+  }
+  return true;
+}
+
+/// @brief Check material library file is not changed since cache file was written.
+bool IsLibraryUpToDate(const std::string& path, TU64 size, TU64 hash)
+{
+  FMappedFile file;
+  if (file.Open(path.c_str()) == false) { return false; }
+  return file.GetSize() == size && GetContentHashOf(file.GetData(), file.GetSize()) == hash;
+}
+
+} /// anonymous namespace
+
+namespace ray
+{
+
+TU64 GetContentHashOf(const char* pData, TIndex size)
+{
+  // Small content (such as settings) is hashed as one block without spawning threads.
+  if (size <= kHashBlockSize) { return Finalize(MixWord(kHashPrime2 ^ TU64(size), GetBlockHashOf(pData, size))); }
+
+  // Blocks are split evenly into one contiguous range per thread of budget.
+  const auto blockCount = (size + kHashBlockSize - 1) / kHashBlockSize;
+  std::vector<TU64> blockHashes (blockCount);
+  const auto threadCount = std::clamp<TIndex>(GetParallelThreadCount(), 1, blockCount);
+  const auto HashBlocks = [&](TIndex thread)
+  {
+    for (TIndex b = blockCount * thread / threadCount, end = blockCount * (thread + 1) / threadCount; b < end; ++b)
+    {
+      const auto offset = b * kHashBlockSize;
+      blockHashes[b] = GetBlockHashOf(pData + offset, std::min(kHashBlockSize, size - offset));
+    }
+  };
+  ForEachThread(threadCount, HashBlocks);
+
+  // Block hashes are combined in order, so result does not depend on thread count.
+  TU64 hash = kHashPrime2 ^ TU64(size);
+  for (const auto& blockHash : blockHashes) { hash = MixWord(hash, blockHash); }
+  return Finalize(hash);
+}
+
+bool WriteMeshCache(
+  const std::filesystem::path& path,
+  const PMeshCacheKey& key,
+  const DModelBuffer& buffer,
+  const std::vector<const DModelMesh*>& pMeshes,
+  const std::vector<TI32>& meshMaterials,
+  const std::vector<tinyobj::material_t>& materials,
+  const std::vector<std::filesystem::path>& materialLibraries)
+{
+  assert(buffer.IsMapped() == false);
+  assert(pMeshes.size() == meshMaterials.size());
+  for (const auto* pMesh : pMeshes)
+  {
+    if (pMesh->GetTreeHeader().GetDepth() > kMaxMeshCacheTreeDepth) { return false; }
+  }
+
+  // Record material libraries first, so cache file is not written when one of them can not be read.
+  std::vector<std::pair<std::string, PLibraryRecord>> libraries;
+  for (const auto& libraryPath : materialLibraries)
+  {
+    FMappedFile file;
+    if (file.Open(libraryPath.string().c_str()) == false) { return false; }
+
+    PLibraryRecord record;
+    record.mSize = file.GetSize();
+    record.mHash = GetContentHashOf(file.GetData(), file.GetSize());
+    libraries.emplace_back(libraryPath.string(), record);
+  }
+
+  std::error_code error;
+  if (path.has_parent_path() == true) { std::filesystem::create_directories(path.parent_path(), error); }
+
+  // Temporary name is unique per thread, so concurrent writers of the same cache never share file.
+  auto tempPath = path;
+  tempPath += ".tmp" 
+    + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) 
+    + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    std::ofstream stream { tempPath, std::ios::binary | std::ios::trunc };
+    if (stream.good() == false) { return false; }
+
+    // Header is written again after all sections are written.
+    FCacheWriter writer { stream };
+    PFileHeader header;
+    std::memcpy(header.mMagic, kMagic, sizeof(kMagic));
+    header.mLayoutHash = GetLayoutHash();
+    header.mKey = key;
+    writer.WriteBytes(&header, sizeof(header));
+
+    const auto vertices = buffer.GetVertices();
+    const auto normals  = buffer.GetNormals();
+    const auto uv0s     = buffer.GetUV0s();
+    header.mVertices  = writer.WriteList(vertices.data(), vertices.size());
+    header.mNormals   = writer.WriteList(normals.data(), normals.size());
+    header.mUV0s      = writer.WriteList(uv0s.data(), uv0s.size());
+
+    std::vector<PMeshRecord> meshRecords (pMeshes.size());
+    std::vector<DTreeNode::PFlatNode> nodes;
+    std::vector<DTriangleBlock> blocks;
+    for (TIndex i = 0, size = pMeshes.size(); i < size; ++i)
+    {
+      const auto& mesh = *pMeshes[i];
+      const auto indices    = mesh.GetIndices();
+      const auto triangles  = mesh.GetTriangles();
+      nodes.clear();
+      blocks.clear();
+      mesh.GetTreeHeader().Flatten(nodes, blocks);
+
+      auto& record = meshRecords[i];
+      record.mName          = writer.WriteString(mesh.GetName());
+      record.mIndices       = writer.WriteList(indices.data(), indices.size());
+      record.mTriangles     = writer.WriteList(triangles.data(), triangles.size());
+      record.mNodes         = writer.WriteList(nodes.data(), nodes.size());
+      record.mBlocks        = writer.WriteList(blocks.data(), blocks.size());
+      record.mMaterialIndex = meshMaterials[i];
+    }
+
+    std::vector<PMaterialRecord> materialRecords (materials.size());
+    for (TIndex i = 0, size = materials.size(); i < size; ++i)
+    {
+      const auto& material = materials[i];
+      auto& record = materialRecords[i];
+      std::copy_n(material.ambient, 3, record.mAmbient);
+      std::copy_n(material.diffuse, 3, record.mDiffuse);
+      std::copy_n(material.specular, 3, record.mSpecular);
+      std::copy_n(material.transmittance, 3, record.mTransmittance);
+      std::copy_n(material.emission, 3, record.mEmission);
+      record.mShininess = material.shininess;
+      record.mIor       = material.ior;
+      record.mDissolve  = material.dissolve;
+
+      const auto textures = GetTexturesOf(material);
+      for (TIndex t = 0; t < kTextureCount; ++t) { record.mTextures[t] = writer.WriteString(*textures[t]); }
+    }
+
+    std::vector<PLibraryRecord> libraryRecords;
+    for (auto& [libraryPath, record] : libraries)
+    {
+      record.mPath = writer.WriteString(libraryPath);
+      libraryRecords.emplace_back(record);
+    }
+
+    header.mMeshes    = writer.WriteList(meshRecords.data(), meshRecords.size());
+    header.mMaterials = writer.WriteList(materialRecords.data(), materialRecords.size());
+    header.mLibraries = writer.WriteList(libraryRecords.data(), libraryRecords.size());
+    header.mFileSize  = writer.GetOffset();
+
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.close();
+    if (stream.fail() == true) 
+    { 
+      std::filesystem::remove(tempPath, error); 
+      return false; 
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, error);
+  if (error) 
+  { 
+    std::filesystem::remove(tempPath, error); 
+    return false; 
+  }
+  return true;
+}
+
+std::optional<PMeshCache> ReadMeshCache(const std::filesystem::path& path, const PMeshCacheKey& key)
+{
+  std::error_code error;
+  if (std::filesystem::is_regular_file(path, error) == false) { return std::nullopt; }
+
+  // Cache file is accessed randomly by traversal, so read-ahead is not requested.
+  auto pFile = std::make_shared<FMappedFile>();
+  if (pFile->Open(path.string().c_str(), false) == false) { return std::nullopt; }
+
+  // Check file is written with the same format, source file and settings.
+  PFileHeader header;
+  if (pFile->GetSize() < sizeof(header)) { return std::nullopt; }
+  std::memcpy(&header, pFile->GetData(), sizeof(header));
+  if (std::memcmp(header.mMagic, kMagic, sizeof(kMagic)) != 0
+  ||  header.mVersion != kVersion
+  ||  header.mByteOrder != kByteOrder
+  ||  header.mLayoutHash != GetLayoutHash()
+  ||  header.mFileSize != pFile->GetSize())
+  {
+    return std::nullopt;
+  }
+  if (header.mKey.mSourceHash != key.mSourceHash
+  ||  header.mKey.mSourceSize != key.mSourceSize
+  ||  header.mKey.mSettingHash != key.mSettingHash
+  ||  header.mKey.mBuilderVersion != key.mBuilderVersion)
+  {
+    return std::nullopt;
+  }
+
+  const auto Fail = [&path]() -> std::optional<PMeshCache>
+  {
+    std::cerr << "Warning : Mesh cache `" << path.string() << "` is broken. Model file is loaded again.\n";
+    return std::nullopt;
+  };
+
+  const FCacheReader reader { *pFile };
+  PArrayView<PLibraryRecord> libraryRecords;
+  if (reader.GetList(header.mLibraries, libraryRecords) == false) { return Fail(); }
+  for (const auto& record : libraryRecords)
+  {
+    std::string libraryPath;
+    if (reader.GetString(record.mPath, libraryPath) == false) { return Fail(); }
+    if (IsLibraryUpToDate(libraryPath, record.mSize, record.mHash) == false) { return std::nullopt; }
+  }
+
+  PMeshCache cache;
+  PArrayView<PMeshRecord> meshRecords;
+  PArrayView<PMaterialRecord> materialRecords;
+  if (reader.GetList(header.mVertices, cache.mVertices) == false
+  ||  reader.GetList(header.mNormals, cache.mNormals) == false
+  ||  reader.GetList(header.mUV0s, cache.mUV0s) == false
+  ||  reader.GetList(header.mMeshes, meshRecords) == false
+  ||  reader.GetList(header.mMaterials, materialRecords) == false)
+  {
+    return Fail();
+  }
+
+  for (const auto& record : materialRecords)
+  {
+    tinyobj::material_t material;
+    std::copy_n(record.mAmbient, 3, material.ambient);
+    std::copy_n(record.mDiffuse, 3, material.diffuse);
+    std::copy_n(record.mSpecular, 3, material.specular);
+    std::copy_n(record.mTransmittance, 3, material.transmittance);
+    std::copy_n(record.mEmission, 3, material.emission);
+    material.shininess  = record.mShininess;
+    material.ior        = record.mIor;
+    material.dissolve   = record.mDissolve;
+
+    const auto textures = GetTexturesOf(material);
+    for (TIndex t = 0; t < kTextureCount; ++t)
+    {
+      if (reader.GetString(record.mTextures[t], *textures[t]) == false) { return Fail(); }
+    }
+    cache.mMaterials.emplace_back(std::move(material));
+  }
+
+  for (const auto& record : meshRecords)
+  {
+    PMeshCacheMesh mesh;
+    mesh.mMaterialIndex = record.mMaterialIndex;
+    if (reader.GetString(record.mName, mesh.mName) == false
+    ||  reader.GetList(record.mIndices, mesh.mIndices) == false
+    ||  reader.GetList(record.mTriangles, mesh.mTriangles) == false
+    ||  reader.GetList(record.mNodes, mesh.mNodes) == false
+    ||  reader.GetList(record.mBlocks, mesh.mBlocks) == false)
+    {
+      return Fail();
+    }
+    TIndex treeDepth = 0;
+    if (IsValidMesh(mesh, 
+        cache.mVertices.size(), cache.mNormals.size(), cache.mUV0s.size(), cache.mMaterials.size(), treeDepth) == false)
+    {
+      return Fail();
+    }
+    if (treeDepth > kMaxMeshCacheTreeDepth)
+    {
+      std::cerr << "Warning : Tree of mesh cache `" << path.string() << "` is deeper than " 
+        << kMaxMeshCacheTreeDepth << ". Model file is loaded again.\n";
+      return std::nullopt;
+    }
+    cache.mMeshes.emplace_back(std::move(mesh));
+  }
+
+  cache.mpFile = std::move(pFile);
+  return cache;
+}
+
+} /// ::ray namespace
@@ -0,0 +1,516 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include <Resource/XObjLoader.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <Helper/XHelperParallel.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @brief State change of obj file that splits shapes or loads materials.
+struct PStateChange final
+{
+  enum class EType { Group, Material, MaterialLibrary };
+  EType       mType;
+  std::string mName;
+  /// @brief The count of triangles of chunk that are placed before this change.
+  TIndex      mTriangle = 0;
+};
+
+/// @brief Line-aligned part of obj content.
+struct PChunk final
+{
+  const char* mpBegin = nullptr;
+  const char* mpEnd   = nullptr;
+  TIndex mVertexCount   = 0;
+  TIndex mNormalCount   = 0;
+  TIndex mUvCount       = 0;
+  TIndex mTriangleCount = 0;
+  std::vector<PStateChange> mChanges;
+
+  /// @brief Global offsets of chunk in final lists. Set up after all chunks are counted.
+  TIndex mVertexOffset    = 0;
+  TIndex mNormalOffset    = 0;
+  TIndex mUvOffset        = 0;
+  TIndex mTriangleOffset  = 0;
+  /// @brief The first error of chunk. If empty, chunk is parsed successfully.
+  std::string mError;
+};
+
+/// @brief Contiguous triangle range of file that becomes one shape.
+struct PShapeRange final
+{
+  TIndex mTriangleBegin = 0;
+  TIndex mTriangleEnd   = 0;
+};
+
+/// @brief Line type of obj file that loader uses.
+enum class ELineType { Vertex, Normal, Uv, Face, Group, Object, UseMaterial, MaterialLibrary, Other };
+
+bool IsSpace(char c) noexcept { return c == ' ' || c == '\t'; }
+
+const char* SkipSpaces(const char* p, const char* end) noexcept
+{
+  while (p < end && IsSpace(*p) == true) { ++p; }
+  return p;
+}
+
+/// @brief Get the end of token that starts from given pointer.
+const char* GetTokenEnd(const char* p, const char* end) noexcept
+{
+  while (p < end && IsSpace(*p) == false) { ++p; }
+  return p;
+}
+
+/// @brief Get type of given line, and move pointer into the first argument of line.
+ELineType GetLineType(const char*& p, const char* end) noexcept
+{
+  p = SkipSpaces(p, end);
+  const auto tokenEnd = GetTokenEnd(p, end);
+  const auto length = TIndex(tokenEnd - p);
+  const auto IsToken = [p, length](const char* token) 
+  { 
+    return std::strlen(token) == length && std::memcmp(p, token, length) == 0; 
+  };
+
+  auto type = ELineType::Other;
+  if      (IsToken("v") == true)      { type = ELineType::Vertex; }
+  else if (IsToken("vn") == true)     { type = ELineType::Normal; }
+  else if (IsToken("vt") == true)     { type = ELineType::Uv; }
+  else if (IsToken("f") == true)      { type = ELineType::Face; }
+  else if (IsToken("g") == true)      { type = ELineType::Group; }
+  else if (IsToken("o") == true)      { type = ELineType::Object; }
+  else if (IsToken("usemtl") == true) { type = ELineType::UseMaterial; }
+  else if (IsToken("mtllib") == true) { type = ELineType::MaterialLibrary; }
+
+  p = SkipSpaces(tokenEnd, end);
+  return type;
+}
+
+/// @brief Get the first token of line. If not exist, return empty string.
+std::string GetFirstToken(const char* p, const char* end)
+{
+  p = SkipSpaces(p, end);
+  return std::string(p, GetTokenEnd(p, end));
+}
+
+/// @brief Parse decimal floating number, such as `-1.5e-3`. Parsed characters are skipped.
+/// Locale and allocation are not used, so it can be called from many threads.
+float ParseFloat(const char*& p, const char* end) noexcept
+{
+  static constexpr double kPowers[] = 
+  { 
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 
+  };
+
+  p = SkipSpaces(p, end);
+  bool isNegative = false;
+  if (p < end && (*p == '-' || *p == '+')) { isNegative = *p == '-'; ++p; }
+
+  double mantissa = 0;
+  int exponent = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) { mantissa = mantissa * 10 + (*p - '0'); }
+  if (p < end && *p == '.')
+  {
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p) { mantissa = mantissa * 10 + (*p - '0'); --exponent; }
+  }
+  if (p < end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool isNegativeExponent = false;
+    if (p < end && (*p == '-' || *p == '+')) { isNegativeExponent = *p == '-'; ++p; }
+    int value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) { value = std::min(value * 10 + (*p - '0'), 9999); }
+    exponent += isNegativeExponent == true ? -value : value;
+  }
+  p = GetTokenEnd(p, end);
+
+  if (exponent != 0)
+  {
+    const auto absExponent = std::abs(exponent);
+    const auto power = absExponent <= 22 ? kPowers[absExponent] : std::pow(10.0, absExponent);
+    mantissa = exponent < 0 ? mantissa / power : mantissa * power;
+  }
+  return float(isNegative == true ? -mantissa : mantissa);
+}
+
+/// @brief Parse decimal integer. If digits are not exist, return false.
+bool ParseInteger(const char*& p, const char* end, TI64& oValue) noexcept
+{
+  bool isNegative = false;
+  if (p < end && (*p == '-' || *p == '+')) { isNegative = *p == '-'; ++p; }
+  if (p >= end || *p < '0' || *p > '9') { return false; }
+
+  TI64 value = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) { value = value * 10 + (*p - '0'); }
+  oValue = isNegative == true ? -value : value;
+  return true;
+}
+
+/// @brief Convert 1-based (or negative relative) obj index into 0-based index.
+/// @param countSoFar The count of items that are defined before current line.
+/// @return If index is out of range, return -1.
+TI32 ResolveIndex(TI64 index, TIndex countSoFar, TIndex totalCount) noexcept
+{
+  const TI64 resolved = index > 0 ? index - 1 : TI64(countSoFar) + index;
+  if (index == 0 || resolved < 0 || resolved >= TI64(totalCount)) { return -1; }
+  return TI32(resolved);
+}
+
+/// @brief Call given function with [begin, end) of each line of range, without line feed and carriage return.
+template <typename TFunc>
+void ForEachLine(const char* pBegin, const char* pEnd, TFunc&& lineFunc)
+{
+  for (const char* p = pBegin; p < pEnd; )
+  {
+    const auto* pFeed = static_cast<const char*>(std::memchr(p, '\n', pEnd - p));
+    const auto* pLineEnd = pFeed != nullptr ? pFeed : pEnd;
+    const auto* pNext = pFeed != nullptr ? pFeed + 1 : pEnd;
+    if (pLineEnd > p && *(pLineEnd - 1) == '\r') { --pLineEnd; }
+    if (lineFunc(p, pLineEnd) == false) { return; }
+    p = pNext;
+  }
+}
+
+/// @brief Split content into line-aligned chunks, one per thread of budget.
+std::vector<PChunk> CreateChunks(const char* pData, TIndex size)
+{
+  // Small content is not worth to spawn threads.
+  constexpr TIndex kMinChunkSize = 1 << 20;
+  const auto chunkCount = std::clamp<TIndex>(
+    GetParallelThreadCount(), 1, std::max<TIndex>(size / kMinChunkSize, 1));
+
+  std::vector<PChunk> chunks;
+  const char* pBegin = pData;
+  const char* const pEnd = pData + size;
+  for (TIndex i = 1; i <= chunkCount && pBegin < pEnd; ++i)
+  {
+    const char* pChunkEnd = pEnd;
+    if (i < chunkCount)
+    {
+      pChunkEnd = std::max(pBegin, pData + size * i / chunkCount);
+      const auto* pFeed = static_cast<const char*>(std::memchr(pChunkEnd, '\n', pEnd - pChunkEnd));
+      pChunkEnd = pFeed != nullptr ? pFeed + 1 : pEnd;
+    }
+
+    PChunk chunk;
+    chunk.mpBegin = pBegin;
+    chunk.mpEnd = pChunkEnd;
+    chunks.emplace_back(std::move(chunk));
+    pBegin = pChunkEnd;
+  }
+  return chunks;
+}
+
+/// @brief First pass. Count items of chunk and record state changes, without parsing numbers.
+void CountChunk(PChunk& chunk)
+{
+  ForEachLine(chunk.mpBegin, chunk.mpEnd, [&chunk](const char* p, const char* end)
+  {
+    switch (GetLineType(p, end))
+    {
+    case ELineType::Vertex: ++chunk.mVertexCount; break;
+    case ELineType::Normal: ++chunk.mNormalCount; break;
+    case ELineType::Uv:     ++chunk.mUvCount; break;
+    case ELineType::Face: 
+    {
+      TIndex cornerCount = 0;
+      for (p = SkipSpaces(p, end); p < end; p = SkipSpaces(GetTokenEnd(p, end), end)) { ++cornerCount; }
+      if (cornerCount >= 3) { chunk.mTriangleCount += cornerCount - 2; }
+    } break;
+    case ELineType::Group:
+    case ELineType::Object:
+      chunk.mChanges.push_back({PStateChange::EType::Group, GetFirstToken(p, end), chunk.mTriangleCount});
+      break;
+    case ELineType::UseMaterial:
+      chunk.mChanges.push_back({PStateChange::EType::Material, GetFirstToken(p, end), chunk.mTriangleCount});
+      break;
+    case ELineType::MaterialLibrary:
+      chunk.mChanges.push_back({PStateChange::EType::MaterialLibrary, std::string(p, end), chunk.mTriangleCount});
+      break;
+    default: break;
+    }
+    return true;
+  });
+}
+
+/// @brief Find the first material library file that is exist in given name list of `mtllib` line.
+std::optional<std::filesystem::path> FindMaterialLibrary(
+  const std::string& names, 
+  const std::filesystem::path& directory)
+{
+  const auto* p = names.data();
+  const auto* const end = names.data() + names.size();
+  for (p = SkipSpaces(p, end); p < end; p = SkipSpaces(GetTokenEnd(p, end), end))
+  {
+    const std::string name (p, GetTokenEnd(p, end));
+    for (const auto& path : {directory / name, std::filesystem::path{name}})
+    {
+      if (std::ifstream{path}.good() == true) { return path; }
+    }
+  }
+  return std::nullopt;
+}
+
+/// @brief Load the first material library that is found in given name list.
+void LoadMaterialLibrary(
+  const std::string& names, 
+  const std::filesystem::path& directory, 
+  std::map<std::string, int>& ioMaterialMap, 
+  std::vector<tinyobj::material_t>& ioMaterials,
+  std::vector<std::filesystem::path>& ioLibraries)
+{
+  const auto optPath = FindMaterialLibrary(names, directory);
+  std::ifstream stream;
+  if (optPath.has_value() == true) { stream.open(*optPath); }
+  if (stream.is_open() == false)
+  {
+    std::cerr << "Warning : Failed to load material file(s) `" << names << "`. Use default material.\n";
+    return;
+  }
+
+  std::string warning;
+  tinyobj::LoadMtl(&ioMaterialMap, &ioMaterials, &stream, &warning);
+  if (warning.empty() == false) { std::cerr << warning; }
+  ioLibraries.emplace_back(*optPath);
+}
+
+/// @brief Second pass. Parse items of chunk and write them into global offsets of final lists.
+void ParseChunk(PChunk& chunk, const std::vector<PShapeRange>& ranges, ray::PObjModel& ioModel)
+{
+  const auto totalVertices  = ioModel.mVertices.size();
+  const auto totalNormals   = ioModel.mNormals.size();
+  const auto totalUvs       = ioModel.mUV0s.size();
+
+  auto vertex   = chunk.mVertexOffset;
+  auto normal   = chunk.mNormalOffset;
+  auto uv       = chunk.mUvOffset;
+  auto triangle = chunk.mTriangleOffset;
+
+  // Find the first shape that has triangle of chunk.
+  auto shape = TIndex(std::upper_bound(ranges.begin(), ranges.end(), triangle,
+    [](TIndex value, const PShapeRange& range) { return value < range.mTriangleEnd; }) - ranges.begin());
+
+  std::vector<DModelIndex> corners;
+  ForEachLine(chunk.mpBegin, chunk.mpEnd, [&](const char* p, const char* end)
+  {
+    const char* const pLine = p;
+    switch (GetLineType(p, end))
+    {
+    case ELineType::Vertex: 
+    {
+      auto& value = ioModel.mVertices[vertex++];
+      for (TIndex axis = 0; axis < 3; ++axis) { value[axis] = ParseFloat(p, end); }
+    } break;
+    case ELineType::Normal: 
+    {
+      auto& value = ioModel.mNormals[normal++];
+      for (TIndex axis = 0; axis < 3; ++axis) { value[axis] = ParseFloat(p, end); }
+    } break;
+    case ELineType::Uv: 
+    {
+      auto& value = ioModel.mUV0s[uv++];
+      value.X = ParseFloat(p, end);
+      value.Y = ParseFloat(p, end);
+    } break;
+    case ELineType::Face:
+    {
+      // Each corner is `v`, `v/vt`, `v//vn` or `v/vt/vn`.
+      corners.clear();
+      for (p = SkipSpaces(p, end); p < end; p = SkipSpaces(p, end))
+      {
+        DModelIndex corner;
+        corner.mVertexIndex = -1;
+        corner.mNormalIndex = -1;
+        corner.mUv0Index    = -1;
+
+        TI64 index = 0;
+        bool isValid = ParseInteger(p, end, index) == true;
+        if (isValid == true) { corner.mVertexIndex = ResolveIndex(index, vertex, totalVertices); }
+        isValid = isValid == true && corner.mVertexIndex >= 0;
+        if (isValid == true && p < end && *p == '/')
+        {
+          ++p;
+          if (p < end && *p != '/')
+          {
+            isValid = ParseInteger(p, end, index) == true 
+              && (corner.mUv0Index = ResolveIndex(index, uv, totalUvs)) >= 0;
+          }
+          if (isValid == true && p < end && *p == '/')
+          {
+            ++p;
+            isValid = ParseInteger(p, end, index) == true
+              && (corner.mNormalIndex = ResolveIndex(index, normal, totalNormals)) >= 0;
+          }
+        }
+        if (isValid == false || (p < end && IsSpace(*p) == false))
+        {
+          chunk.mError = "Face has invalid or out of range index. `" + std::string(pLine, end) + "`";
+          return false;
+        }
+        corners.emplace_back(corner);
+      }
+
+      // Triangulate polygon as fan, and write triangles into shape that owns them.
+      for (TIndex k = 2, size = corners.size(); k < size; ++k, ++triangle)
+      {
+        while (ranges[shape].mTriangleEnd <= triangle) { ++shape; }
+        auto* pIndices = &ioModel.mShapes[shape].mIndices[(triangle - ranges[shape].mTriangleBegin) * 3];
+        pIndices[0] = corners[0];
+        pIndices[1] = corners[k - 1];
+        pIndices[2] = corners[k];
+      }
+    } break;
+    default: break;
+    }
+    return true;
+  });
+}
+
+} /// anonymous namespace
+
+namespace ray
+{
+
+std::vector<std::filesystem::path> FindMaterialLibraries(
+  const char* pData, TIndex size, 
+  const std::filesystem::path& directory)
+{
+  // Only `mtllib` keyword is searched in each chunk, and match is used when it is the first token of line.
+  static constexpr char kKeyword[] = "mtllib";
+  constexpr TIndex kKeywordLength = sizeof(kKeyword) - 1;
+  const auto chunks = CreateChunks(pData, size);
+  std::vector<std::vector<std::string>> chunkNames (chunks.size());
+  ForEachThread(chunks.size(), [&chunks, &chunkNames](TIndex i)
+  {
+    const auto& chunk = chunks[i];
+    const std::boyer_moore_horspool_searcher searcher { kKeyword, kKeyword + kKeywordLength };
+    for (const char* p = std::search(chunk.mpBegin, chunk.mpEnd, searcher); 
+         p != chunk.mpEnd; 
+         p = std::search(p + kKeywordLength, chunk.mpEnd, searcher))
+    {
+      const char* pLineBegin = p;
+      while (pLineBegin > chunk.mpBegin && IsSpace(*(pLineBegin - 1)) == true) { --pLineBegin; }
+      if (pLineBegin > chunk.mpBegin && *(pLineBegin - 1) != '\n') { continue; }
+
+      const auto* pFeed = static_cast<const char*>(std::memchr(p, '\n', chunk.mpEnd - p));
+      const char* pLineEnd = pFeed != nullptr ? pFeed : chunk.mpEnd;
+      if (pLineEnd > p && *(pLineEnd - 1) == '\r') { --pLineEnd; }
+      if (GetLineType(p, pLineEnd) != ELineType::MaterialLibrary) { continue; }
+      chunkNames[i].emplace_back(p, pLineEnd);
+    }
+  });
+
+  std::vector<std::filesystem::path> libraries;
+  for (const auto& names : chunkNames)
+  {
+    for (const auto& name : names)
+    {
+      if (auto optPath = FindMaterialLibrary(name, directory); optPath.has_value() == true) 
+      { 
+        libraries.emplace_back(std::move(*optPath)); 
+      }
+    }
+  }
+  return libraries;
+}
+
+std::optional<PObjModel> ParseObjModel(const char* pData, TIndex size, const std::filesystem::path& directory)
+{
+  // First, count items of each chunk in parallel, and compute global offset of each chunk.
+  auto chunks = CreateChunks(pData, size);
+  ForEachThread(chunks.size(), [&chunks](TIndex i) { CountChunk(chunks[i]); });
+
+  TIndex vertexCount = 0, normalCount = 0, uvCount = 0, triangleCount = 0;
+  for (auto& chunk : chunks)
+  {
+    chunk.mVertexOffset   = vertexCount;    vertexCount   += chunk.mVertexCount;
+    chunk.mNormalOffset   = normalCount;    normalCount   += chunk.mNormalCount;
+    chunk.mUvOffset       = uvCount;        uvCount       += chunk.mUvCount;
+    chunk.mTriangleOffset = triangleCount;  triangleCount += chunk.mTriangleCount;
+  }
+
+  // Second, replay state changes in file order, loading materials and splitting triangles into shapes.
+  PObjModel model;
+  std::map<std::string, int> materialMap;
+  std::vector<PShapeRange> ranges;
+  PObjShape current;
+  TIndex currentBegin = 0;
+  const auto StartShape = [&](TIndex triangle, std::string name, TI32 materialIndex)
+  {
+    if (triangle > currentBegin)
+    {
+      ranges.push_back({currentBegin, triangle});
+      model.mShapes.emplace_back(std::move(current));
+    }
+    current = PObjShape{};
+    current.mName = std::move(name);
+    current.mMaterialIndex = materialIndex;
+    currentBegin = triangle;
+  };
+
+  for (const auto& chunk : chunks)
+  {
+    for (const auto& change : chunk.mChanges)
+    {
+      const auto triangle = chunk.mTriangleOffset + change.mTriangle;
+      switch (change.mType)
+      {
+      case PStateChange::EType::Group: 
+        StartShape(triangle, change.mName, current.mMaterialIndex); 
+        break;
+      case PStateChange::EType::Material:
+      {
+        const auto it = materialMap.find(change.mName);
+        const auto materialIndex = it != materialMap.end() ? TI32(it->second) : -1;
+        if (materialIndex != current.mMaterialIndex) { StartShape(triangle, current.mName, materialIndex); }
+      } break;
+      case PStateChange::EType::MaterialLibrary:
+        LoadMaterialLibrary(change.mName, directory, materialMap, model.mMaterials, model.mMaterialLibraries);
+        break;
+      }
+    }
+  }
+  StartShape(triangleCount, {}, -1);
+
+  // Third, allocate final lists and parse each chunk into them in parallel.
+  model.mVertices.resize(vertexCount);
+  model.mNormals.resize(normalCount);
+  model.mUV0s.resize(uvCount);
+  for (TIndex i = 0, count = model.mShapes.size(); i < count; ++i)
+  {
+    model.mShapes[i].mIndices.resize((ranges[i].mTriangleEnd - ranges[i].mTriangleBegin) * 3);
+  }
+  ForEachThread(chunks.size(), [&](TIndex i) { ParseChunk(chunks[i], ranges, model); });
+
+  for (const auto& chunk : chunks)
+  {
+    if (chunk.mError.empty() == true) { continue; }
+    std::cerr << "Failed to parse obj file. " << chunk.mError << "\n";
+    return std::nullopt;
+  }
+  return model;
+}
+
+} /// ::ray namespace
@@ -16,6 +16,9 @@
 #include <Helper/XHelperJson.hpp>
 #include <Manager/MModel.hpp>
 #include <Math/Utility/XShapeMath.h>
+#include <Simd/DRayPacket.hpp>
+#include <Simd/XPacketKernel.hpp>
+#include <limits>
 
 namespace ray
 {
@@ -29,12 +32,13 @@ FModel::FModel(const PModelCtor& ctor, const IMaterial* mat)
   this->mModelId = DModelId{ctor.mModelResourceName};
   assert(EXPR_SGT(MModel).HasModel(this->mModelId) == true);
 
+  // Model buffer can be shared by prefabs of different scales, so prefab scale is applied to instance.
   const auto* pModel = EXPR_SGT(MModel).GetModel(this->mModelId);
   for (const auto& meshId : pModel->GetMeshIds())
   {
     FModelMesh::PCtor meshCtor;
     meshCtor.mOrigin  = this->mOrigin;
-    meshCtor.mScale   = this->mScale;
+    meshCtor.mScale   = this->mScale * pModel->GetScale();
     meshCtor.mAngle   = this->mRotQuat.ToDegrees();
     meshCtor.mMeshId  = meshId;
 
@@ -50,6 +54,19 @@ FModel::FModel(const PModelCtor& ctor, const IMaterial* mat)
     aabb = ::dy::math::GetUnionOf(aabb, *pMesh->GetAABB());
   }
   this->mAABB = std::make_unique<DAABB>(aabb);
+
+  // Build tree over mesh instances with the same width of mesh trees.
+  std::vector<const IHitable*> pMeshes;
+  for (const auto& pMesh : this->mpMeshes) { pMeshes.emplace_back(pMesh.get()); }
+  this->mMeshTree.Reserve(pMeshes.size() * 2 - 1, pMeshes.size());
+  auto& root = this->mMeshTree.CreateNode();
+  root.BuildTree(this->mMeshTree, pMeshes);
+
+  if (const auto width = EXPR_SGT(MModel).GetTreeWidth(); width == 4 || width == 8)
+  {
+    this->mWideMeshTree = std::make_unique<DWideTree<DObjectNode>>();
+    this->mWideMeshTree->BuildFrom(root, width, EXPR_SGT(MModel).GetTreeQuantizeBits());
+  }
 }
 
 PModelCtor FModel::GetPCtor() const noexcept
@@ -80,23 +97,47 @@ const DQuat& FModel::GetQuaternion() const noexcept
 
 std::optional<IHitable::TValueResults> FModel::GetRayIntersectedTValues(const DRay& ray) const
 {
-  // Check Overall AABB of Model.
-  if (IsRayIntersected(ray, *this->GetAABB()) == false) { return std::nullopt; }
+  if (this->mMeshTree.HasRoot() == false) { return std::nullopt; }
 
-  // Call `GetRayIntersectedTValues` with mesh instances.
-  IHitable::TValueResults results;
-  for (const auto& smtMesh : this->mpMeshes)
+  // If wide tree is created, traverse it in near-to-far order and get only the closest mesh hit.
+  if (this->mWideMeshTree != nullptr)
   {
-    const auto optResult = smtMesh->GetRayIntersectedTValues(ray);
-    if (optResult.has_value() == true)
-    {
-      results.insert(results.end(), (*optResult).begin(), (*optResult).end());
-    }
+    auto closestT = std::numeric_limits<float>::max();
+    std::optional<PTValueResult> result = std::nullopt;
+    this->mWideMeshTree->Traverse(ray, closestT,
+      [&ray, &result](const DObjectNode& leaf, float& ioTMax)
+      {
+        for (const auto* pMesh : leaf.GetItems())
+        {
+          const auto optTValues = pMesh->GetRayIntersectedTValues(ray);
+          if (optTValues.has_value() == false) { continue; }
+
+          for (const auto& item : *optTValues)
+          {
+            if (item.mT <= 0.0f || item.mT >= ioTMax) { continue; }
+            ioTMax = item.mT;
+            result = item;
+          }
+        }
+      });
+    if (result.has_value() == false) { return std::nullopt; }
+    return IHitable::TValueResults{*result};
   }
 
+  // Call `GetRayIntersectedTValues` with mesh instances that are hit by ray in mesh tree.
+  auto results = this->mMeshTree.GetRoot().GetIntersectedTriangleTValue(ray);
+  if (results.empty() == true) { return std::nullopt; }
   return results;
 }
 
+void FModel::GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const
+{
+  if (this->mMeshTree.HasRoot() == false) { return; }
+
+  // Forward packet into mesh instances through mesh tree.
+  this->mMeshTree.GetRoot().GetPacketIntersections(packet, activeMask, ioHits);
+}
+
 std::optional<PScatterResult> FModel::TryScatter(const DRay&, TReal, const DVec3&) const
 {
   // This must not be called. Need to be refactored.
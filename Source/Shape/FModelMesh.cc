@@ -17,128 +17,9 @@
 #include <Shape/FPlane.hpp>
 #include <Math/Utility/XShapeMath.h>
 #include <Object/XFunctionResults.hpp>
-
-namespace 
-{
-
-#if 0
-std::optional<std::pair<ray::TReal, const ray::DModelFace*>> RayIntersectTriangle(
-  const ray::DRay& localRay,
-  const ray::DModelFace& face) 
-{
-  using dy::math::Cross;
-  using dy::math::Dot;
-  using dy::math::IsNearlyZero;
-  using ray::TReal;
-  using ray::DVec3;
-  constexpr ray::TReal e = ray::TReal(1e-5);
-
-  const DVec3 edge1 = *face.mVertex[1] - *face.mVertex[0];
-  const DVec3 edge2 = *face.mVertex[2] - *face.mVertex[0];
-
-  const DVec3 h = Cross(localRay.GetDirection(), edge2);
-  const auto a = Dot(edge1, h);
-
-  // If ray is parallel, just do next triangle.
-  if (IsNearlyZero(a) == true) { return std::nullopt; }
-
-  const TReal f = 1 / a;
-  const DVec3 s = localRay.GetOrigin() - *face.mVertex[0];
-  const TReal u = f * Dot(s, h);
-  if (u < 0 || u > 1) { return std::nullopt; }
-
-  const DVec3 q = Cross(s, edge1);
-  const TReal v = f * Dot(localRay.GetDirection(), q);
-  if (v < 0 || u + v > 1) { return std::nullopt; }
-
-  // We can find `t` to find out where the intersection point is on the line.
-  const TReal t = f * Dot(edge2, q);
-  if (t < 0) { return std::nullopt; }
-
-  return std::pair{t, &face};
-}
-
-std::vector<PTriangleResult> RayIntersectTriangle(
-  const ray::DRay& localRay,
-  const std::vector<ray::DModelFace>& faces)
-{
-  using dy::math::Cross;
-  using dy::math::Dot;
-  using dy::math::IsNearlyZero;
-  using ray::TReal;
-  using ray::DVec3;
-  constexpr ray::TReal e = ray::TReal(1e-5);
-
-  std::vector<PTriangleResult> result;
-  for (const auto& face : faces)
-  {
-    //if (::dy::math::IsRayIntersected(localRay, face.mTriangleAABB) == false) { continue; }
-
-    const auto optResult = RayIntersectTriangle(localRay, face);
-    if (optResult.has_value() == false) { continue; }
-
-    const auto& [t, pFace] = *optResult;
-    PTriangleResult item;
-    item.mT = t;
-    item.mIndex = {pFace->mIndex[0], pFace->mIndex[1], pFace->mIndex[2]};
-    result.emplace_back(std::move(item));
-  }
-
-  return result;
-}
-
-std::vector<PTriangleResult> RayIntersectTriangle(
-  const ray::DRay& localRay, 
-  const std::vector<ray::DModelIndex>& indices,
-  const ray::DModelBuffer::TPointVertices& vertices)
-{
-  using dy::math::Cross;
-  using dy::math::Dot;
-  using dy::math::IsNearlyZero;
-  using ray::TReal;
-  using ray::DVec3;
-  constexpr ray::TReal e = ray::TReal(1e-5);
-
-  std::vector<PTriangleResult> result;
-  for (ray::TIndex i = 0, size = indices.size(); i < size; i += 3)
-  {
-    const DVec3& p0 = vertices[ indices[i+0].mVertexIndex ];
-    const DVec3& p1 = vertices[ indices[i+1].mVertexIndex ];
-    const DVec3& p2 = vertices[ indices[i+2].mVertexIndex ];
-
-    const DVec3 edge1 = p1 - p0;
-    const DVec3 edge2 = p2 - p0;
-
-    const DVec3 h = Cross(localRay.GetDirection(), edge2);
-    const auto a = Dot(edge1, h);
-
-    // If ray is parallel, just do next triangle.
-    if (IsNearlyZero(a) == true) { continue; }
-
-    const TReal f = 1 / a;
-    const DVec3 s = localRay.GetOrigin() - p0;
-    const TReal u = f * Dot(s, h);
-    if (u < 0 || u > 1) { continue; }
-
-    const DVec3 q = Cross(s, edge1);
-    const TReal v = f * Dot(localRay.GetDirection(), q);
-    if (v < 0 || u + v > 1) { continue; }
-
-    // We can find `t` to find out where the intersection point is on the line.
-    const TReal t = f * Dot(edge2, q);
-    if (t < 0) { continue; }
-
-    PTriangleResult item;
-    item.mT = t;
-    item.mIndex = {i, i+1, i+2};
-    result.emplace_back(item);
-  }
-
-  return result;
-}
-#endif
-
-} /// ::unnamed namespace
+#include <Simd/DRayPacket.hpp>
+#include <Simd/XPacketKernel.hpp>
+#include <limits>
 
 namespace ray
 {
@@ -198,11 +79,25 @@ std::optional<IHitable::TValueResults> FModelMesh::GetRayIntersectedTValues(cons
     matWorldToLocal * ray.GetDirection()
   };
 
+  // If wide tree is created, traverse it in near-to-far order and get only the closest triangle.
+  if (const auto* pWideTree = this->mpMesh->GetWideTree(); pWideTree != nullptr)
+  {
+    auto closestT = std::numeric_limits<float>::max();
+    std::optional<TU32> closest = std::nullopt;
+    pWideTree->Traverse(offsetedRay, closestT, 
+      [&offsetedRay, &closest](const DTreeNode& leaf, float& ioTMax)
+      {
+        const auto triangle = leaf.GetClosestLeafTriangle(offsetedRay, ioTMax);
+        if (triangle.has_value() == true) { closest = triangle; }
+      });
+    if (closest.has_value() == false) { return std::nullopt; }
+
+    const auto normal = matLocalToWorld * this->GetLocalNormalOf(*closest);
+    return IHitable::TValueResults{PTValueResult{closestT * this->mScale, EShapeType::ModelMesh, this, normal}};
+  }
+
   // Get T value (temporary) [#6? Need to be refactored more clean way.]
   const auto& header = this->mpMesh->GetTreeHeader();
-  const auto& indices   = this->mpMesh->GetIndices();
-  const auto& normals   = this->mpModelBuffer->GetNormals();
-
   const auto tResults = header.GetIntersectedTriangleTValue(offsetedRay);
   if (tResults.empty() == true)
   {
@@ -211,18 +106,66 @@ std::optional<IHitable::TValueResults> FModelMesh::GetRayIntersectedTValues(cons
 
   IHitable::TValueResults results;
   results.reserve(tResults.size());
-  for (const auto& [t, nIds] : tResults) 
+  for (const auto& [t, triangle] : tResults) 
   { 
     // Get surface's normal vector in world-space.
-    const DVec3& n0 = normals[ indices[nIds[0]].mNormalIndex ];
-    const DVec3& n1 = normals[ indices[nIds[1]].mNormalIndex ];
-    const DVec3& n2 = normals[ indices[nIds[2]].mNormalIndex ];
-    const auto normal = matLocalToWorld * ((n0 + n1 + n2) / 3);
+    const auto normal = matLocalToWorld * this->GetLocalNormalOf(triangle);
     results.emplace_back(t * this->mScale, EShapeType::ModelMesh, this, normal); 
   }
   return results;
 }
 
+void FModelMesh::GetPacketIntersections(const DRayPacket& packet, TU32 activeMask, DPacketHits& ioHits) const
+{
+  // Check AABB.
+  activeMask = simd::IntersectPacketAABB(packet, *this->GetAABB(), activeMask, ioHits.mT.data());
+  if (activeMask == 0) { return; }
+
+  // Convert world-space packet into local space.
+  // Local T is world T divided by scale, because direction is not scaled.
+  const auto matLocalToWorld = this->mRotQuat.ToMatrix3();
+  const auto matWorldToLocal = matLocalToWorld.Transpose();
+  const auto localPacket = packet.GetTransformedOf(matWorldToLocal, this->mOrigin, this->mScale);
+
+  DTrianglePacketHits localHits;
+  for (TIndex lane = 0; lane < DRayPacket::kMaxWidth; ++lane) { localHits.mT[lane] = ioHits.mT[lane] / this->mScale; }
+
+  const auto& header = this->mpMesh->GetTreeHeader();
+  header.GetPacketClosestTriangles(localPacket, activeMask, localHits);
+
+  for (TIndex lane = 0, width = packet.GetWidth(); lane < width; ++lane)
+  {
+    if ((localHits.mHitMask & (1u << lane)) == 0) { continue; }
+
+    const auto normal = matLocalToWorld * this->GetLocalNormalOf(localHits.mTriangle[lane]);
+    ioHits.TryUpdate(lane, PTValueResult{localHits.mT[lane] * this->mScale, EShapeType::ModelMesh, this, normal});
+  }
+}
+
+DVec3 FModelMesh::GetLocalNormalOf(TU32 triangle) const noexcept
+{
+  const auto& indices = this->mpMesh->GetIndices();
+  const auto& normals = this->mpModelBuffer->GetNormals();
+
+  const TIndex i = TIndex(triangle) * 3;
+
+  // If buffer does not store normals (or corner does not have normal), derive geometric normal from vertices.
+  if (normals.empty() == true
+  ||  indices[i+0].mNormalIndex < 0 || indices[i+1].mNormalIndex < 0 || indices[i+2].mNormalIndex < 0)
+  {
+    const auto& vertices = this->mpModelBuffer->GetVertices();
+    const DVec3& p0 = vertices[ indices[i+0].mVertexIndex ];
+    const DVec3& p1 = vertices[ indices[i+1].mVertexIndex ];
+    const DVec3& p2 = vertices[ indices[i+2].mVertexIndex ];
+    return ::dy::math::Cross(p1 - p0, p2 - p0).Normalize();
+  }
+
+  const DVec3& n0 = normals[ indices[i+0].mNormalIndex ];
+  const DVec3& n1 = normals[ indices[i+1].mNormalIndex ];
+  const DVec3& n2 = normals[ indices[i+2].mNormalIndex ];
+  return (n0 + n1 + n2) / 3;
+}
+
 std::optional<PScatterResult> FModelMesh::TryScatter(const DRay& ray, TReal t, const DVec3& normal) const
 {
   if (this->GetMaterial() == nullptr) { return std::nullopt; }
@@ -0,0 +1,65 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Simd/DRayPacket.hpp>
+#include <limits>
+
+namespace ray
+{
+
+DRayPacket::DRayPacket(TIndex width)
+  : mWidth { width }
+{
+  assert(width == 4 || width == 8);
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    this->mOrigin[axis].fill(0);
+    this->mDirection[axis].fill(0);
+    this->mInvDirection[axis].fill(0);
+  }
+}
+
+void DRayPacket::SetRay(TIndex lane, const DRay& ray)
+{
+  assert(lane < this->mWidth);
+  const auto& origin    = ray.GetOrigin();
+  const auto& direction = ray.GetDirection();
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    this->mOrigin[axis][lane]       = origin[axis];
+    this->mDirection[axis][lane]    = direction[axis];
+    this->mInvDirection[axis][lane] = 1.0f / direction[axis];
+  }
+  this->mRays[lane] = ray;
+}
+
+TU32 DRayPacket::GetFullMask() const noexcept
+{
+  return (1u << this->mWidth) - 1;
+}
+
+DPacketHits::DPacketHits()
+{
+  this->mT.fill(std::numeric_limits<float>::max());
+}
+
+bool DPacketHits::TryUpdate(TIndex lane, const PTValueResult& result)
+{
+  if (result.mT <= 0.0f || result.mT >= this->mT[lane]) { return false; }
+
+  this->mT[lane] = result.mT;
+  this->mResults[lane] = result;
+  return true;
+}
+
+} /// ::ray namespace
\ No newline at end of file
@@ -0,0 +1,118 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Simd/XCpuFeature.hpp>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+  #define SH_RAY_CPUID_X86
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #include <cpuid.h>
+  #define SH_RAY_CPUID_X86
+#endif
+
+namespace
+{
+
+using namespace ray;
+using ray::simd::PCpuFeatures;
+
+#if defined(SH_RAY_CPUID_X86)
+/// @brief Call CPUID with given leaf and subleaf. If not supported leaf, all registers are 0.
+void GetCpuId(TU32 leaf, TU32 subleaf, TU32 (&oRegisters)[4])
+{
+#if defined(_MSC_VER)
+  int registers[4] = {};
+  __cpuidex(registers, int(leaf), int(subleaf));
+  for (TIndex i = 0; i < 4; ++i) { oRegisters[i] = TU32(registers[i]); }
+#else
+  if (__get_cpuid_count(leaf, subleaf, &oRegisters[0], &oRegisters[1], &oRegisters[2], &oRegisters[3]) == 0)
+  {
+    oRegisters[0] = oRegisters[1] = oRegisters[2] = oRegisters[3] = 0;
+  }
+#endif
+}
+
+/// @brief Get XCR0 register, which has register states that OS saves on context switch.
+std::uint64_t GetXcr0()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  TU32 eax = 0, edx = 0;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (std::uint64_t(edx) << 32) | eax;
+#endif
+}
+#endif /// #if defined(SH_RAY_CPUID_X86)
+
+PCpuFeatures DetectCpuFeatures()
+{
+  PCpuFeatures features;
+#if defined(SH_RAY_CPUID_X86)
+  TU32 leaf1[4] = {};
+  GetCpuId(1, 0, leaf1);
+  features.mSSE41 = (leaf1[2] & (1u << 19)) != 0;
+
+  // AVX registers can be used only when OS saves them. (OSXSAVE, and XMM / YMM state of XCR0)
+  const bool isOsXSave = (leaf1[2] & (1u << 27)) != 0;
+  const auto xcr0 = isOsXSave == true ? GetXcr0() : 0;
+  const bool isYmmSaved = (xcr0 & 0x6) == 0x6;
+  const bool isZmmSaved = (xcr0 & 0xE6) == 0xE6;
+  features.mAVX = isYmmSaved && (leaf1[2] & (1u << 28)) != 0;
+  features.mFMA = features.mAVX && (leaf1[2] & (1u << 12)) != 0;
+
+  TU32 leaf7[4] = {};
+  GetCpuId(7, 0, leaf7);
+  features.mAVX2      = features.mAVX && (leaf7[1] & (1u << 5)) != 0;
+  features.mAVX512F   = isZmmSaved && (leaf7[1] & (1u << 16)) != 0;
+  features.mAVX512VL  = features.mAVX512F && (leaf7[1] & (1u << 31)) != 0;
+#endif
+  return features;
+}
+
+} /// anonymous namespace
+
+namespace ray::simd
+{
+
+const PCpuFeatures& GetCpuFeatures() noexcept
+{
+  static const PCpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+
+ESimdLevel GetSupportedSimdLevel() noexcept
+{
+  // AVX2 and AVX-512 kernels are compiled with FMA, so FMA is also required.
+  const auto& features = GetCpuFeatures();
+  if (features.mAVX512F && features.mAVX512VL && features.mAVX2 && features.mFMA) { return ESimdLevel::AVX512; }
+  if (features.mAVX2 && features.mFMA) { return ESimdLevel::AVX2; }
+  if (features.mSSE41) { return ESimdLevel::SSE41; }
+  return ESimdLevel::Scalar;
+}
+
+const char* GetSimdLevelName(ESimdLevel level) noexcept
+{
+  switch (level)
+  {
+  case ESimdLevel::Scalar:  return "Scalar";
+  case ESimdLevel::SSE41:   return "SSE4.1";
+  case ESimdLevel::AVX2:    return "AVX2";
+  case ESimdLevel::AVX512:  return "AVX-512";
+  default: return "Unknown";
+  }
+}
+
+} /// ::ray::simd namespace
@@ -0,0 +1,26 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+/// Kernels of this file are compiled with AVX2 instructions. (See CMakeLists.txt)
+#include <Inline/XKernelTable.inl>
+
+namespace ray::simd
+{
+
+const PKernelTable& GetAvx2KernelTable() noexcept
+{
+  static const PKernelTable table = CreateKernelTable(ESimdLevel::AVX2);
+  return table;
+}
+
+} /// ::ray::simd namespace
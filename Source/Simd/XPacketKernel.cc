@@ -0,0 +1,137 @@
+///
+/// MIT License
+/// Copyright (c) 2019 Jongmin Yun
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include <Simd/XPacketKernel.hpp>
+#include <Simd/XKernelTable.hpp>
+
+namespace
+{
+
+using namespace ray;
+using ray::simd::PPacketLanes;
+using ray::simd::PTriangleLanes;
+
+/// @brief Get raw SoA view of given packet.
+PPacketLanes GetLanesOf(const DRayPacket& packet) noexcept
+{
+  PPacketLanes lanes;
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    lanes.mOrigin[axis]       = packet.mOrigin[axis].data();
+    lanes.mDirection[axis]    = packet.mDirection[axis].data();
+    lanes.mInvDirection[axis] = packet.mInvDirection[axis].data();
+  }
+  lanes.mWidth = packet.GetWidth();
+  return lanes;
+}
+
+} /// anonymous namespace
+
+namespace ray::simd
+{
+
+TU32 IntersectPacketAABB(const DRayPacket& packet, const DAABB& aabb, TU32 activeMask, const float* tMax)
+{
+  const auto& min = aabb.GetMin();
+  const auto& max = aabb.GetMax();
+  const float minValue[3] = { min.X, min.Y, min.Z };
+  const float maxValue[3] = { max.X, max.Y, max.Z };
+  return GetKernelTable().mIntersectPacketAABB(GetLanesOf(packet), minValue, maxValue, activeMask, tMax);
+}
+
+TU32 IntersectPacketTriangle(
+  const DRayPacket& packet,
+  const DVec3& v0, const DVec3& v1, const DVec3& v2,
+  TU32 activeMask, float* ioT)
+{
+  const DVec3 edge1 = v1 - v0;
+  const DVec3 edge2 = v2 - v0;
+  const float v0Value[3]    = { v0.X, v0.Y, v0.Z };
+  const float edge1Value[3] = { edge1.X, edge1.Y, edge1.Z };
+  const float edge2Value[3] = { edge2.X, edge2.Y, edge2.Z };
+  return GetKernelTable().mIntersectPacketTriangle(
+    GetLanesOf(packet), v0Value, edge1Value, edge2Value, activeMask, ioT);
+}
+
+TU32 IntersectPacketTriangle(
+  const DRayPacket& packet,
+  const DTriangleBlock& block, TIndex triangleLane,
+  TU32 activeMask, float* ioT)
+{
+  assert(triangleLane < block.mCount);
+  float v0Value[3], edge1Value[3], edge2Value[3];
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    v0Value[axis]     = block.mV0[axis][triangleLane];
+    edge1Value[axis]  = block.mEdge1[axis][triangleLane];
+    edge2Value[axis]  = block.mEdge2[axis][triangleLane];
+  }
+  return GetKernelTable().mIntersectPacketTriangle(
+    GetLanesOf(packet), v0Value, edge1Value, edge2Value, activeMask, ioT);
+}
+
+TU32 IntersectRayBoxes(
+  const float* origin, const float* invDirection,
+  const std::array<float, DRayPacket::kMaxWidth>* min, const std::array<float, DRayPacket::kMaxWidth>* max,
+  TIndex width, float tMax, float* oTNear)
+{
+  const float* const minLanes[3] = { min[0].data(), min[1].data(), min[2].data() };
+  const float* const maxLanes[3] = { max[0].data(), max[1].data(), max[2].data() };
+  return GetKernelTable().mIntersectRayBoxes(origin, invDirection, minLanes, maxLanes, width, tMax, oTNear);
+}
+
+TU32 IntersectRayTriangles(
+  const float* origin, const float* direction,
+  const DTriangleBlock& block, float tMax, float* oT)
+{
+  static_assert(DTriangleBlock::kWidth == 8, "Triangle block kernel assumes 8 lanes.");
+  PTriangleLanes lanes;
+  for (TIndex axis = 0; axis < 3; ++axis)
+  {
+    lanes.mV0[axis]     = block.mV0[axis].data();
+    lanes.mEdge1[axis]  = block.mEdge1[axis].data();
+    lanes.mEdge2[axis]  = block.mEdge2[axis].data();
+  }
+  lanes.mCount = block.mCount;
+  return GetKernelTable().mIntersectRayTriangles(origin, direction, lanes, tMax, oT);
+}
+
+const PKernelTable& GetKernelTable() noexcept
+{
+  static const PKernelTable& table = []() -> const PKernelTable&
+  {
+    switch (GetSupportedSimdLevel())
+    {
+    case ESimdLevel::AVX512:  return GetAvx512KernelTable();
+    case ESimdLevel::AVX2:    return GetAvx2KernelTable();
+    case ESimdLevel::SSE41:   return GetSse41KernelTable();
+    default:                  return GetScalarKernelTable();
+    }
+  }();
+  return table;
+}
+
+bool IsPacketDiverged(const DRayPacket& packet, TU32 activeMask) noexcept
+{
+  // When only quarter of lanes or less are alive, SIMD test wastes most of lanes.
+  return GetLaneCount(activeMask) * 4 <= packet.GetWidth();
+}
+
+TU32 GetLaneCount(TU32 mask) noexcept
+{
+  TU32 count = 0;
+  for (; mask != 0; mask &= mask - 1) { ++count; }
+  return count;
+}
+
+} /// ::ray::simd namespace
\ No newline at end of file
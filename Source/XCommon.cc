@@ -19,20 +19,13 @@
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <sstream>
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#if defined(_MSVC_LANG)
-	#define STBIW_WINDOWS_UTF8
-	#define STBI_MSC_SECURE_CRT
-#endif
-#include <stb/stb_image_write.h>
-#if defined(_MSVC_LANG)
-	#undef STBIW_WINDOWS_UTF8
-	#undef STBI_MSC_SECURE_CRT
-#endif
 #include <nlohmann/json.hpp>
+#include <Simd/XCpuFeature.hpp>
+#include <Simd/XKernelTable.hpp>
 
 namespace
 {
@@ -96,7 +89,126 @@ void AddDefaultCommandArguments(::dy::expr::FCmdArguments& manager)
     "so if empty load sample scene file. (example -f scene1.json)"};
   const PCmdArgument outputFile = PCmdArgument{
     'o', "output", &InitFunctionOutput,
-    R"(Set up output path. Default output file path is directory of executable. (example -f "./../result.ppm")"};
+    R"(Set up output path. Supported extensions are .ppm, .png, .pfm (float radiance) )"
+    R"(and .acc (radiance sums and sample counts for --merge). )"
+    R"(Default output file path is directory of executable. (example -f "./../result.ppm")"};
+  const PCmdArgument binRays = PCmdArgument{
+    'b', "bin-rays", false,
+    "Bin secondary rays of each tile by direction octant and origin cell, "
+    "and trace each bin coherently. (-b, --bin-rays)"};
+  const PCmdArgument packet = PCmdArgument{
+    'k', "packet", (TU32)0,
+    "Trace primary rays with SIMD ray packet of given width. "
+    "supported value is 0 (disabled), 4 and 8. (example : -k 4, --packet 8)"};
+  const PCmdArgument bvhWidth = PCmdArgument{
+    'n', "bvh-width", (TU32)2,
+    "Branch width of object and mesh trees. 4 and 8 collapse binary trees into wide trees "
+    "that test child bounds with SIMD. supported value is 2, 4 and 8. (example : -n 4, --bvh-width 8)"};
+  const PCmdArgument cpuReport = PCmdArgument{
+    'c', "cpu-report", false,
+    "Print detected CPU features and SIMD kernel level that is selected on startup. (-c, --cpu-report)"};
+  const PCmdArgument asciiPpm = PCmdArgument{
+    'a', "ascii-ppm", false,
+    "Export .ppm result as ascii (P3) raster instead of binary (P6) raster. (-a, --ascii-ppm)"};
+  const PCmdArgument pngLevel = PCmdArgument{
+    'l', "png-level", (TU32)6,
+    "Deflate compression level of .png result, from 0 (stored) to 9 (smallest). (example : -l 1, --png-level 9)"};
+  const PCmdArgument pngBitDepth = PCmdArgument{
+    'd', "bit-depth", (TU32)8,
+    "Bit depth of each channel of .png result. supported value is 8 and 16. (example : -d 16, --bit-depth 16)"};
+  const PCmdArgument exposure = PCmdArgument{
+    'e', "exposure", (float)0.0f,
+    "Exposure in stops. Radiance is scaled by 2^exposure before tone mapping. (example : -e 1.5, --exposure -1)"};
+  const PCmdArgument toneMap = PCmdArgument{
+    'm', "tone-map", std::string{"clamp"},
+    "Tone map operator of .ppm and .png result. "
+    "supported value is clamp, reinhard, filmic and aces. (example : -m aces, --tone-map filmic)"};
+  const PCmdArgument srgb = PCmdArgument{
+    'u', "srgb", false,
+    "Encode .ppm and .png result with sRGB curve instead of gamma correction. (-u, --srgb)"};
+  const PCmdArgument dither = PCmdArgument{
+    'i', "dither", false,
+    "Dither quantization of .ppm and .png result, so gradients do not band. (-i, --dither)"};
+  const PCmdArgument streamTiles = PCmdArgument{
+    'z', "stream-tiles", (TU32)0,
+    "Render square tiles of given size, and write each completed tile into memory-mapped .ppm or .pfm output. "
+    "Memory is bounded by tiles in flight, not by image size. 0 is disabled. (example : -z 256, --stream-tiles 512)"};
+  const PCmdArgument crop = PCmdArgument{
+    'j', "crop", std::string{},
+    "Render only region x0,y0,x1,y1 of output image (x1, y1 are exclusive), and export it as partial image. "
+    "Export as .acc to record offset of region for --merge. (example : -j 0,0,400,240, --crop 100,50,200,150)"};
+  const PCmdArgument merge = PCmdArgument{
+    'q', "merge", std::string{},
+    "Merge comma-separated .acc files into output image without rendering. "
+    "Cropped regions are stitched, and overlapped regions of disjoint sample ranges (such as other passes) are summed. "
+    "Files of overlapped regions with overlapped sample ranges are rejected. "
+    "(example : -q a.acc,b.acc -o result.png)"};
+  const PCmdArgument samplePartition = PCmdArgument{
+    'y', "sample-partition", false,
+    "Partition samples of each pixel to threads instead of pixels. Each thread renders whole image "
+    "with its own slice of samples, and results are summed. Useful for small image with many samples. "
+    "(-y, --sample-partition)"};
+  const PCmdArgument timeBudget = PCmdArgument{
+    'B', "time-budget", (float)0.0f,
+    "Render passes progressively until given wall-clock seconds of each camera are spent. "
+    "0 is disabled. (example : -B 600, --time-budget 3600)"};
+  const PCmdArgument targetSpp = PCmdArgument{
+    'N', "target-spp", (TU32)0,
+    "Render passes progressively until each pixel has given samples. "
+    "0 is samples * repeat of camera, or unlimited with --time-budget. (example : -N 1024, --target-spp 256)"};
+  const PCmdArgument sampleRange = PCmdArgument{
+    'S', "sample-range", std::string{},
+    "Render only samples start,count of each pixel, instead of samples from 0. "
+    "Passes of disjoint ranges (such as from other machines) can be exported as .acc and summed by --merge. "
+    "With progressive rendering, count overrides --target-spp. (example : -S 0,256, --sample-range 256,256)"};
+  const PCmdArgument checkpointInterval = PCmdArgument{
+    'C', "checkpoint-interval", (float)0.0f,
+    "Write checkpoint (.ckpt beside output) of progressive rendering every given seconds. "
+    "Checkpoint is always written at the end. (example : -C 60, --checkpoint-interval 300)"};
+  const PCmdArgument resume = PCmdArgument{
+    'R', "resume", false,
+    "Resume progressive rendering from checkpoint of previous run, if exists. (-R, --resume)"};
+  const PCmdArgument denoise = PCmdArgument{
+    'D', "denoise", false,
+    "Denoise result with edge-avoiding a-trous filter that is guided by first-hit albedo, normal and depth. "
+    "(-D, --denoise)"};
+  const PCmdArgument auxOutput = PCmdArgument{
+    'A', "aux-output", false,
+    "Export first-hit albedo, normal and depth as _albedo.pfm, _normal.pfm and _depth.pfm beside output. "
+    "(-A, --aux-output)"};
+  const PCmdArgument noHitCache = PCmdArgument{
+    'H', "no-hit-cache", false,
+    "Trace primary ray of every repeat, instead of reusing cached first hit of each sub-pixel offset "
+    "when depth of field is off. For comparing render time. (-H, --no-hit-cache)"};
+  const PCmdArgument bvhQuantize = PCmdArgument{
+    'Q', "bvh-quantize", (TU32)0,
+    "Quantize child bounds of wide trees (bvh-width 4 or 8) into given bits relative to parent bounds, "
+    "to cut tree memory. supported value is 0 (disabled), 8 and 16. (example : -Q 8, --bvh-quantize 16)"};
+  const PCmdArgument creaseAngle = PCmdArgument{
+    'K', "crease-angle", (float)60.0f,
+    "Crease angle as degree of smooth normals that are created for models without normals. "
+    "Faces around vertex are averaged only within this angle. 180 makes fully smooth normals. "
+    "(example : -K 30, --crease-angle 180)"};
+  const PCmdArgument geometricNormals = PCmdArgument{
+    'G', "geometric-normals", false,
+    "Do not store normals of models, but derive geometric normal of triangle on hit. "
+    "Normals of model files are also discarded. (-G, --geometric-normals)"};
+  const PCmdArgument noMeshOptimize = PCmdArgument{
+    'O', "no-mesh-optimize", false,
+    "Do not weld vertices, drop unused attributes and reorder vertices and triangles of loaded models. "
+    "For comparing load and render time. (-O, --no-mesh-optimize)"};
+  const PCmdArgument weldTolerance = PCmdArgument{
+    'W', "weld-tolerance", (float)0.0f,
+    "Distance to weld near vertices of loaded models. 0 welds only vertices of exactly the same position. "
+    "(example : -W 0.0001, --weld-tolerance 0.001)"};
+  const PCmdArgument meshCacheDir = PCmdArgument{
+    'M', "mesh-cache-dir", std::string{},
+    "Directory to write and read binary mesh caches of loaded models. "
+    "If empty, cache is placed beside model file as .shmesh. (example : -M cache, --mesh-cache-dir /tmp/mesh)"};
+  const PCmdArgument noMeshCache = PCmdArgument{
+    'U', "no-mesh-cache", false,
+    "Do not read and write binary mesh caches, but always parse model files and build trees. "
+    "(-U, --no-mesh-cache)"};
   const PCmdArgument help = PCmdArgument{'x', "help", false, "Display help instruction."};
 
 #if defined(EXPR_ENABLE_BOOST) == true
@@ -110,6 +222,36 @@ void AddDefaultCommandArguments(::dy::expr::FCmdArguments& manager)
   EXPR_OUTCOME_ASSERT(manager.Add(thread));     // Thread count to process.
 	EXPR_OUTCOME_ASSERT(manager.Add(inputFile));  // Load scene file. (json)
   EXPR_OUTCOME_ASSERT(manager.Add(outputFile)); // Customizable output path.
+  EXPR_OUTCOME_ASSERT(manager.Add(binRays));    // Secondary ray binning.
+  EXPR_OUTCOME_ASSERT(manager.Add(packet));     // Primary ray packet width.
+  EXPR_OUTCOME_ASSERT(manager.Add(bvhWidth));   // Branch width of trees.
+  EXPR_OUTCOME_ASSERT(manager.Add(cpuReport));  // Print selected SIMD kernel level.
+  EXPR_OUTCOME_ASSERT(manager.Add(asciiPpm));   // Export ascii ppm.
+  EXPR_OUTCOME_ASSERT(manager.Add(pngLevel));   // Png compression level.
+  EXPR_OUTCOME_ASSERT(manager.Add(pngBitDepth));// Png bit depth.
+  EXPR_OUTCOME_ASSERT(manager.Add(exposure));   // Tone map exposure.
+  EXPR_OUTCOME_ASSERT(manager.Add(toneMap));    // Tone map operator.
+  EXPR_OUTCOME_ASSERT(manager.Add(srgb));       // sRGB transfer function.
+  EXPR_OUTCOME_ASSERT(manager.Add(dither));     // Dithered quantization.
+  EXPR_OUTCOME_ASSERT(manager.Add(streamTiles));// Tile streaming into mapped output.
+  EXPR_OUTCOME_ASSERT(manager.Add(crop));       // Region of interest.
+  EXPR_OUTCOME_ASSERT(manager.Add(merge));      // Merge accumulation files.
+  EXPR_OUTCOME_ASSERT(manager.Add(samplePartition)); // Sample-partitioned threads.
+  EXPR_OUTCOME_ASSERT(manager.Add(timeBudget)); // Progressive time budget.
+  EXPR_OUTCOME_ASSERT(manager.Add(targetSpp));  // Progressive target samples.
+  EXPR_OUTCOME_ASSERT(manager.Add(sampleRange));// Sample index range of each pixel.
+  EXPR_OUTCOME_ASSERT(manager.Add(checkpointInterval)); // Progressive checkpoint interval.
+  EXPR_OUTCOME_ASSERT(manager.Add(resume));     // Resume from checkpoint.
+  EXPR_OUTCOME_ASSERT(manager.Add(denoise));    // Guided denoiser.
+  EXPR_OUTCOME_ASSERT(manager.Add(auxOutput));  // Export auxiliary buffers.
+  EXPR_OUTCOME_ASSERT(manager.Add(noHitCache)); // Disable first-hit cache.
+  EXPR_OUTCOME_ASSERT(manager.Add(bvhQuantize));// Quantized wide tree nodes.
+  EXPR_OUTCOME_ASSERT(manager.Add(creaseAngle));// Crease angle of created normals.
+  EXPR_OUTCOME_ASSERT(manager.Add(geometricNormals)); // Geometric normals on hit.
+  EXPR_OUTCOME_ASSERT(manager.Add(noMeshOptimize)); // Disable mesh optimization on load.
+  EXPR_OUTCOME_ASSERT(manager.Add(weldTolerance)); // Weld tolerance of mesh optimization.
+  EXPR_OUTCOME_ASSERT(manager.Add(meshCacheDir)); // Directory of mesh caches.
+  EXPR_OUTCOME_ASSERT(manager.Add(noMeshCache)); // Disable mesh caches.
   EXPR_OUTCOME_ASSERT(manager.Add(help));       // Help command
 #else /// If not defined `EXPR_ENABLE_BOOST`
   EXPR_SUCCESS_ASSERT(manager.Add(sampler));    // Sampling count of each pixel. (Antialiasing)
@@ -122,6 +264,36 @@ void AddDefaultCommandArguments(::dy::expr::FCmdArguments& manager)
   EXPR_SUCCESS_ASSERT(manager.Add(thread));     // Thread count to process.
 	EXPR_SUCCESS_ASSERT(manager.Add(inputFile));	// Load scene file. (json)
   EXPR_SUCCESS_ASSERT(manager.Add(outputFile)); // Customizable output path.
+  EXPR_SUCCESS_ASSERT(manager.Add(binRays));    // Secondary ray binning.
+  EXPR_SUCCESS_ASSERT(manager.Add(packet));     // Primary ray packet width.
+  EXPR_SUCCESS_ASSERT(manager.Add(bvhWidth));   // Branch width of trees.
+  EXPR_SUCCESS_ASSERT(manager.Add(cpuReport));  // Print selected SIMD kernel level.
+  EXPR_SUCCESS_ASSERT(manager.Add(asciiPpm));   // Export ascii ppm.
+  EXPR_SUCCESS_ASSERT(manager.Add(pngLevel));   // Png compression level.
+  EXPR_SUCCESS_ASSERT(manager.Add(pngBitDepth));// Png bit depth.
+  EXPR_SUCCESS_ASSERT(manager.Add(exposure));   // Tone map exposure.
+  EXPR_SUCCESS_ASSERT(manager.Add(toneMap));    // Tone map operator.
+  EXPR_SUCCESS_ASSERT(manager.Add(srgb));       // sRGB transfer function.
+  EXPR_SUCCESS_ASSERT(manager.Add(dither));     // Dithered quantization.
+  EXPR_SUCCESS_ASSERT(manager.Add(streamTiles));// Tile streaming into mapped output.
+  EXPR_SUCCESS_ASSERT(manager.Add(crop));       // Region of interest.
+  EXPR_SUCCESS_ASSERT(manager.Add(merge));      // Merge accumulation files.
+  EXPR_SUCCESS_ASSERT(manager.Add(samplePartition)); // Sample-partitioned threads.
+  EXPR_SUCCESS_ASSERT(manager.Add(timeBudget)); // Progressive time budget.
+  EXPR_SUCCESS_ASSERT(manager.Add(targetSpp));  // Progressive target samples.
+  EXPR_SUCCESS_ASSERT(manager.Add(sampleRange));// Sample index range of each pixel.
+  EXPR_SUCCESS_ASSERT(manager.Add(checkpointInterval)); // Progressive checkpoint interval.
+  EXPR_SUCCESS_ASSERT(manager.Add(resume));     // Resume from checkpoint.
+  EXPR_SUCCESS_ASSERT(manager.Add(denoise));    // Guided denoiser.
+  EXPR_SUCCESS_ASSERT(manager.Add(auxOutput));  // Export auxiliary buffers.
+  EXPR_SUCCESS_ASSERT(manager.Add(noHitCache)); // Disable first-hit cache.
+  EXPR_SUCCESS_ASSERT(manager.Add(bvhQuantize));// Quantized wide tree nodes.
+  EXPR_SUCCESS_ASSERT(manager.Add(creaseAngle));// Crease angle of created normals.
+  EXPR_SUCCESS_ASSERT(manager.Add(geometricNormals)); // Geometric normals on hit.
+  EXPR_SUCCESS_ASSERT(manager.Add(noMeshOptimize)); // Disable mesh optimization on load.
+  EXPR_SUCCESS_ASSERT(manager.Add(weldTolerance)); // Weld tolerance of mesh optimization.
+  EXPR_SUCCESS_ASSERT(manager.Add(meshCacheDir)); // Directory of mesh caches.
+  EXPR_SUCCESS_ASSERT(manager.Add(noMeshCache)); // Disable mesh caches.
   EXPR_SUCCESS_ASSERT(manager.Add(help));       // Help command
 #endif /// #if defined(EXPR_ENABLE_BOOST)
 }
@@ -180,53 +352,32 @@ void PrintOverallInformation(const ::dy::expr::FCmdArguments& manager)
   std::cout << "  Work Count For Each Thread : " << workCount << '\n'; 
 }
 
-bool CreateImagePpm(const char* const path, DDynamicGrid2D<DIVec3>& container)
+void PrintCpuReport()
 {
-  // Open file
-  FILE* fd = std::fopen(path, "w");
-  if (fd == nullptr)
-  {
-    std::printf("Failed to open / create file, %s.\n", path);
-    return false;
-  }
-
-  // Insert value.
-  // Header 
-  std::fprintf(fd, "P3\n%u %u\n255\n", (TU32)container.GetColumnSize(), (TU32)container.GetRowSize());
-  // Data
-	const auto w = container.GetColumnSize();
-	const auto h = container.GetRowSize();
-	for (auto y = 0u; y < h; ++y)
-	{
-		for (auto x = 0u; x < w; ++x)
-		{
-      const auto& col = container.Get(w - x - 1, h - y - 1);
-      std::fprintf(fd, "%d %d %d\n", col[0], col[1], col[2]);
-		}
-	}
-
-  std::fclose(fd);
-  return true;
+  using namespace ray::simd;
+  const auto& features = GetCpuFeatures();
+  const auto& table = GetKernelTable();
+
+  std::cout << "* CPU Report\n";
+  std::cout << "  Detected Features :"
+    << (features.mSSE41     ? " SSE4.1" : "")
+    << (features.mAVX       ? " AVX" : "")
+    << (features.mAVX2      ? " AVX2" : "")
+    << (features.mFMA       ? " FMA" : "")
+    << (features.mAVX512F   ? " AVX-512F" : "")
+    << (features.mAVX512VL  ? " AVX-512VL" : "") << '\n';
+  std::cout << "  Selected Kernel Level : " << GetSimdLevelName(table.mLevel) << '\n';
+  std::cout << "  4-wide Lanes (packet 4, bvh-width 4, triangle blocks) : " 
+    << (table.mIsAccelerated4 ? "SIMD" : "Scalar loop") << '\n';
+  std::cout << "  8-wide Lanes (packet 8, bvh-width 8, triangle blocks) : " 
+    << (table.mIsAccelerated8 ? "SIMD" : (table.mIsAccelerated4 ? "Scalar loop (triangle blocks use 4-wide)" : "Scalar loop")) << '\n';
 }
 
-bool CreateImagePng(const char* const path, const DDynamicGrid2D<DIVec3>& container)
+::dy::math::DUuid CreateUuid()
 {
-	const auto w = container.GetColumnSize();
-	const auto h = container.GetRowSize();
-
-	using DU8Vec3 = ::dy::math::DVector3<::dy::math::TU8>;
-	DDynamicGrid2D<DU8Vec3> charContainer = {w, h};
-
-	for (auto y = 0u; y < h; ++y)
-	{
-		for (auto x = 0u; x < w; ++x)
-		{
-			charContainer.Set(w - x - 1, h - y - 1, static_cast<DU8Vec3>(container.Get(x, y)));
-		}
-	}
-
-	const auto flag = stbi_write_png(path, int(w), int(h), 3, charContainer.Data(), 0);
-	return flag == 1;
+  static std::mutex sUuidMutex;
+  std::lock_guard lock { sUuidMutex };
+  return ::dy::math::DUuid{true};
 }
 
 } /// ::ray namespace
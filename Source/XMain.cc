@@ -12,22 +12,172 @@
 ///
 
 #include <cstdio>
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <vector>
 #include <thread>
 #include <chrono>
 #include <sstream>
 
 #include <Expr/MTimeChecker.h>
-#include <Math/Type/Micellanous/DDynamicGrid2D.h>
 
 #include <Manager/MScene.hpp>
 #include <Manager/MMaterial.hpp>
 #include <Manager/MModel.hpp>
 #include <XCommon.hpp>
 #include <FRenderWorker.hpp>
+#include <FTileStreamer.hpp>
+#include <KDTree/XTraversalStats.hpp>
 #include <Helper/XHelperRegex.hpp>
+#include <Helper/XHelperImage.hpp>
+#include <Image/DFrameBuffer.hpp>
+#include <Image/DAuxBuffers.hpp>
+#include <Image/FMappedImage.hpp>
+#include <Image/XToneMap.hpp>
+#include <Image/XDenoise.hpp>
+
+namespace
+{
+
+using namespace ray;
+
+/// @struct PExportOptions
+/// @brief Options of result image that are shared by all cameras.
+struct PExportOptions final
+{
+  std::string mExtension;
+  EPpmFormat mPpmFormat = EPpmFormat::Binary;
+  TU32 mPngLevel = 6;
+  TU32 mPngBitDepth = 8;
+  TU32 mThreadCount = 1;
+};
+
+/// @brief Export frame buffer as image file of extension of options.
+/// @param imageSize Size of whole image. If frame buffer is cropped region, it is bigger than frame buffer.
+/// @param sampleRange Sample index range [start, end) of each pixel in frame buffer. Recorded only into `.acc`.
+/// @return If successful, return true.
+bool ExportImage(
+  const std::string& path, 
+  const DFrameBuffer& buffer, const DUVec2& imageSize, const std::pair<TU32, TU32>& sampleRange,
+  const PToneMapParams& toneMapParams, const PExportOptions& options)
+{
+  // `.pfm` keeps averaged radiance, and `.acc` keeps sums and sample counts as they are. 
+  // Otherwise, tone-map radiance as post stage.
+  const auto& extension = options.mExtension;
+  if (extension == "acc") 
+  { 
+    return ray::CreateImageAcc(path.c_str(), buffer, imageSize, sampleRange.first, sampleRange.second); 
+  }
+  if (extension == "pfm") { return ray::CreateImagePfm(path.c_str(), buffer); }
+  if (extension == "png")
+  {
+    // Png strips are tone-mapped and compressed in parallel by encoder.
+    PPngOptions pngOptions;
+    pngOptions.mCompressionLevel = TI32(options.mPngLevel);
+    pngOptions.mThreadCount = options.mThreadCount;
+    pngOptions.mBitDepth = options.mPngBitDepth;
+    return ray::CreateImagePng(path.c_str(), buffer, toneMapParams, pngOptions);
+  }
+
+  const auto rgb = ToneMapToRgb8(buffer, toneMapParams, options.mThreadCount);
+  return ray::CreateImagePpm(path.c_str(), buffer.GetWidth(), buffer.GetHeight(), rgb, options.mPpmFormat);
+}
+
+/// @struct PProgressiveOptions
+/// @brief Options of progressive rendering. Progressive rendering is enabled when any option is specified.
+struct PProgressiveOptions final
+{
+  /// @brief Wall-clock budget of each camera in seconds. If 0, there is no budget.
+  float mTimeBudget = 0.0f;
+  /// @brief Target samples per pixel. If 0, samples * repeat of camera, or unlimited when budgeted.
+  TU32 mTargetSamples = 0;
+  /// @brief Interval of writing checkpoint in seconds. If 0, checkpoint is written only at the end.
+  float mCheckpointInterval = 0.0f;
+  /// @brief Resume from checkpoint of previous run, if exists.
+  bool mIsResuming = false;
+
+  bool IsEnabled() const noexcept
+  {
+    return this->mTimeBudget > 0 || this->mTargetSamples > 0 
+        || this->mCheckpointInterval > 0 || this->mIsResuming == true;
+  }
+};
+
+/// @brief Render passes of samples into frame buffer until target samples or time budget is reached.
+/// Budget is checked between passes, so the last pass may exceed budget by one pass.
+/// Checkpoint is written periodically and at the end, so killed or budgeted job can be resumed later.
+/// @param passSamples The count of samples per pixel of each pass.
+/// @param sampleStart The first sample index of each pixel. Target samples are counted from it.
+/// @param cameraSamples Samples per pixel of camera. (samples * repeat)
+/// @param renderSamples Callable that renders sample range [start, end) of each pixel into `ioBuffer`.
+/// @param outSampleEnd The end of rendered sample range of each pixel.
+/// @return If successful, return true.
+template <typename TFunc>
+bool RenderProgressive(
+  const PProgressiveOptions& options, const std::string& checkpointPath, const DUVec2& imageSize,
+  TIndex passSamples, TIndex sampleStart, TIndex cameraSamples, 
+  DFrameBuffer& ioBuffer, TFunc&& renderSamples, TIndex& outSampleEnd)
+{
+  using TClock = std::chrono::steady_clock;
+  const auto startTime = TClock::now();
+  const auto GetElapsed = [&startTime]() 
+  { 
+    return std::chrono::duration<float>(TClock::now() - startTime).count(); 
+  };
+
+  TIndex nextSample = sampleStart;
+  if (FILE* fd = options.mIsResuming == true ? std::fopen(checkpointPath.c_str(), "rb") : nullptr; 
+      fd != nullptr)
+  {
+    std::fclose(fd);
+    const auto optCheckpoint = LoadCheckpoint(checkpointPath.c_str());
+    if (optCheckpoint.has_value() == false) { return false; }
+
+    const auto& image = optCheckpoint->mImage;
+    if (image.mImageSize.X != imageSize.X || image.mImageSize.Y != imageSize.Y
+    ||  image.mSampleStart != sampleStart
+    ||  ioBuffer.Merge(image.mBuffer) == false)
+    {
+      std::cerr 
+        << "Failed to resume from `" << checkpointPath << "`. Image, region or sample range is not matched.\n";
+      return false;
+    }
+    nextSample = optCheckpoint->mNextSample;
+    std::cout 
+      << "  Resumed from " << checkpointPath << " at " << nextSample - sampleStart << " samples per pixel.\n";
+  }
+
+  // Without target, budgeted rendering continues until budget is spent.
+  const TIndex targetSamples = options.mTargetSamples != 0 
+    ? sampleStart + options.mTargetSamples 
+    : (options.mTimeBudget > 0 ? std::numeric_limits<TU32>::max() : cameraSamples);
+  passSamples = std::max<TIndex>(passSamples, 1);
+
+  float checkpointTime = 0.0f;
+  while (nextSample < targetSamples && (options.mTimeBudget <= 0 || GetElapsed() < options.mTimeBudget))
+  {
+    const auto passEnd = std::min(nextSample + passSamples, targetSamples);
+    renderSamples(nextSample, passEnd);
+    nextSample = passEnd;
+
+    if (options.mCheckpointInterval > 0 && GetElapsed() - checkpointTime >= options.mCheckpointInterval)
+    {
+      const auto isCreated = CreateCheckpoint(
+        checkpointPath.c_str(), ioBuffer, imageSize, TU32(sampleStart), TU32(nextSample));
+      if (isCreated == false) { return false; }
+      checkpointTime = GetElapsed();
+    }
+  }
+
+  std::cout << "  Progressive : " << nextSample - sampleStart << " samples per pixel.\n";
+  outSampleEnd = nextSample;
+  return CreateCheckpoint(checkpointPath.c_str(), ioBuffer, imageSize, TU32(sampleStart), TU32(nextSample));
+}
+
+} /// anonymous namespace
 
 int main(int argc, char* argv[])
 {
@@ -45,9 +195,82 @@ int main(int argc, char* argv[])
     return 0;
   }
 
+  // If "--cpu-report" is activated, print which SIMD kernels are selected before rendering.
+  if (*sArguments->GetValueFrom<bool>("cpu-report") == true)
+  {
+    PrintCpuReport();
+  }
+
   const auto numThreads = *sArguments->GetValueFrom<TU32>('t');
 	const auto inputName  = *sArguments->GetValueFrom<std::string>("file");
 	const auto isPng      = *sArguments->GetValueFrom<bool>("png"); 
+  const auto isBinning  = *sArguments->GetValueFrom<bool>("bin-rays");
+  const auto isCachingFirstHits = *sArguments->GetValueFrom<bool>("no-hit-cache") == false;
+  const auto ppmFormat  = *sArguments->GetValueFrom<bool>("ascii-ppm") ? EPpmFormat::Ascii : EPpmFormat::Binary;
+  const auto pngLevel   = *sArguments->GetValueFrom<TU32>("png-level");
+  if (pngLevel > 9)
+  {
+    std::cerr 
+      << "Could not start application. Specified png compression level is not supported. `" 
+      << pngLevel << "`\n";
+    return 1;
+  }
+  const auto pngBitDepth = *sArguments->GetValueFrom<TU32>("bit-depth");
+  if (pngBitDepth != 8 && pngBitDepth != 16)
+  {
+    std::cerr 
+      << "Could not start application. Specified png bit depth is not supported. `" 
+      << pngBitDepth << "`\n";
+    return 1;
+  }
+  const auto toneMapName = *sArguments->GetValueFrom<std::string>("tone-map");
+  EToneMapOperator toneOperator = EToneMapOperator::Clamp;
+  if (toneMapName == "reinhard")    { toneOperator = EToneMapOperator::Reinhard; }
+  else if (toneMapName == "filmic") { toneOperator = EToneMapOperator::Filmic; }
+  else if (toneMapName == "aces")   { toneOperator = EToneMapOperator::ACES; }
+  else if (toneMapName != "clamp")
+  {
+    std::cerr 
+      << "Could not start application. Specified tone map operator is not supported. `" 
+      << toneMapName << "`\n";
+    return 1;
+  }
+  const auto packetWidth = *sArguments->GetValueFrom<TU32>("packet");
+  if (packetWidth != 0 && packetWidth != 4 && packetWidth != 8)
+  {
+    std::cerr 
+      << "Could not start application. Specified packet width is not supported. `" 
+      << packetWidth << "`\n";
+    return 1;
+  }
+  const auto treeWidth = *sArguments->GetValueFrom<TU32>("bvh-width");
+  if (treeWidth != 2 && treeWidth != 4 && treeWidth != 8)
+  {
+    std::cerr 
+      << "Could not start application. Specified bvh width is not supported. `" 
+      << treeWidth << "`\n";
+    return 1;
+  }
+  const auto treeQuantizeBits = *sArguments->GetValueFrom<TU32>("bvh-quantize");
+  if (treeQuantizeBits != 0 && treeQuantizeBits != 8 && treeQuantizeBits != 16)
+  {
+    std::cerr 
+      << "Could not start application. Specified bvh quantize bits is not supported. `" 
+      << treeQuantizeBits << "`\n";
+    return 1;
+  }
+  if (treeQuantizeBits != 0 && treeWidth == 2)
+  {
+    std::cerr << "Warning : --bvh-quantize only compresses wide trees, so it is ignored when bvh-width is 2.\n";
+  }
+  const auto weldTolerance = *sArguments->GetValueFrom<float>("weld-tolerance");
+  if (weldTolerance < 0.0f)
+  {
+    std::cerr 
+      << "Could not start application. Specified weld tolerance must not be negative. `" 
+      << weldTolerance << "`\n";
+    return 1;
+  }
 
   auto outputName	= *sArguments->GetValueFrom<std::string>("output");
   std::string extension = "";
@@ -60,9 +283,9 @@ int main(int argc, char* argv[])
     outputName = (*optMatchedWords)[0];
     extension = (*optMatchedWords)[1];
 
-    // Check extension is neither `.ppm` nor `.png`.
+    // Check extension is not one of `.ppm`, `.png`, `.pfm` and `.acc`.
     if (extension.empty() == false 
-    &&  extension != "ppm" && extension != "png")
+    &&  extension != "ppm" && extension != "png" && extension != "pfm" && extension != "acc")
     {
       std::cerr 
         << "Could not start application. Specified output name's extension is not supported yet. `" 
@@ -75,6 +298,157 @@ int main(int argc, char* argv[])
     if (isPng == true) { extension = "png"; } else { extension = "ppm"; }
   }
 
+  // Streamed tiles are written into mapped raster, so only uncompressed formats can be used.
+  const auto streamTileSize = *sArguments->GetValueFrom<TU32>("stream-tiles");
+  if (streamTileSize != 0 
+  && ((extension != "ppm" && extension != "pfm") || ppmFormat == EPpmFormat::Ascii))
+  {
+    std::cerr 
+      << "Could not start application. Tile streaming supports only binary .ppm and .pfm output. `" 
+      << outputName << "." << extension << "`\n";
+    return 1;
+  }
+
+  // Crop region is `x0,y0,x1,y1` of output image, and `x1`, `y1` are exclusive.
+  const auto cropText = *sArguments->GetValueFrom<std::string>("crop");
+  const bool isCropped = cropText.empty() == false;
+  TU32 crop[4] = {0, 0, 0, 0};
+  if (isCropped == true 
+  && (std::sscanf(cropText.c_str(), "%u,%u,%u,%u", &crop[0], &crop[1], &crop[2], &crop[3]) != 4
+  ||  crop[0] >= crop[2] || crop[1] >= crop[3]))
+  {
+    std::cerr << "Could not start application. Specified crop region is not valid. `" << cropText << "`\n";
+    return 1;
+  }
+  if (isCropped == true && streamTileSize != 0)
+  {
+    std::cerr << "Could not start application. Crop region could not be used with tile streaming.\n";
+    return 1;
+  }
+
+  const auto isSamplePartitioned = *sArguments->GetValueFrom<bool>("sample-partition");
+  if (isSamplePartitioned == true && streamTileSize != 0)
+  {
+    std::cerr << "Could not start application. Sample partition could not be used with tile streaming.\n";
+    return 1;
+  }
+
+  PProgressiveOptions progressiveOptions;
+  progressiveOptions.mTimeBudget = *sArguments->GetValueFrom<float>("time-budget");
+  progressiveOptions.mTargetSamples = *sArguments->GetValueFrom<TU32>("target-spp");
+  progressiveOptions.mCheckpointInterval = *sArguments->GetValueFrom<float>("checkpoint-interval");
+  progressiveOptions.mIsResuming = *sArguments->GetValueFrom<bool>("resume");
+  if (progressiveOptions.IsEnabled() == true && streamTileSize != 0)
+  {
+    std::cerr << "Could not start application. Progressive rendering could not be used with tile streaming.\n";
+    return 1;
+  }
+
+  // Sample range is `start,count` of sample indices of each pixel. 
+  // Each sample is seeded by its index, so passes of disjoint ranges have independent samples.
+  const auto sampleRangeText = *sArguments->GetValueFrom<std::string>("sample-range");
+  const bool isSampleRanged = sampleRangeText.empty() == false;
+  TU32 sampleRange[2] = {0, 0};
+  if (isSampleRanged == true 
+  && (std::sscanf(sampleRangeText.c_str(), "%u,%u", &sampleRange[0], &sampleRange[1]) != 2
+  ||  sampleRange[1] == 0 || sampleRange[1] > std::numeric_limits<TU32>::max() - sampleRange[0]))
+  {
+    std::cerr << "Could not start application. Specified sample range is not valid. `" << sampleRangeText << "`\n";
+    return 1;
+  }
+  if (isSampleRanged == true && progressiveOptions.IsEnabled() == true) 
+  { 
+    progressiveOptions.mTargetSamples = sampleRange[1]; 
+  }
+
+  // Denoiser filters whole frame buffer, and needs first-hit features of all samples.
+  const auto isDenoising  = *sArguments->GetValueFrom<bool>("denoise");
+  const auto isAuxOutput  = *sArguments->GetValueFrom<bool>("aux-output");
+  const auto isCollectingFeatures = isDenoising == true || isAuxOutput == true;
+  if (isCollectingFeatures == true && streamTileSize != 0)
+  {
+    std::cerr << "Could not start application. Denoising and auxiliary output could not be used with tile streaming.\n";
+    return 1;
+  }
+
+  PExportOptions exportOptions;
+  exportOptions.mExtension = extension;
+  exportOptions.mPpmFormat = ppmFormat;
+  exportOptions.mPngLevel = pngLevel;
+  exportOptions.mPngBitDepth = pngBitDepth;
+  exportOptions.mThreadCount = numThreads;
+
+  PToneMapParams baseToneMapParams;
+  baseToneMapParams.mGamma = *sArguments->GetValueFrom<float>("gamma");
+  baseToneMapParams.mExposure = *sArguments->GetValueFrom<float>("exposure");
+  baseToneMapParams.mOperator = toneOperator;
+  baseToneMapParams.mTransfer = *sArguments->GetValueFrom<bool>("srgb") 
+    ? ETransferFunction::SRGB 
+    : ETransferFunction::Gamma;
+  baseToneMapParams.mIsDithering = *sArguments->GetValueFrom<bool>("dither");
+
+  // If "--merge" is specified, stitch or sum accumulation files into one image without rendering.
+  if (const auto mergeList = *sArguments->GetValueFrom<std::string>("merge"); mergeList.empty() == false)
+  {
+    DFrameBuffer mergedBuffer;
+    DUVec2 mergedSize = DUVec2{0, 0};
+    std::pair<TU32, TU32> mergedRange = {0, 0};
+    // Region (x0, y0, x1, y1) and sample range of merged files, to reject the same samples summed twice.
+    std::vector<std::pair<std::string, std::array<TU32, 6>>> mergedFiles;
+    std::stringstream stream{mergeList};
+    for (std::string path; std::getline(stream, path, ',');)
+    {
+      auto optImage = LoadImageAcc(path.c_str());
+      if (optImage.has_value() == false) { return 1; }
+
+      if (mergedBuffer.GetWidth() == 0)
+      {
+        mergedSize = optImage->mImageSize;
+        mergedBuffer = DFrameBuffer{mergedSize.X, mergedSize.Y};
+        mergedRange = {optImage->mSampleStart, optImage->mSampleEnd};
+      }
+      if (optImage->mImageSize.X != mergedSize.X || optImage->mImageSize.Y != mergedSize.Y
+      ||  mergedBuffer.MergeRegion(optImage->mBuffer) == false)
+      {
+        std::cerr << "Failed to merge `" << path << "`. Image size is not matched to previous files.\n";
+        return 1;
+      }
+
+      const auto& origin = optImage->mBuffer.GetOrigin();
+      const std::array<TU32, 6> file = {
+        origin.X, origin.Y, 
+        origin.X + TU32(optImage->mBuffer.GetWidth()), origin.Y + TU32(optImage->mBuffer.GetHeight()),
+        optImage->mSampleStart, optImage->mSampleEnd};
+      for (const auto& [mergedPath, merged] : mergedFiles)
+      {
+        const bool isRegionOverlapped = file[0] < merged[2] && merged[0] < file[2] 
+                                     && file[1] < merged[3] && merged[1] < file[3];
+        const bool isRangeOverlapped  = file[4] < merged[5] && merged[4] < file[5];
+        if (isRegionOverlapped == true && isRangeOverlapped == true)
+        {
+          std::cerr 
+            << "Failed to merge `" << path << "`. Samples [" << file[4] << ", " << file[5] 
+            << ") are overlapped with `" << mergedPath << "`. Render passes with disjoint --sample-range.\n";
+          return 1;
+        }
+      }
+      mergedFiles.emplace_back(path, file);
+      mergedRange.first  = std::min(mergedRange.first, file[4]);
+      mergedRange.second = std::max(mergedRange.second, file[5]);
+    }
+
+    // Merged file records the range that covers all merged samples.
+    const auto fullOutputName = outputName + "." + extension;
+    if (ExportImage(
+          fullOutputName, mergedBuffer, mergedSize, mergedRange, baseToneMapParams, exportOptions) == false)
+    {
+      std::printf("Failed to execute program.\n"); 
+      return 1;
+    }
+    std::cout << "* Merged into " << fullOutputName << "\n";
+    return 0;
+  }
+
   // Print Overall Information when -v mode.
 #if 0
   RAY_IF_VERBOSE_MODE() 
@@ -95,6 +469,14 @@ int main(int argc, char* argv[])
     defaults.mNumSamples  = *sArguments->GetValueFrom<TU32>('s'); 
     defaults.mGamma       = *sArguments->GetValueFrom<float>("gamma");
     defaults.mRepeat      = *sArguments->GetValueFrom<TU32>("repeat");
+    defaults.mTreeWidth   = treeWidth;
+    defaults.mTreeQuantizeBits = treeWidth != 2 ? treeQuantizeBits : 0;
+    defaults.mCreaseAngle = *sArguments->GetValueFrom<float>("crease-angle");
+    defaults.mIsUsingGeometricNormals = *sArguments->GetValueFrom<bool>("geometric-normals");
+    defaults.mIsOptimizingMeshes = *sArguments->GetValueFrom<bool>("no-mesh-optimize") == false;
+    defaults.mWeldTolerance = weldTolerance;
+    defaults.mIsUsingMeshCache = *sArguments->GetValueFrom<bool>("no-mesh-cache") == false;
+    defaults.mMeshCacheDirectory = *sArguments->GetValueFrom<std::string>("mesh-cache-dir");
 
     if (inputName.empty() == true)
     {
@@ -118,13 +500,30 @@ int main(int argc, char* argv[])
     const auto& pCamera   = pCameras[i];
     const auto imageSize  = pCamera->GetImageSize();
 
+    // Get region of output image to render. If not cropped, whole image is rendered.
+    const auto region = isCropped == true 
+      ? std::array<TU32, 4>{crop[0], crop[1], crop[2], crop[3]}
+      : std::array<TU32, 4>{0, 0, imageSize.X, imageSize.Y};
+    if (region[2] > imageSize.X || region[3] > imageSize.Y)
+    {
+      std::cerr 
+        << "Failed to execute application. Crop region is out of image of camera [" << i + 1 << "]. `" 
+        << cropText << "`\n";
+      return 1;
+    }
+    const auto regionWidth  = region[2] - region[0];
+    const auto regionHeight = region[3] - region[1];
+
     // Separate work list to each thread. (potential)
+    // Pixel index of camera is flipped from output image order, so region is flipped too.
+    // Streamed tiles create their own work lists, so full image list is not created.
+    // When samples are partitioned, all threads share one full list that is stored into the first list.
     std::vector<std::vector<DUVec2>> indexes(numThreads);
-    const auto indexCount = imageSize.X * imageSize.Y;
-    const auto workCount  = indexCount / numThreads;
-    for (auto y = imageSize.Y, t = 0u, c = 0u; y > 0; --y)
+    const auto indexCount = streamTileSize == 0 ? regionWidth * regionHeight : 0u;
+    const auto workCount  = isSamplePartitioned == true ? indexCount : indexCount / numThreads;
+    for (auto y = indexCount != 0 ? region[3] : region[1], t = 0u, c = 0u; y > region[1]; --y)
     {
-      for (auto x = 0u; x < imageSize.X; ++x)
+      for (auto x = imageSize.X - region[2]; x < imageSize.X - region[0]; ++x)
       {
         indexes[t].emplace_back(x, y);     
         // Next thread index list.
@@ -139,6 +538,7 @@ int main(int argc, char* argv[])
       std::cout << "* Thread Work List\n";
       for (TIndex tId = 0; tId < numThreads; ++tId)
       {
+        if (indexes[tId].empty() == true) { continue; }
         std::cout 
           << "  Thread [" << i << "] : " 
             << "Count : " << indexes[tId].size() << ' '
@@ -146,30 +546,6 @@ int main(int argc, char* argv[])
       }
     }
 
-    DDynamicGrid2D<DIVec3> container = {imageSize.X, imageSize.Y};
-    std::vector<std::pair<FRenderWorker, std::thread>> threads(numThreads);
-    std::cout << "* Start Rendering of [" << i + 1 << "/" << size << "] Camera." << "\n";
-
-    { // Check time...
-      EXPR_TIMER_CHECK_CPU("RenderTime");
-
-      for (TIndex tId = 0; tId < numThreads; ++tId)
-      {
-        auto& [instance, thread] = threads[tId];
-        thread = std::thread{
-          &FRenderWorker::Execute, &instance,
-          std::cref(*pCamera),
-          std::cref(indexes[tId]), imageSize, std::ref(container)};
-      }
-
-      for (auto& [instance, thread] : threads) 
-      { 
-        assert(thread.joinable() == true);
-        thread.join(); 
-      }
-    } // Release time...
-
-    // After process...
     // Make full output name using variables.
     std::string fullOutputName = outputName;
     if (pCameras.size() > 1)
@@ -178,27 +554,201 @@ int main(int argc, char* argv[])
     }
     fullOutputName += "." + extension;
 
-    // If --png (-p) is enabled, export result as `.png`, not `.ppm`.
-    if (extension == "png")
+    PToneMapParams toneMapParams = baseToneMapParams;
+    toneMapParams.mGamma = pCamera->GetGamma();
+
+    FRenderWorker::PCtor workerCtor;
+    workerCtor.mIsBinningSecondaryRays = isBinning;
+    workerCtor.mPacketWidth = packetWidth;
+    workerCtor.mIsCachingFirstHits = isCachingFirstHits;
+    workerCtor.mSampleStart = sampleRange[0];
+    workerCtor.mSampleCount = sampleRange[1];
+    std::cout << "* Start Rendering of [" << i + 1 << "/" << size << "] Camera." << "\n";
+
+    PTraversalStats stats;
+    bool isSucceeded = true;
+    if (streamTileSize != 0)
     {
-      if (const auto flag = ray::CreateImagePng(fullOutputName.c_str(), container); flag == false) 
-      { 
-        std::printf("Failed to execute program.\n"); 
-        return 1;
+      // Tiles are rendered and written into mapped file as soon as completed, 
+      // so whole frame buffer is never held in memory.
+      FMappedImage image;
+      const auto format = extension == "pfm" ? EMappedImageFormat::Pfm : EMappedImageFormat::Ppm;
+      isSucceeded = image.Open(fullOutputName.c_str(), format, imageSize.X, imageSize.Y);
+      if (isSucceeded == true)
+      {
+        FTileStreamer::PCtor streamerCtor;
+        streamerCtor.mWorker = workerCtor;
+        streamerCtor.mTileSize = streamTileSize;
+        streamerCtor.mThreadCount = numThreads;
+        FTileStreamer streamer{streamerCtor};
+        { // Check time...
+          EXPR_TIMER_CHECK_CPU("RenderTime");
+          streamer.Execute(*pCamera, image, DToneMapper{toneMapParams});
+        } // Release time...
+
+        stats = streamer.GetTraversalStats();
+        isSucceeded = image.Close();
       }
     }
-    else if (extension == "ppm")
+    else
     {
-      if (const auto flag = ray::CreateImagePpm(fullOutputName.c_str(), container); flag == false) 
+      DFrameBuffer frameBuffer = {regionWidth, regionHeight, DUVec2{region[0], region[1]}};
+      DAuxBuffers auxBuffers;
+      if (isCollectingFeatures == true) 
       { 
-        std::printf("Failed to execute program.\n"); 
-        return 1;
+        auxBuffers = DAuxBuffers{regionWidth, regionHeight, DUVec2{region[0], region[1]}}; 
       }
+      DAuxBuffers* pAuxBuffers = isCollectingFeatures == true ? &auxBuffers : nullptr;
+
+      // Render sample range [sampleStart, sampleEnd) of each pixel of region with all threads.
+      // When samples are partitioned, each thread renders whole region into its own buffer 
+      // with disjoint slice of samples, so threads never write into the same pixel.
+      // Each sample is seeded by itself, so result is the same as pixel-partitioned rendering.
+      const auto RenderSamples = [&](TIndex sampleStart, TIndex sampleEnd)
+      {
+        std::vector<std::pair<FRenderWorker, std::thread>> threads(numThreads);
+        std::vector<DFrameBuffer> sampleBuffers;
+        std::vector<DAuxBuffers> sampleAuxBuffers;
+        if (isSamplePartitioned == true)
+        {
+          sampleBuffers.assign(numThreads, DFrameBuffer{regionWidth, regionHeight, DUVec2{region[0], region[1]}});
+          if (isCollectingFeatures == true)
+          {
+            sampleAuxBuffers.assign(numThreads, DAuxBuffers{regionWidth, regionHeight, DUVec2{region[0], region[1]}});
+          }
+        }
+
+        const auto sampleCount = sampleEnd - sampleStart;
+        for (TIndex tId = 0; tId < numThreads; ++tId)
+        {
+          auto& [instance, thread] = threads[tId];
+          auto threadCtor = workerCtor;
+          if (isSamplePartitioned == false)
+          {
+            threadCtor.mSampleStart = sampleStart;
+            threadCtor.mSampleCount = sampleCount;
+            instance = FRenderWorker{threadCtor};
+            thread = std::thread{
+              &FRenderWorker::Execute, &instance,
+              std::cref(*pCamera),
+              std::cref(indexes[tId]), imageSize, std::ref(frameBuffer), pAuxBuffers};
+            continue;
+          }
+
+          // Slice is split evenly, and empty slice (more threads than samples) renders nothing.
+          threadCtor.mSampleStart = sampleStart + sampleCount * tId / numThreads;
+          threadCtor.mSampleCount = sampleStart + sampleCount * (tId + 1) / numThreads - threadCtor.mSampleStart;
+          if (threadCtor.mSampleCount == 0) { continue; }
+
+          instance = FRenderWorker{threadCtor};
+          thread = std::thread{
+            &FRenderWorker::Execute, &instance,
+            std::cref(*pCamera),
+            std::cref(indexes[0]), imageSize, std::ref(sampleBuffers[tId]),
+            isCollectingFeatures == true ? &sampleAuxBuffers[tId] : nullptr};
+        }
+
+        for (auto& [instance, thread] : threads) 
+        { 
+          if (thread.joinable() == true) { thread.join(); }
+        }
+        for (const auto& [instance, _] : threads) { stats += instance.GetTraversalStats(); }
+
+        // Reduce private buffers of threads.
+        for (const auto& sampleBuffer : sampleBuffers)
+        {
+          [[maybe_unused]] const auto isMerged = frameBuffer.Merge(sampleBuffer);
+          assert(isMerged == true);
+        }
+        for (const auto& sampleAuxBuffer : sampleAuxBuffers)
+        {
+          [[maybe_unused]] const auto isMerged = auxBuffers.Merge(sampleAuxBuffer);
+          assert(isMerged == true);
+        }
+      };
+
+      const auto offsetCount = pCamera->GetSampleOffsetCount();
+      const auto sampleTotal = offsetCount * pCamera->GetRepeat();
+      const TIndex sampleStart = sampleRange[0];
+      TIndex sampleEnd = isSampleRanged == true ? sampleStart + sampleRange[1] : sampleTotal;
+      if (progressiveOptions.IsEnabled() == false)
+      { // Check time...
+        EXPR_TIMER_CHECK_CPU("RenderTime");
+        RenderSamples(sampleStart, sampleEnd);
+      } // Release time...
+      else
+      { // Check time...
+        EXPR_TIMER_CHECK_CPU("RenderTime");
+
+        // Pass has one sample per sub-pixel offset, but at least one sample per thread when partitioned.
+        const auto passSamples = isSamplePartitioned == true ? std::max<TIndex>(offsetCount, numThreads) : offsetCount;
+        const auto checkpointPath = 
+          fullOutputName.substr(0, fullOutputName.size() - extension.size()) + "ckpt";
+        isSucceeded = RenderProgressive(
+          progressiveOptions, checkpointPath, imageSize, passSamples, sampleStart, sampleTotal, 
+          frameBuffer, RenderSamples, sampleEnd);
+      } // Release time...
+
+      // After process...
+      // Features are exported as averaged float images, so external denoisers can use them too.
+      if (isSucceeded == true && isAuxOutput == true)
+      {
+        const auto auxBaseName = fullOutputName.substr(0, fullOutputName.size() - extension.size() - 1);
+        isSucceeded = CreateImagePfm((auxBaseName + "_albedo.pfm").c_str(), auxBuffers.GetAlbedo())
+          && CreateImagePfm((auxBaseName + "_normal.pfm").c_str(), auxBuffers.GetNormal())
+          && CreateImagePfm((auxBaseName + "_depth.pfm").c_str(), auxBuffers.GetDepth());
+      }
+      if (isSucceeded == true && isDenoising == true)
+      { // Check time...
+        EXPR_TIMER_CHECK_CPU("DenoiseTime");
+        PDenoiseParams denoiseParams;
+        denoiseParams.mThreadCount = numThreads;
+        frameBuffer = Denoise(frameBuffer, auxBuffers, denoiseParams);
+      } // Release time...
+
+      // Cropped region is exported as partial image. Use `.acc` to keep its offset for merging.
+      isSucceeded = isSucceeded == true
+        && ExportImage(
+          fullOutputName, frameBuffer, imageSize, {TU32(sampleStart), TU32(sampleEnd)}, 
+          toneMapParams, exportOptions);
+    }
+    if (isSucceeded == false) 
+    { 
+      std::printf("Failed to execute program.\n"); 
+      return 1;
     }
 
     using ::dy::expr::MTimeChecker;
     const auto timestamp = EXPR_SGT(MTimeChecker).Get("RenderTime").GetRecent();
     std::cout << "  Elapsed Time : " << timestamp.count() << "s\n";
+
+    // Print traversal statistics for comparing tree layouts.
+    const auto rayCount = std::max(double(stats.mRayCount), 1.0);
+    const auto seconds  = std::max(double(timestamp.count()), 1e-6);
+    std::cout 
+      << "  Traversal : " << stats.mRayCount << " rays, " 
+      << std::fixed << std::setprecision(2)
+      << double(stats.mNodeVisitCount) / rayCount << " node visits per ray, "
+      << double(stats.mRayCount) / (seconds * 1e6) << " Mrays/s\n"
+      << std::defaultfloat;
+    if (stats.mReusedHitCount != 0)
+    {
+      std::cout << "  First-hit cache : " << stats.mReusedHitCount << " primary rays reused\n";
+    }
+
+    // Print memory of wide tree nodes, for comparing compressed node format with uncompressed one.
+    auto treeMemory = EXPR_SGT(MScene).GetWideTreeMemory();
+    treeMemory += EXPR_SGT(MModel).GetWideTreeMemory();
+    if (treeMemory.mNodeCount != 0)
+    {
+      std::cout 
+        << "  Wide tree nodes : " << treeMemory.mNodeCount << " nodes, " 
+        << std::fixed << std::setprecision(2)
+        << double(treeMemory.mByteSize) / 1024.0 << " KiB ("
+        << double(treeMemory.mUncompressedByteSize) / 1024.0 << " KiB uncompressed, ratio "
+        << double(treeMemory.mByteSize) / double(treeMemory.mUncompressedByteSize) << ")\n"
+        << std::defaultfloat;
+    }
   }
 
   EXPR_SUCCESS_ASSERT(EXPR_SGT(MModel).Release());